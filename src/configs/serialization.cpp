@@ -136,6 +136,13 @@ nlohmann::json config_to_json(const Config &config)
         add_optional(training_json, "bad_trader_threshold", config.training.bad_trader_threshold);
         add_optional(training_json, "inactive_trader_threshold", config.training.inactive_trader_threshold);
         add_optional(training_json, "decision_threshold", config.training.decision_threshold);
+        add_optional(training_json, "precompute_indicators", config.training.precompute_indicators);
+        add_optional(training_json, "lockstep_evaluation", config.training.lockstep_evaluation);
+        add_optional(training_json, "racing_slices", config.training.racing_slices);
+        add_optional(training_json, "racing_survival_rate", config.training.racing_survival_rate);
+        add_optional(training_json, "racing_extrapolation", config.training.racing_extrapolation);
+        add_optional(training_json, "migration_interval", config.training.migration_interval);
+        add_optional(training_json, "migration_size", config.training.migration_size);
 
         // Training indicator inputs
         nlohmann::json indicators_json = nlohmann::json::object();
@@ -198,8 +205,11 @@ nlohmann::json config_to_json(const Config &config)
             {"fitness_threshold", config.neat.fitness_threshold},
             {"no_fitness_termination", config.neat.no_fitness_termination},
             {"reset_on_extinction", config.neat.reset_on_extinction},
+            {"num_threads", config.neat.num_threads},
+            {"seed", config.neat.seed},
             {"activation_default", config.neat.activation_default},
             {"activation_mutate_rate", config.neat.activation_mutate_rate},
+            {"fast_activations", config.neat.fast_activations},
             {"num_inputs", config.neat.num_inputs},
             {"num_outputs", config.neat.num_outputs},
             {"num_hidden_layers", config.neat.num_hidden_layers},
@@ -487,6 +497,34 @@ Config config_from_json(const nlohmann::json &json)
     {
         config.training.decision_threshold = json["training"]["decision_threshold"];
     }
+    if (json["training"].contains("precompute_indicators"))
+    {
+        config.training.precompute_indicators = json["training"]["precompute_indicators"];
+    }
+    if (json["training"].contains("lockstep_evaluation"))
+    {
+        config.training.lockstep_evaluation = json["training"]["lockstep_evaluation"];
+    }
+    if (json["training"].contains("racing_slices"))
+    {
+        config.training.racing_slices = json["training"]["racing_slices"];
+    }
+    if (json["training"].contains("racing_survival_rate"))
+    {
+        config.training.racing_survival_rate = json["training"]["racing_survival_rate"];
+    }
+    if (json["training"].contains("racing_extrapolation"))
+    {
+        config.training.racing_extrapolation = json["training"]["racing_extrapolation"];
+    }
+    if (json["training"].contains("migration_interval"))
+    {
+        config.training.migration_interval = json["training"]["migration_interval"];
+    }
+    if (json["training"].contains("migration_size"))
+    {
+        config.training.migration_size = json["training"]["migration_size"];
+    }
 
     // Parse training inputs data
     const auto &inputs_json = json["training"]["inputs"];
@@ -592,8 +630,20 @@ Config config_from_json(const nlohmann::json &json)
     config.neat.fitness_threshold = json["neat"]["fitness_threshold"];
     config.neat.no_fitness_termination = json["neat"]["no_fitness_termination"];
     config.neat.reset_on_extinction = json["neat"]["reset_on_extinction"];
+    if (json["neat"].contains("num_threads"))
+    {
+        config.neat.num_threads = json["neat"]["num_threads"];
+    }
+    if (json["neat"].contains("seed"))
+    {
+        config.neat.seed = json["neat"]["seed"];
+    }
     config.neat.activation_default = json["neat"]["activation_default"];
     config.neat.activation_mutate_rate = json["neat"]["activation_mutate_rate"];
+    if (json["neat"].contains("fast_activations"))
+    {
+        config.neat.fast_activations = json["neat"]["fast_activations"];
+    }
     config.neat.num_inputs = json["neat"]["num_inputs"];
     config.neat.num_outputs = json["neat"]["num_outputs"];
     config.neat.num_hidden_layers = json["neat"]["num_hidden_layers"];
@@ -718,6 +768,13 @@ bool is_same_config(const Config &config1, const Config &config2)
                                    config1.training.bad_trader_threshold.value_or(0) == config2.training.bad_trader_threshold.value_or(0) &&
                                    config1.training.inactive_trader_threshold.value_or(0) == config2.training.inactive_trader_threshold.value_or(0) &&
                                    config1.training.decision_threshold.value_or(0) == config2.training.decision_threshold.value_or(0) &&
+                                   config1.training.precompute_indicators.value_or(false) == config2.training.precompute_indicators.value_or(false) &&
+                                   config1.training.lockstep_evaluation.value_or(false) == config2.training.lockstep_evaluation.value_or(false) &&
+                                   config1.training.racing_slices.value_or(1) == config2.training.racing_slices.value_or(1) &&
+                                   config1.training.racing_survival_rate.value_or(0.5) == config2.training.racing_survival_rate.value_or(0.5) &&
+                                   config1.training.racing_extrapolation.value_or(false) == config2.training.racing_extrapolation.value_or(false) &&
+                                   config1.training.migration_interval.value_or(5) == config2.training.migration_interval.value_or(5) &&
+                                   config1.training.migration_size.value_or(2) == config2.training.migration_size.value_or(2) &&
                                    config1.training.inputs.indicators.size() == config2.training.inputs.indicators.size() &&
                                    config1.training.inputs.position.size() == config2.training.inputs.position.size() &&
                                    std::equal(config1.training.inputs.position.begin(), config1.training.inputs.position.end(), config2.training.inputs.position.begin()) &&
@@ -749,8 +806,11 @@ bool is_same_config(const Config &config1, const Config &config2)
                                config1.neat.fitness_threshold == config2.neat.fitness_threshold &&
                                config1.neat.no_fitness_termination == config2.neat.no_fitness_termination &&
                                config1.neat.reset_on_extinction == config2.neat.reset_on_extinction &&
+                               config1.neat.num_threads == config2.neat.num_threads &&
+                               config1.neat.seed == config2.neat.seed &&
                                config1.neat.activation_default == config2.neat.activation_default &&
                                config1.neat.activation_mutate_rate == config2.neat.activation_mutate_rate &&
+                               config1.neat.fast_activations == config2.neat.fast_activations &&
                                config1.neat.num_inputs == config2.neat.num_inputs &&
                                config1.neat.num_outputs == config2.neat.num_outputs &&
                                config1.neat.num_hidden_layers == config2.neat.num_hidden_layers &&
@@ -1,6 +1,7 @@
 #include <cmath>
 #include <algorithm>
 #include <vector>
+#include <iostream>
 #include "activation_functions.hpp"
 
 /**
@@ -112,3 +113,199 @@ double neat::swish(double x)
     double beta = 1.0;
     return x / (1.0 + exp(-beta * x));
 }
+
+/**
+ * @brief Implements a fast approximation of the hyperbolic tangent, with a rational function.
+ * @param x Input value.
+ * @return The approximated hyperbolic tangent of the input value, within 1e-5 of the exact one.
+ */
+double neat::fast_tanh(double x)
+{
+    // Continued fraction of Lambert, the approximation reaches 1 at 6.29
+    // The order 9/8 keeps the error of the swish under 1e-4, the error of the sigmoid being multiplied by the input
+    x = std::min(6.29, std::max(-6.29, x));
+    double x2 = x * x;
+    double y = x * (34459425.0 + x2 * (4729725.0 + x2 * (135135.0 + x2 * (990.0 + x2)))) / (34459425.0 + x2 * (16216200.0 + x2 * (945945.0 + x2 * (13860.0 + 45.0 * x2))));
+    return std::min(1.0, std::max(-1.0, y));
+}
+
+/**
+ * @brief Implements a fast approximation of the sigmoid activation function, from the one of the hyperbolic tangent.
+ * @param x Input value.
+ * @return The approximated sigmoid of the input value, within 1e-5 of the exact one.
+ */
+double neat::fast_sigmoid(double x)
+{
+    return 0.5 + 0.5 * fast_tanh(0.5 * x);
+}
+
+/**
+ * @brief Implements a fast approximation of the swish activation function, from the one of the sigmoid.
+ * @param x Input value.
+ * @return The approximated swish of the input value, within 1e-4 of the exact one.
+ */
+double neat::fast_swish(double x)
+{
+    return x * fast_sigmoid(x);
+}
+
+// Names of the activation functions, in the order of their codes
+static const neat::ActivationFunction activation_functions_names[neat::NB_ACTIVATION_FUNCTIONS] = {
+    "step",
+    "sigmoid",
+    "tanh",
+    "relu",
+    "leaky_relu",
+    "prelu",
+    "elu",
+    "softmax",
+    "linear",
+    "swish",
+};
+
+// Activation functions, in the order of their codes
+static const neat::ActivationFunctionPointer activation_functions[neat::NB_ACTIVATION_FUNCTIONS] = {
+    neat::step,
+    neat::sigmoid,
+    neat::tanh,
+    neat::relu,
+    neat::leaky_relu,
+    neat::prelu,
+    neat::elu,
+    neat::softmax,
+    neat::linear,
+    neat::swish,
+};
+
+// Activation functions with the fast approximations, in the order of their codes
+static const neat::ActivationFunctionPointer fast_activation_functions[neat::NB_ACTIVATION_FUNCTIONS] = {
+    neat::step,
+    neat::fast_sigmoid,
+    neat::fast_tanh,
+    neat::relu,
+    neat::leaky_relu,
+    neat::prelu,
+    neat::elu,
+    neat::softmax,
+    neat::linear,
+    neat::fast_swish,
+};
+
+/**
+ * @brief Get the enum code of an activation function.
+ * @param function Name of the activation function.
+ * @return Code of the activation function, sigmoid if the name is unknown.
+ */
+neat::ActivationFunctionType neat::get_activation_function_type(const ActivationFunction &function)
+{
+    for (int i = 0; i < NB_ACTIVATION_FUNCTIONS; ++i)
+    {
+        if (activation_functions_names[i] == function)
+        {
+            return static_cast<ActivationFunctionType>(i);
+        }
+    }
+
+    std::cerr << "Unknown activation function: " << function << std::endl;
+    return ActivationFunctionType::SIGMOID;
+}
+
+/**
+ * @brief Get the name of an activation function.
+ * @param type Code of the activation function.
+ * @return Name of the activation function.
+ */
+neat::ActivationFunction neat::get_activation_function_name(ActivationFunctionType type)
+{
+    return activation_functions_names[static_cast<int>(type)];
+}
+
+/**
+ * @brief Get the function of an activation function.
+ * @param type Code of the activation function.
+ * @param fast Flag to get the fast approximation of the sigmoid, tanh and swish functions.
+ * @return Pointer to the function.
+ */
+neat::ActivationFunctionPointer neat::get_activation_function(ActivationFunctionType type, bool fast)
+{
+    return fast ? fast_activation_functions[static_cast<int>(type)] : activation_functions[static_cast<int>(type)];
+}
+
+/**
+ * @brief Apply an activation function given by its enum code.
+ * @param type Code of the activation function.
+ * @param x Input value.
+ * @param fast Flag to use the fast approximation of the sigmoid, tanh and swish functions.
+ * @return The output value of the activation function.
+ */
+double neat::activate(ActivationFunctionType type, double x, bool fast)
+{
+    return get_activation_function(type, fast)(x);
+}
+
+/**
+ * @brief Apply a function to each value of a span, the function is inlined in the loop.
+ * @param function The function.
+ * @param inputs Input values.
+ * @param outputs Output values.
+ * @param count Number of values.
+ */
+template <typename Function>
+static void apply(Function function, const double *inputs, double *outputs, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        outputs[i] = function(inputs[i]);
+    }
+}
+
+/**
+ * @brief Apply an activation function to a contiguous span of values.
+ * @param type Code of the activation function.
+ * @param inputs Input values.
+ * @param outputs Output values, the same values as the ones of the scalar function. They can be the input values.
+ * @param count Number of values.
+ * @param fast Flag to use the fast approximation of the sigmoid, tanh and swish functions.
+ */
+void neat::activate(ActivationFunctionType type, const double *inputs, double *outputs, size_t count, bool fast)
+{
+    switch (type)
+    {
+    case ActivationFunctionType::STEP:
+        return apply([](double x)
+                     { return step(x); }, inputs, outputs, count);
+    case ActivationFunctionType::SIGMOID:
+        return fast ? apply([](double x)
+                            { return fast_sigmoid(x); }, inputs, outputs, count)
+                    : apply([](double x)
+                            { return sigmoid(x); }, inputs, outputs, count);
+    case ActivationFunctionType::TANH:
+        return fast ? apply([](double x)
+                            { return fast_tanh(x); }, inputs, outputs, count)
+                    : apply([](double x)
+                            { return tanh(x); }, inputs, outputs, count);
+    case ActivationFunctionType::RELU:
+        return apply([](double x)
+                     { return relu(x); }, inputs, outputs, count);
+    case ActivationFunctionType::LEAKY_RELU:
+        return apply([](double x)
+                     { return leaky_relu(x); }, inputs, outputs, count);
+    case ActivationFunctionType::PRELU:
+        return apply([](double x)
+                     { return prelu(x); }, inputs, outputs, count);
+    case ActivationFunctionType::ELU:
+        return apply([](double x)
+                     { return elu(x); }, inputs, outputs, count);
+    case ActivationFunctionType::SOFTMAX:
+        return apply([](double x)
+                     { return softmax(x); }, inputs, outputs, count);
+    case ActivationFunctionType::LINEAR:
+        return apply([](double x)
+                     { return linear(x); }, inputs, outputs, count);
+    case ActivationFunctionType::SWISH:
+        return fast ? apply([](double x)
+                            { return fast_swish(x); }, inputs, outputs, count)
+                    : apply([](double x)
+                            { return swish(x); }, inputs, outputs, count);
+    }
+}
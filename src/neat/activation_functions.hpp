@@ -1,13 +1,17 @@
 #ifndef NEAT_ACTIVATION_FUNCTIONS_HPP
 #define NEAT_ACTIVATION_FUNCTIONS_HPP
 
+#include <cstddef>
 #include <string>
 
 namespace neat
 {
-    // Type alias for activation function
+    // Type alias for the names of the activation functions, used in the configuration and the JSON files
     using ActivationFunction = std::string;
 
+    // Type alias for the function pointer
+    using ActivationFunctionPointer = double (*)(double);
+
     double step(double x);
     double sigmoid(double x);
     double tanh(double x);
@@ -18,6 +22,74 @@ namespace neat
     double softmax(double x);
     double linear(double x);
     double swish(double x);
+
+    double fast_sigmoid(double x);
+    double fast_tanh(double x);
+    double fast_swish(double x);
+
+    /**
+     * @brief Activation functions coded as an enum, to avoid the comparisons of their names at each activation.
+     */
+    enum class ActivationFunctionType
+    {
+        STEP,
+        SIGMOID,
+        TANH,
+        RELU,
+        LEAKY_RELU,
+        PRELU,
+        ELU,
+        SOFTMAX,
+        LINEAR,
+        SWISH
+    };
+
+    /**
+     * @brief Number of activation functions.
+     */
+    constexpr int NB_ACTIVATION_FUNCTIONS = 10;
+
+    /**
+     * @brief Get the enum code of an activation function.
+     * @param function Name of the activation function.
+     * @return Code of the activation function, sigmoid if the name is unknown.
+     */
+    ActivationFunctionType get_activation_function_type(const ActivationFunction &function);
+
+    /**
+     * @brief Get the name of an activation function.
+     * @param type Code of the activation function.
+     * @return Name of the activation function.
+     */
+    ActivationFunction get_activation_function_name(ActivationFunctionType type);
+
+    /**
+     * @brief Get the function of an activation function.
+     * @param type Code of the activation function.
+     * @param fast Flag to get the fast approximation of the sigmoid, tanh and swish functions. Default is false.
+     * @return Pointer to the function.
+     */
+    ActivationFunctionPointer get_activation_function(ActivationFunctionType type, bool fast = false);
+
+    /**
+     * @brief Apply an activation function given by its enum code.
+     * @param type Code of the activation function.
+     * @param x Input value.
+     * @param fast Flag to use the fast approximation of the sigmoid, tanh and swish functions. Default is false.
+     * @return The output value of the activation function.
+     */
+    double activate(ActivationFunctionType type, double x, bool fast = false);
+
+    /**
+     * @brief Apply an activation function to a contiguous span of values.
+     * The function is inlined in the loop over the values, so the compiler can vectorize it, except the exponentials of the exact functions.
+     * @param type Code of the activation function.
+     * @param inputs Input values.
+     * @param outputs Output values, the same values as the ones of the scalar function. They can be the input values.
+     * @param count Number of values.
+     * @param fast Flag to use the fast approximation of the sigmoid, tanh and swish functions. Default is false.
+     */
+    void activate(ActivationFunctionType type, const double *inputs, double *outputs, size_t count, bool fast = false);
 }
 
 #endif
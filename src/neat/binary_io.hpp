@@ -0,0 +1,70 @@
+#ifndef NEAT_BINARY_IO_HPP
+#define NEAT_BINARY_IO_HPP
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace neat
+{
+    /**
+     * @brief Write a value to a binary stream, as its raw bytes.
+     * @param stream The output stream.
+     * @param value The value to write.
+     */
+    template <typename T>
+    inline void write_binary(std::ostream &stream, const T &value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be written as raw bytes.");
+        stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    /**
+     * @brief Write a string to a binary stream, prefixed by its size.
+     * @param stream The output stream.
+     * @param value The string to write.
+     */
+    inline void write_binary(std::ostream &stream, const std::string &value)
+    {
+        write_binary(stream, static_cast<uint32_t>(value.size()));
+        stream.write(value.data(), value.size());
+    }
+
+    /**
+     * @brief Read a value written by write_binary from a binary stream.
+     * @param stream The input stream.
+     * @param value The value to read.
+     * @throws std::runtime_error If the end of the stream is reached.
+     */
+    template <typename T>
+    inline void read_binary(std::istream &stream, T &value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be read as raw bytes.");
+        if (!stream.read(reinterpret_cast<char *>(&value), sizeof(T)))
+        {
+            throw std::runtime_error("Unexpected end of the binary stream");
+        }
+    }
+
+    /**
+     * @brief Read a string written by write_binary from a binary stream.
+     * @param stream The input stream.
+     * @param value The string to read.
+     * @throws std::runtime_error If the end of the stream is reached.
+     */
+    inline void read_binary(std::istream &stream, std::string &value)
+    {
+        uint32_t size;
+        read_binary(stream, size);
+        value.resize(size);
+        if (!stream.read(value.data(), size))
+        {
+            throw std::runtime_error("Unexpected end of the binary stream");
+        }
+    }
+}
+
+#endif // NEAT_BINARY_IO_HPP
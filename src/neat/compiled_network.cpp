@@ -0,0 +1,137 @@
+#include <vector>
+#include <algorithm>
+#include "node.hpp"
+#include "connection_gene.hpp"
+#include "genome.hpp"
+#include "compiled_network.hpp"
+
+neat::CompiledNetwork::CompiledNetwork(const Genome &genome) : inputs(genome.inputs), fast_activations(genome.config.fast_activations)
+{
+    const std::vector<int> &network = genome.network;
+
+    // Group the nodes of each layer by activation function to get their slots, the input layer is not activated
+    std::vector<int> slots(genome.nodes.size(), -1);
+    std::vector<int> layer_nodes;
+    int nb_slots = 0;
+    this->layers_steps.push_back(0);
+    this->layers_spans.push_back(0);
+    for (size_t begin = 0; begin < network.size();)
+    {
+        int layer = genome.nodes[network[begin]].layer;
+        size_t end = begin;
+        while (end < network.size() && genome.nodes[network[end]].layer == layer)
+        {
+            ++end;
+        }
+
+        layer_nodes.assign(network.begin() + begin, network.begin() + end);
+        if (layer != 0)
+        {
+            std::stable_sort(layer_nodes.begin(), layer_nodes.end(), [&](int a, int b)
+                             { return genome.nodes[a].activation_function < genome.nodes[b].activation_function; });
+        }
+        for (int n : layer_nodes)
+        {
+            ActivationFunctionType activation = genome.nodes[n].activation_function;
+            if (layer != 0)
+            {
+                if (this->spans.size() == this->layers_spans.back() || this->spans.back().activation != activation)
+                {
+                    this->spans.push_back({activation, nb_slots, nb_slots});
+                }
+                this->spans.back().end++;
+            }
+            slots[n] = nb_slots++;
+        }
+
+        this->layers_steps.push_back(end);
+        this->layers_spans.push_back(this->spans.size());
+        begin = end;
+    }
+
+    // The nodes out of the network keep their own slots
+    for (size_t n = 0; n < genome.nodes.size(); ++n)
+    {
+        if (slots[n] < 0)
+        {
+            slots[n] = nb_slots++;
+        }
+    }
+
+    // The steps keep the order of the network, so the sums are added in the same order as the nodes of the genome
+    this->connections_offsets.push_back(0);
+    for (int n : network)
+    {
+        this->steps.push_back(slots[n]);
+        for (int c : genome.nodes[n].output_connections)
+        {
+            const ConnectionGene &connection = genome.genes[c];
+            if (connection.enabled)
+            {
+                this->connections_targets.push_back(slots[connection.to_node]);
+                this->connections_weights.push_back(connection.weight);
+            }
+        }
+        this->connections_offsets.push_back(this->connections_targets.size());
+    }
+
+    // The inputs are nodes[0] to nodes[inputs-1] and the outputs are nodes[inputs] to nodes[inputs+outputs-1]
+    for (int i = 0; i < genome.inputs; ++i)
+    {
+        this->inputs_slots.push_back(slots[i]);
+    }
+    for (int i = 0; i < genome.outputs; ++i)
+    {
+        this->outputs_slots.push_back(slots[this->inputs + i]);
+    }
+
+    this->values.resize(nb_slots);
+    this->sums.assign(nb_slots, 0.0);
+    for (size_t n = 0; n < genome.nodes.size(); ++n)
+    {
+        this->values[slots[n]] = genome.nodes[n].output_value;
+    }
+    this->outputs.assign(genome.outputs, 0.0);
+}
+
+const std::vector<double> &neat::CompiledNetwork::feed_forward(const double *input_values)
+{
+    double *values = this->values.data();
+    double *sums = this->sums.data();
+
+    // Set the outputs of the input nodes
+    for (int i = 0; i < this->inputs; ++i)
+    {
+        values[this->inputs_slots[i]] = input_values[i];
+    }
+
+    for (size_t l = 0; l + 1 < this->layers_steps.size(); ++l)
+    {
+        // Activate the nodes of the layer, their sums are complete
+        for (size_t a = this->layers_spans[l]; a < this->layers_spans[l + 1]; ++a)
+        {
+            const ActivationSpan &span = this->spans[a];
+            activate(span.activation, sums + span.begin, values + span.begin, span.end - span.begin, this->fast_activations);
+        }
+
+        // Propagate the values of the nodes of the layer
+        for (size_t s = this->layers_steps[l]; s < this->layers_steps[l + 1]; ++s)
+        {
+            double value = values[this->steps[s]];
+            for (size_t c = this->connections_offsets[s]; c < this->connections_offsets[s + 1]; ++c)
+            {
+                sums[this->connections_targets[c]] += this->connections_weights[c] * value;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < this->outputs_slots.size(); ++i)
+    {
+        this->outputs[i] = values[this->outputs_slots[i]];
+    }
+
+    // Reset all the nodes for the next feed forward
+    std::fill(this->sums.begin(), this->sums.end(), 0.0);
+
+    return this->outputs;
+}
@@ -0,0 +1,65 @@
+#ifndef NEAT_COMPILED_NETWORK_HPP
+#define NEAT_COMPILED_NETWORK_HPP
+
+#include <vector>
+#include <cstddef>
+#include "activation_functions.hpp"
+
+namespace neat
+{
+    class Genome; // Forward declaration
+
+    /**
+     * @brief Flat representation of the network of a genome for inference.
+     *
+     * The nodes are stored in the order the genome engages them, with their enabled output connections
+     * in compressed sparse row arrays, so a feed forward only walks contiguous arrays and allocates nothing.
+     * The slots of the nodes of a layer are grouped by activation function, so each layer is activated
+     * by a few calls of the batch activation on contiguous spans before its nodes propagate their values.
+     * The connections only go to the upper layers, so the outputs are the same as the ones of the nodes of
+     * the genome, bit for bit.
+     */
+    class CompiledNetwork
+    {
+    public:
+        /**
+         * @brief Contiguous slots of the nodes of a layer with the same activation function.
+         */
+        struct ActivationSpan
+        {
+            ActivationFunctionType activation; // Activation function of the nodes.
+            int begin;                         // First slot of the nodes.
+            int end;                           // End of the slots of the nodes.
+        };
+
+        int inputs;                              // Number of input values.
+        bool fast_activations;                   // Whether the fast approximations of the activation functions are used.
+        std::vector<int> steps;                  // Slot of each node of the network, in the order they are engaged.
+        std::vector<size_t> layers_steps;        // Offset of the steps of each layer (number of layers + 1 values).
+        std::vector<ActivationSpan> spans;       // Spans of the slots activated in each layer, the input layer has none.
+        std::vector<size_t> layers_spans;        // Offset of the spans of each layer (number of layers + 1 values).
+        std::vector<size_t> connections_offsets; // Offset of the output connections of each step (number of steps + 1 values).
+        std::vector<int> connections_targets;    // Slot of the target node of each connection.
+        std::vector<double> connections_weights; // Weight of each connection.
+        std::vector<int> inputs_slots;           // Slot of each input node.
+        std::vector<int> outputs_slots;          // Slot of each output node.
+        std::vector<double> values;              // Output value of the node of each slot.
+        std::vector<double> sums;                // Input sum of the node of each slot.
+        std::vector<double> outputs;             // Output values of the last feed forward.
+
+        /**
+         * @brief Compile the network of a genome.
+         * @param genome The genome whose network, connections and activation functions are compiled.
+         */
+        CompiledNetwork(const Genome &genome);
+
+        /**
+         * @brief Performs a feed-forward operation on the compiled network.
+         * @param input_values Input values, as many as the input nodes.
+         * @return Output values, valid until the next feed forward.
+         */
+        const std::vector<double> &feed_forward(const double *input_values);
+    };
+}
+
+#endif
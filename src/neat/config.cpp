@@ -48,6 +48,14 @@ neat::Config neat::load_config(const std::string &filename)
             {
                 config.reset_on_extinction = (value == "true");
             }
+            else if (key == "num_threads")
+            {
+                config.num_threads = std::stoi(value);
+            }
+            else if (key == "seed")
+            {
+                config.seed = std::stoull(value);
+            }
             else if (key == "activation_default")
             {
                 config.activation_default = value;
@@ -56,6 +64,10 @@ neat::Config neat::load_config(const std::string &filename)
             {
                 config.activation_mutate_rate = std::stod(value);
             }
+            else if (key == "fast_activations")
+            {
+                config.fast_activations = (value == "true");
+            }
             else if (key == "num_inputs")
             {
                 config.num_inputs = std::stoi(value);
@@ -1,6 +1,7 @@
 #ifndef NEAT_CONFIG_HPP
 #define NEAT_CONFIG_HPP
 
+#include <cstdint>
 #include <string>
 #include "activation_functions.hpp"
 
@@ -26,10 +27,16 @@ namespace neat
         bool no_fitness_termination;
         // If this evaluates to True, when all species simultaneously become extinct due to stagnation, a new random population will be created.
         bool reset_on_extinction;
+        // The number of threads evaluating the genomes, and running the other parallel work of the training. 0 to use one thread per hardware thread.
+        int num_threads = 0;
+        // The master seed of the random generators, the runs with the same seed and the same number of threads are identical. 0 to seed them randomly.
+        uint64_t seed = 0;
 
         // ======== GENOME =========== //
         ActivationFunction activation_default;
         double activation_mutate_rate;
+        // Use fast approximations of the sigmoid, tanh and swish activation functions, within 1e-4 of the exact ones.
+        bool fast_activations = false;
         int num_inputs;
         int num_outputs;
         int num_hidden_layers;
@@ -1,16 +1,9 @@
 #include <iostream>
 #include "math_utils.hpp"
 #include "config.hpp"
-#include "node.hpp"
 #include "connection_gene.hpp"
 
-neat::ConnectionGene::ConnectionGene(std::shared_ptr<Node> from, std::shared_ptr<Node> to, double w, int innovation, bool enabled) : from_node(from), to_node(to), weight(w), innovation_nb(innovation), enabled(enabled) {}
-
-neat::ConnectionGene::~ConnectionGene()
-{
-    this->from_node.reset();
-    this->to_node.reset();
-}
+neat::ConnectionGene::ConnectionGene(int from, int to, double w, int innovation, bool enabled) : from_node(from), to_node(to), weight(w), innovation_nb(innovation), enabled(enabled) {}
 
 void neat::ConnectionGene::mutate(const neat::Config &config)
 {
@@ -33,12 +26,7 @@ void neat::ConnectionGene::mutate(const neat::Config &config)
     }
 }
 
-bool neat::ConnectionGene::is_equal(std::shared_ptr<ConnectionGene> other)
-{
-    return this->from_node->id == other->from_node->id && this->to_node->id == other->to_node->id && this->weight == other->weight && this->innovation_nb == other->innovation_nb && this->enabled == other->enabled;
-}
-
-std::shared_ptr<neat::ConnectionGene> neat::ConnectionGene::clone(std::shared_ptr<Node> from, std::shared_ptr<Node> to)
+bool neat::ConnectionGene::is_equal(const ConnectionGene &other) const
 {
-    return std::make_shared<ConnectionGene>(from, to, this->weight, this->innovation_nb, this->enabled);
+    return this->from_node == other.from_node && this->to_node == other.to_node && this->weight == other.weight && this->innovation_nb == other.innovation_nb && this->enabled == other.enabled;
 }
@@ -2,39 +2,31 @@
 #define NEAT_CONNECTION_GENE_HPP
 
 #include <vector>
-#include "node.hpp"
 #include "config.hpp"
 
 namespace neat
 {
-    class Node; // Forward declaration
-
     /**
      * @brief Represents a connection gene in the NEAT (NeuroEvolution of Augmenting Topologies) algorithm.
      */
     class ConnectionGene
     {
     public:
-        std::shared_ptr<Node> from_node; // Pointer to the source node.
-        std::shared_ptr<Node> to_node;   // Pointer to the target node.
-        double weight;                   // Weight of the connection.
-        int innovation_nb;               // Innovation number of the connection.
-        bool enabled;                    // Flag indicating whether the connection is enabled or disabled.
+        int from_node;     // Index of the source node in the nodes of the genome.
+        int to_node;       // Index of the target node in the nodes of the genome.
+        double weight;     // Weight of the connection.
+        int innovation_nb; // Innovation number of the connection.
+        bool enabled;      // Flag indicating whether the connection is enabled or disabled.
 
         /**
          * @brief Constructor for ConnectionGene.
-         * @param from Pointer to the source node.
-         * @param to Pointer to the target node.
+         * @param from Index of the source node in the nodes of the genome.
+         * @param to Index of the target node in the nodes of the genome.
          * @param w Weight of the connection.
          * @param innovation Innovation number of the connection.
          * @param enabled Flag indicating whether the connection is enabled or disabled.
          */
-        ConnectionGene(std::shared_ptr<Node> from, std::shared_ptr<Node> to, double w, int innovation, bool enabled);
-
-        /**
-         * @brief Destructor for ConnectionGene.
-         */
-        ~ConnectionGene();
+        ConnectionGene(int from, int to, double w, int innovation, bool enabled);
 
         /**
          * @brief Mutates the connection gene based on the NEAT configuration.
@@ -47,15 +39,7 @@ namespace neat
          * @param other The genes to compare with it.
          * @return True if the genes are the same and connection genes, otherwise false.
          */
-        bool is_equal(std::shared_ptr<ConnectionGene> other);
-
-        /**
-         * @brief Creates a clone of the connection gene with specified source and target nodes.
-         * @param from Pointer to the new source node.
-         * @param to Pointer to the new target node.
-         * @return Pointer to the cloned ConnectionGene.
-         */
-        std::shared_ptr<ConnectionGene> clone(std::shared_ptr<Node> from, std::shared_ptr<Node> to);
+        bool is_equal(const ConnectionGene &other) const;
     };
 
 }
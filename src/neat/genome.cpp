@@ -6,19 +6,20 @@
 #include <algorithm>
 #include <fstream>
 #include <filesystem>
+#include <cstdint>
 #include "json.hpp"
+#include "binary_io.hpp"
 #include "math_utils.hpp"
 #include "config.hpp"
 #include "node.hpp"
 #include "connection_gene.hpp"
-#include "connection_history.hpp"
+#include "innovation_history.hpp"
 #include "genome.hpp"
 
 std::string generate_genome_uid(int size)
 {
     const std::string characters = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
-    thread_local std::random_device rd;
-    thread_local std::mt19937 gen(rd());
+    RandomGenerator &generator = neat::get_random_generator();
     std::uniform_int_distribution<> dis(0, characters.size() - 1);
 
     std::string uid;
@@ -26,13 +27,12 @@ std::string generate_genome_uid(int size)
 
     for (int i = 0; i < size; ++i)
     {
-        uid += characters[dis(gen)];
+        uid += characters[dis(generator)];
     }
 
     return uid;
 }
 
-int next_innovation_nb = 1;
 
 neat::Genome::Genome(){};
 
@@ -46,6 +46,7 @@ neat::Genome::Genome(const Config &config, bool crossover) : config(config), inp
         return;
     }
 
+    ActivationFunctionType activation_default = get_activation_function_type(this->config.activation_default);
     for (int l = 0; l < this->layers; ++l)
     {
         // inputs and hidden layers
@@ -53,7 +54,7 @@ neat::Genome::Genome(const Config &config, bool crossover) : config(config), inp
         {
             for (int i = 0; i < inputs; ++i)
             {
-                this->nodes.push_back(std::make_shared<Node>(l * this->inputs + i, this->config.activation_default, l));
+                this->nodes.emplace_back(l * this->inputs + i, activation_default, l);
                 ++this->next_node;
             }
         }
@@ -62,34 +63,16 @@ neat::Genome::Genome(const Config &config, bool crossover) : config(config), inp
         {
             for (int i = 0; i < this->outputs; ++i)
             {
-                this->nodes.push_back(std::make_shared<Node>(l * this->inputs + i, this->config.activation_default, l));
+                this->nodes.emplace_back(l * this->inputs + i, activation_default, l);
                 ++this->next_node;
             }
         }
     }
 }
 
-neat::Genome::~Genome()
-{
-    // Delete all the dynamically allocated nodes
-    for (auto n : this->nodes)
-    {
-        n.reset();
-    }
-
-    // Delete all the dynamically allocated connection genes
-    for (auto g : this->genes)
-    {
-        g.reset();
-    }
-
-    // Clear the nodes and genes vectors
-    this->nodes.clear();
-    this->genes.clear();
-    this->network.clear();
-}
+neat::Genome::~Genome() {}
 
-void neat::Genome::fully_connect(std::vector<std::shared_ptr<ConnectionHistory>> innovation_history)
+void neat::Genome::fully_connect(InnovationHistory &innovation_history)
 {
     int nb_layers = 2 + this->config.num_hidden_layers;
     for (int l = 0; l < nb_layers; ++l)
@@ -109,16 +92,15 @@ void neat::Genome::fully_connect(std::vector<std::shared_ptr<ConnectionHistory>>
                 {
                     int connection_innovation_nb = this->get_innovation_number(
                         innovation_history,
-                        this->nodes[current_layer * this->inputs + i],
-                        this->nodes[next_layer * this->outputs + j]);
-
-                    genes.push_back(
-                        std::make_shared<ConnectionGene>(
-                            this->nodes[current_layer * this->inputs + i],
-                            this->nodes[next_layer * this->inputs + j],
-                            new_connection_weight(),
-                            connection_innovation_nb,
-                            this->config.enabled_default));
+                        current_layer * this->inputs + i,
+                        next_layer * this->outputs + j);
+
+                    this->add_gene(ConnectionGene(
+                        current_layer * this->inputs + i,
+                        next_layer * this->inputs + j,
+                        new_connection_weight(),
+                        connection_innovation_nb,
+                        this->config.enabled_default));
                 }
             }
         }
@@ -130,16 +112,15 @@ void neat::Genome::fully_connect(std::vector<std::shared_ptr<ConnectionHistory>>
                 {
                     int connection_innovation_nb = get_innovation_number(
                         innovation_history,
-                        this->nodes[current_layer * this->inputs + i],
-                        this->nodes[next_layer * this->inputs + j]);
-
-                    this->genes.push_back(
-                        std::make_shared<ConnectionGene>(
-                            this->nodes[current_layer * this->inputs + i],
-                            this->nodes[next_layer * this->inputs + j],
-                            new_connection_weight(),
-                            connection_innovation_nb,
-                            this->config.enabled_default));
+                        current_layer * this->inputs + i,
+                        next_layer * this->inputs + j);
+
+                    this->add_gene(ConnectionGene(
+                        current_layer * this->inputs + i,
+                        next_layer * this->inputs + j,
+                        new_connection_weight(),
+                        connection_innovation_nb,
+                        this->config.enabled_default));
                 }
             }
         }
@@ -148,32 +129,53 @@ void neat::Genome::fully_connect(std::vector<std::shared_ptr<ConnectionHistory>>
     connect_nodes();
 }
 
-std::shared_ptr<neat::Node> neat::Genome::get_node(int id)
+int neat::Genome::get_node(int id) const
 {
-    for (auto &n : this->nodes)
+    for (size_t i = 0; i < this->nodes.size(); ++i)
     {
-        if (n->id == id)
-            return n;
+        if (this->nodes[i].id == id)
+            return i;
     }
-    return nullptr;
+    return -1;
+}
+
+void neat::Genome::add_gene(const ConnectionGene &gene)
+{
+    auto it = std::upper_bound(this->genes.begin(), this->genes.end(), gene.innovation_nb, [](int innovation_nb, const ConnectionGene &g)
+                               { return innovation_nb < g.innovation_nb; });
+    this->genes.insert(it, gene);
 }
 
 void neat::Genome::connect_nodes()
 {
+    this->compiled_network.reset();
+
     // Clear the connections for each node
     for (auto &n : this->nodes)
     {
-        n->output_connections.clear();
+        n.output_connections.clear();
     }
 
     // Add the connections to the nodes
-    for (auto &g : this->genes)
+    for (size_t i = 0; i < this->genes.size(); ++i)
     {
-        g->from_node->output_connections.push_back(g);
+        this->nodes[this->genes[i].from_node].output_connections.push_back(i);
     }
 }
 
-std::vector<double> neat::Genome::feed_forward(std::vector<double> input_values)
+bool neat::Genome::is_connected(int node1, int node2) const
+{
+    for (const auto &g : this->genes)
+    {
+        if ((g.from_node == node1 && g.to_node == node2) || (g.from_node == node2 && g.to_node == node1))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::vector<double> &neat::Genome::feed_forward(const std::vector<double> &input_values)
 {
     try
     {
@@ -183,41 +185,26 @@ std::vector<double> neat::Genome::feed_forward(std::vector<double> input_values)
                                         std::to_string(this->inputs) + " != " + std::to_string(input_values.size()));
         }
 
-        // Set the outputs of the input nodes
-        for (int i = 0; i < this->inputs; ++i)
-        {
-            this->nodes[i]->output_value = input_values[i];
-        }
-
-        // Engage each node in the network
-        for (auto &n : this->network)
-        {
-            n->activate();
-            n->propagate_output();
-        }
-
-        // The outputs are nodes[inputs] to nodes[inputs+outputs-1]
-        std::vector<double> outs(this->outputs, 0.0);
-        for (int i = 0; i < this->outputs; ++i)
-        {
-            outs[i] = this->nodes[this->inputs + i]->output_value;
-        }
-
-        // Reset all the nodes for the next feed forward
-        for (auto &n : this->nodes)
+        if (!this->compiled_network)
         {
-            n->input_sum = 0;
+            this->compile();
         }
 
-        return outs;
+        return this->compiled_network->feed_forward(input_values.data());
     }
     catch (const std::exception &e)
     {
+        static const std::vector<double> no_outputs = {};
         std::cerr << "An error occurred during feed forward: " << e.what() << std::endl;
-        return std::vector<double>{};
+        return no_outputs;
     }
 }
 
+void neat::Genome::compile()
+{
+    this->compiled_network = std::make_unique<CompiledNetwork>(*this);
+}
+
 void neat::Genome::generate_network()
 {
     this->connect_nodes();
@@ -226,18 +213,20 @@ void neat::Genome::generate_network()
     // For each layer, add the nodes in that layer to the network
     for (int l = 0; l < this->layers; ++l)
     {
-        for (auto &n : this->nodes)
+        for (size_t i = 0; i < this->nodes.size(); ++i)
         {
-            if (n->layer == l)
+            if (this->nodes[i].layer == l)
             {
-                this->network.push_back(n);
+                this->network.push_back(i);
             }
         }
     }
 }
 
-void neat::Genome::add_node(std::vector<std::shared_ptr<ConnectionHistory>> innovation_history)
+void neat::Genome::add_node(InnovationHistory &innovation_history)
 {
+    this->compiled_network.reset();
+
     // Pick a random connection to create a node between
     if (this->genes.empty())
     {
@@ -245,54 +234,54 @@ void neat::Genome::add_node(std::vector<std::shared_ptr<ConnectionHistory>> inno
         return;
     }
 
-    int random_connection = randrange(0, this->genes.size());
-    this->genes[random_connection]->enabled = false; // Disable the connection
+    // The genes are shifted by the insertion of the new connections, keep a copy of the old connection
+    ConnectionGene &random_connection = this->genes[randrange(0, this->genes.size())];
+    random_connection.enabled = false; // Disable the connection
+    ConnectionGene old_connection = random_connection;
 
     int new_node_nb = next_node;
-    int layer = this->genes[random_connection]->from_node->layer + 1;
+    int layer = this->nodes[old_connection.from_node].layer + 1;
 
-    std::shared_ptr<Node> new_node = std::make_shared<Node>(new_node_nb, this->config.activation_default, layer);
-    this->nodes.push_back(new_node);
+    int new_node = this->nodes.size();
+    this->nodes.emplace_back(new_node_nb, get_activation_function_type(this->config.activation_default), layer);
     ++this->next_node;
 
     // Add a new connection to the new node with a weight of 1
     int connection_innovation_nb = this->get_innovation_number(
         innovation_history,
-        this->genes[random_connection]->from_node,
+        old_connection.from_node,
         new_node);
 
-    this->genes.push_back(
-        std::make_shared<ConnectionGene>(
-            this->genes[random_connection]->from_node,
-            new_node,
-            1,
-            connection_innovation_nb,
-            this->config.enabled_default));
+    this->add_gene(ConnectionGene(
+        old_connection.from_node,
+        new_node,
+        1,
+        connection_innovation_nb,
+        this->config.enabled_default));
 
     connection_innovation_nb = this->get_innovation_number(
         innovation_history,
         new_node,
-        this->genes[random_connection]->to_node);
+        old_connection.to_node);
 
     // Add a new connection from the new node with a weight the same as the disabled connection
-    this->genes.push_back(
-        std::make_shared<ConnectionGene>(
-            new_node,
-            this->genes[random_connection]->to_node,
-            this->genes[random_connection]->weight,
-            connection_innovation_nb,
-            this->config.enabled_default));
+    this->add_gene(ConnectionGene(
+        new_node,
+        old_connection.to_node,
+        old_connection.weight,
+        connection_innovation_nb,
+        this->config.enabled_default));
 
     // If the layer of the new node is equal to the layer of the output node of the old connection,
     // then a new layer needs to be created
-    if (new_node->layer == this->genes[random_connection]->to_node->layer)
+    if (layer == this->nodes[old_connection.to_node].layer)
     {
         for (size_t i = 0; i < nodes.size() - 1; ++i)
         {
             // Don't include the new node
-            if (this->nodes[i]->layer >= new_node->layer)
+            if (this->nodes[i].layer >= layer)
             {
-                this->nodes[i]->layer += 1;
+                this->nodes[i].layer += 1;
             }
         }
         ++this->layers;
@@ -303,28 +292,40 @@ void neat::Genome::add_node(std::vector<std::shared_ptr<ConnectionHistory>> inno
 
 void neat::Genome::remove_node()
 {
+    this->compiled_network.reset();
+
     // Select a random node by excluding inputs, outputs
-    auto it = std::find_if(this->nodes.begin(), this->nodes.end(), [&](const std::shared_ptr<Node> n)
-                           { return n->layer != 0 && n->layer != layers - 1; });
+    auto it = std::find_if(this->nodes.begin(), this->nodes.end(), [&](const Node &n)
+                           { return n.layer != 0 && n.layer != layers - 1; });
 
     if (it != this->nodes.end())
     {
-        std::shared_ptr<Node> random_node = *it;
+        int random_node = it - this->nodes.begin();
+        int random_layer = it->layer;
         this->nodes.erase(it);
 
         // Remove the connections that are connected to the random node selected
-        auto removeCondition = [&](const std::shared_ptr<ConnectionGene> g)
+        auto removeCondition = [&](const ConnectionGene &g)
         {
-            return g->from_node == random_node || g->to_node == random_node;
+            return g.from_node == random_node || g.to_node == random_node;
         };
 
         this->genes.erase(std::remove_if(this->genes.begin(), this->genes.end(), removeCondition), this->genes.end());
 
+        // The nodes after the removed one are shifted
+        for (auto &g : this->genes)
+        {
+            if (g.from_node > random_node)
+                --g.from_node;
+            if (g.to_node > random_node)
+                --g.to_node;
+        }
+
         // Check if the layer of the node is unique
         bool unique_layer = true;
         for (const auto &n : this->nodes)
         {
-            if (n->layer == random_node->layer)
+            if (n.layer == random_layer)
             {
                 unique_layer = false;
                 break;
@@ -335,15 +336,20 @@ void neat::Genome::remove_node()
         if (unique_layer)
         {
             for (size_t i = 0; i < this->nodes.size(); ++i)
-                if (this->nodes[i]->layer > random_node->layer)
-                    this->nodes[i]->layer -= 1;
+                if (this->nodes[i].layer > random_layer)
+                    this->nodes[i].layer -= 1;
             --this->layers;
         }
+
+        // The indexes of the network and of the output connections are shifted too
+        this->generate_network();
     }
 }
 
-void neat::Genome::add_connection(std::vector<std::shared_ptr<ConnectionHistory>> innovation_history)
+void neat::Genome::add_connection(InnovationHistory &innovation_history)
 {
+    this->compiled_network.reset();
+
     // Cannot add a connection to a fully connected network
     if (fully_connected())
     {
@@ -352,22 +358,22 @@ void neat::Genome::add_connection(std::vector<std::shared_ptr<ConnectionHistory>
 
     auto random_connection_nodes_are_valid = [&](int rand1, int rand2)
     {
-        return (this->nodes[rand1]->layer != this->nodes[rand2]->layer) && !this->nodes[rand1]->is_connected_to(this->nodes[rand2]);
+        return (this->nodes[rand1].layer != this->nodes[rand2].layer) && !this->is_connected(rand1, rand2);
     };
 
     // Get random nodes
-    int random_node_1 = rand() % this->nodes.size();
-    int random_node_2 = rand() % this->nodes.size();
+    int random_node_1 = randrange(0, this->nodes.size());
+    int random_node_2 = randrange(0, this->nodes.size());
 
     while (!random_connection_nodes_are_valid(random_node_1, random_node_2))
     {
         // While the random nodes are not valid, get new ones
-        random_node_1 = rand() % this->nodes.size();
-        random_node_2 = rand() % this->nodes.size();
+        random_node_1 = randrange(0, this->nodes.size());
+        random_node_2 = randrange(0, this->nodes.size());
     }
 
     int temp;
-    if (this->nodes[random_node_1]->layer > this->nodes[random_node_2]->layer)
+    if (this->nodes[random_node_1].layer > this->nodes[random_node_2].layer)
     {
         // If the first random node is after the second, then switch
         temp = random_node_2;
@@ -379,27 +385,29 @@ void neat::Genome::add_connection(std::vector<std::shared_ptr<ConnectionHistory>
     // This will be a new number if no identical genome has mutated in the same way
     int connection_innovation_nb = this->get_innovation_number(
         innovation_history,
-        this->nodes[random_node_1],
-        this->nodes[random_node_2]);
+        random_node_1,
+        random_node_2);
 
     // Add the connection with a random weight
-    this->genes.push_back(
-        std::make_shared<ConnectionGene>(
-            this->nodes[random_node_1],
-            this->nodes[random_node_2],
-            new_connection_weight(),
-            connection_innovation_nb,
-            this->config.enabled_default));
+    this->add_gene(ConnectionGene(
+        random_node_1,
+        random_node_2,
+        new_connection_weight(),
+        connection_innovation_nb,
+        this->config.enabled_default));
 
     this->connect_nodes();
 }
 
 void neat::Genome::remove_connection()
 {
+    this->compiled_network.reset();
+
     if (!this->genes.empty())
     {
         auto random_gene = this->genes.begin() + randrange(0, this->genes.size());
         this->genes.erase(random_gene);
+        this->connect_nodes();
     }
 }
 
@@ -429,31 +437,10 @@ double neat::Genome::new_connection_weight() const
     return weight;
 }
 
-int neat::Genome::get_innovation_number(std::vector<std::shared_ptr<ConnectionHistory>> innovation_history, std::shared_ptr<Node> from_node, std::shared_ptr<Node> to_node) const
+int neat::Genome::get_innovation_number(InnovationHistory &innovation_history, int from_node, int to_node) const
 {
-    bool is_new = true;
-    int connection_innovation_nb = next_innovation_nb;
-
-    for (auto &history : innovation_history)
-    {
-        // For each previous mutation
-        if (history->matches(from_node, to_node))
-        {
-            // If a match is found
-            is_new = false; // It's not a new mutation
-            connection_innovation_nb = history->innovation_nb;
-            break;
-        }
-    }
-
-    if (is_new)
-    {
-        // Add this mutation to the innovation history
-        innovation_history.push_back(std::make_shared<ConnectionHistory>(from_node, to_node, connection_innovation_nb));
-        ++next_innovation_nb;
-    }
-
-    return connection_innovation_nb;
+    // A new number is registered in the history if no genome has mutated in the same way
+    return innovation_history.get_innovation_number(this->nodes[from_node].id, this->nodes[to_node].id);
 }
 
 bool neat::Genome::fully_connected() const
@@ -466,7 +453,7 @@ bool neat::Genome::fully_connected() const
     // Populate the array
     for (const auto &node : this->nodes)
     {
-        ++nodes_in_layers[node->layer];
+        ++nodes_in_layers[node.layer];
     }
 
     // For each layer, calculate the maximum number of connections
@@ -479,8 +466,10 @@ bool neat::Genome::fully_connected() const
     return max_connections <= static_cast<int>(this->genes.size());
 }
 
-void neat::Genome::mutate(std::vector<std::shared_ptr<ConnectionHistory>> innovation_history)
+void neat::Genome::mutate(InnovationHistory &innovation_history)
 {
+    this->compiled_network.reset();
+
     try
     {
         if (this->genes.empty())
@@ -490,12 +479,12 @@ void neat::Genome::mutate(std::vector<std::shared_ptr<ConnectionHistory>> innova
 
         for (auto &node : this->nodes)
         {
-            node->mutate(this->config);
+            node.mutate(this->config);
         }
 
         for (auto &gene : this->genes)
         {
-            gene->mutate(this->config);
+            gene.mutate(this->config);
         }
 
         if (randrange() < this->config.conn_add_prob)
@@ -527,26 +516,29 @@ void neat::Genome::mutate(std::vector<std::shared_ptr<ConnectionHistory>> innova
 neat::Genome *neat::Genome::crossover(Genome *parent) const
 {
     Genome *child = new Genome(this->config, true);
-    child->genes.clear();
-    child->nodes.clear();
     child->inputs = this->inputs;
     child->outputs = this->outputs;
     child->layers = this->layers;
     child->next_node = this->next_node;
 
-    std::vector<std::shared_ptr<ConnectionGene>> child_genes;
-    std::vector<bool> is_enabled;
+    // Since all excess and disjoint genes are inherited from the more fit parent (this Genome),
+    // the child structure is no different from this parent, except for dormant connections being enabled,
+    // but this won't affect nodes.
+    // So, all the nodes and the genes can be inherited from this parent, they keep the same indexes.
+    child->nodes = this->nodes;
+    child->genes = this->genes;
 
     // All inherited genes
-    for (const auto &gene : this->genes)
+    for (auto &gene : child->genes)
     {
         bool set_enabled = true; // Is this connection in the child going to be enabled
 
-        int parent_gene_index = matching_gene(parent, gene->innovation_nb);
+        int parent_gene_index = matching_gene(parent, gene.innovation_nb);
         if (parent_gene_index != -1)
         {
             // If the genes match
-            if (!gene->enabled || !parent->genes[parent_gene_index]->enabled)
+            const ConnectionGene &parent_gene = parent->genes[parent_gene_index];
+            if (!gene.enabled || !parent_gene.enabled)
             {
                 // If either of the matching genes is disabled
                 if (randrange() < 0.75)
@@ -556,42 +548,19 @@ neat::Genome *neat::Genome::crossover(Genome *parent) const
                 }
             }
 
-            if (randrange() < 0.5)
-            {
-                child_genes.push_back(gene);
-            }
-            else
+            if (randrange() >= 0.5)
             {
-                // Get gene from the parent
-                child_genes.push_back(parent->genes[parent_gene_index]);
+                // Get the weight from the parent, the nodes of matching genes have the same ids
+                gene.weight = parent_gene.weight;
             }
         }
         else
         {
             // Disjoint or excess gene
-            child_genes.push_back(gene);
-            set_enabled = gene->enabled;
+            set_enabled = gene.enabled;
         }
 
-        is_enabled.push_back(set_enabled);
-    }
-
-    // Since all excess and disjoint genes are inherited from the more fit parent (this Genome),
-    // the child structure is no different from this parent, except for dormant connections being enabled,
-    // but this won't affect nodes.
-    // So, all the nodes can be inherited from this parent.
-    for (auto &node : this->nodes)
-    {
-        child->nodes.push_back(node->clone());
-    }
-
-    // Clone all the connections so that they connect the child new nodes
-    for (size_t i = 0; i < child_genes.size(); ++i)
-    {
-        child->genes.push_back(child_genes[i]->clone(
-            child->get_node(child_genes[i]->from_node->id),
-            child->get_node(child_genes[i]->to_node->id)));
-        child->genes[i]->enabled = is_enabled[i];
+        gene.enabled = set_enabled;
     }
 
     child->connect_nodes();
@@ -600,12 +569,12 @@ neat::Genome *neat::Genome::crossover(Genome *parent) const
 
 int neat::Genome::matching_gene(Genome *parent, int innovation) const
 {
-    for (size_t i = 0; i < parent->genes.size(); ++i)
+    // The genes are sorted by innovation number
+    auto it = std::lower_bound(parent->genes.begin(), parent->genes.end(), innovation, [](const ConnectionGene &g, int innovation_nb)
+                               { return g.innovation_nb < innovation_nb; });
+    if (it != parent->genes.end() && it->innovation_nb == innovation)
     {
-        if (parent->genes[i]->innovation_nb == innovation)
-        {
-            return i;
-        }
+        return it - parent->genes.begin();
     }
     return -1; // No matching gene found
 }
@@ -622,13 +591,13 @@ void neat::Genome::print() const
     for (const auto &gene : this->genes)
     {
         std::cout << "{"
-                  << "innovation_nb: " << gene->innovation_nb << ", "
-                  << "from_node: " << gene->from_node->id << ", "
-                  << "to_node: " << gene->to_node->id << ", "
-                  << "enabled: " << gene->enabled << ", "
-                  << "from_layer: " << gene->from_node->layer << ", "
-                  << "to_layer: " << gene->to_node->layer << ", "
-                  << "weight: " << gene->weight << "}\n";
+                  << "innovation_nb: " << gene.innovation_nb << ", "
+                  << "from_node: " << this->nodes[gene.from_node].id << ", "
+                  << "to_node: " << this->nodes[gene.to_node].id << ", "
+                  << "enabled: " << gene.enabled << ", "
+                  << "from_layer: " << this->nodes[gene.from_node].layer << ", "
+                  << "to_layer: " << this->nodes[gene.to_node].layer << ", "
+                  << "weight: " << gene.weight << "}\n";
     }
 
     std::cout << std::endl;
@@ -654,7 +623,7 @@ bool neat::Genome::is_equal(Genome *other)
         bool found = false;
         for (auto &node2 : other->nodes)
         {
-            if (node1->is_equal(node2))
+            if (node1.is_equal(node2))
             {
                 found = true;
                 break;
@@ -672,7 +641,12 @@ bool neat::Genome::is_equal(Genome *other)
         bool found = false;
         for (auto &gene2 : other->genes)
         {
-            if (gene1->is_equal(gene2))
+            // The nodes are compared by id, their indexes may differ between the genomes
+            if (this->nodes[gene1.from_node].id == other->nodes[gene2.from_node].id &&
+                this->nodes[gene1.to_node].id == other->nodes[gene2.to_node].id &&
+                gene1.weight == gene2.weight &&
+                gene1.innovation_nb == gene2.innovation_nb &&
+                gene1.enabled == gene2.enabled)
             {
                 found = true;
                 break;
@@ -687,24 +661,58 @@ bool neat::Genome::is_equal(Genome *other)
     return true;
 }
 
-neat::Genome *neat::Genome::clone()
+// Hash a block of bytes with the 64-bit FNV-1a algorithm
+static uint64_t hash_bytes(const void *data, size_t size, uint64_t hash)
 {
-    Genome *clone = new Genome(this->config, true);
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+template <typename T>
+static uint64_t hash_value(const T &value, uint64_t hash)
+{
+    return hash_bytes(&value, sizeof(value), hash);
+}
+
+uint64_t neat::Genome::hash() const
+{
+    uint64_t hash = 14695981039346656037ULL;
+    hash = hash_value(this->inputs, hash);
+    hash = hash_value(this->outputs, hash);
+    hash = hash_value(this->layers, hash);
 
-    // Copy nodes
-    for (auto &node : this->nodes)
+    for (const auto &node : this->nodes)
     {
-        clone->nodes.push_back(node->clone());
+        hash = hash_value(node.id, hash);
+        hash = hash_value(node.layer, hash);
+        hash = hash_value(static_cast<int>(node.activation_function), hash);
     }
 
-    // Copy genes and connect them to the clone new nodes
-    for (auto &gene : this->genes)
+    for (const auto &gene : this->genes)
     {
-        clone->genes.push_back(gene->clone(
-            clone->get_node(gene->from_node->id),
-            clone->get_node(gene->to_node->id)));
+        hash = hash_value(gene.innovation_nb, hash);
+        hash = hash_value(this->nodes[gene.from_node].id, hash);
+        hash = hash_value(this->nodes[gene.to_node].id, hash);
+        hash = hash_value(gene.weight, hash);
+        hash = hash_value(gene.enabled, hash);
     }
 
+    return hash;
+}
+
+neat::Genome *neat::Genome::clone()
+{
+    Genome *clone = new Genome(this->config, true);
+
+    // Copy the nodes and the genes, they reference each other by index
+    clone->nodes = this->nodes;
+    clone->genes = this->genes;
+
     clone->inputs = this->inputs;
     clone->outputs = this->outputs;
     clone->layers = this->layers;
@@ -733,9 +741,9 @@ nlohmann::json neat::Genome::to_json() const
     {
         nlohmann::json node_json;
         // Serialize node data
-        node_json["id"] = node->id;
-        node_json["layer"] = node->layer;
-        node_json["activation_function"] = node->activation_function;
+        node_json["id"] = node.id;
+        node_json["layer"] = node.layer;
+        node_json["activation_function"] = get_activation_function_name(node.activation_function);
         // Add node to nodes array
         nodes_json.push_back(node_json);
     }
@@ -746,11 +754,11 @@ nlohmann::json neat::Genome::to_json() const
     {
         nlohmann::json gene_json;
         // Serialize gene data
-        gene_json["innovation_nb"] = gene->innovation_nb;
-        gene_json["from_node_id"] = gene->from_node->id;
-        gene_json["to_node_id"] = gene->to_node->id;
-        gene_json["enabled"] = gene->enabled;
-        gene_json["weight"] = gene->weight;
+        gene_json["innovation_nb"] = gene.innovation_nb;
+        gene_json["from_node_id"] = this->nodes[gene.from_node].id;
+        gene_json["to_node_id"] = this->nodes[gene.to_node].id;
+        gene_json["enabled"] = gene.enabled;
+        gene_json["weight"] = gene.weight;
         // Add gene to genes array
         genes_json.push_back(gene_json);
     }
@@ -774,7 +782,7 @@ neat::Genome *neat::Genome::from_json(const nlohmann::json &json)
         int id = node_json["id"];
         int layer = node_json["layer"];
         std::string activation_function = node_json["activation_function"];
-        genome->nodes.push_back(std::make_shared<neat::Node>(id, activation_function, layer));
+        genome->nodes.emplace_back(id, get_activation_function_type(activation_function), layer);
     }
 
     for (const auto &gene_json : json["genes"])
@@ -785,16 +793,104 @@ neat::Genome *neat::Genome::from_json(const nlohmann::json &json)
         bool enabled = gene_json["enabled"];
         double weight = gene_json["weight"];
 
-        std::shared_ptr<neat::Node> from_node = genome->get_node(from_node_id);
-        std::shared_ptr<neat::Node> to_node = genome->get_node(to_node_id);
+        int from_node = genome->get_node(from_node_id);
+        int to_node = genome->get_node(to_node_id);
 
-        genome->genes.push_back(std::make_shared<neat::ConnectionGene>(from_node, to_node, weight, innovation_nb, enabled));
+        genome->add_gene(neat::ConnectionGene(from_node, to_node, weight, innovation_nb, enabled));
     }
 
     genome->generate_network();
     return genome;
 }
 
+void neat::Genome::write(std::ostream &stream) const
+{
+    write_binary(stream, this->id);
+    write_binary(stream, static_cast<int32_t>(this->inputs));
+    write_binary(stream, static_cast<int32_t>(this->outputs));
+    write_binary(stream, static_cast<int32_t>(this->layers));
+    write_binary(stream, static_cast<int32_t>(this->next_node));
+    write_binary(stream, this->fitness);
+
+    write_binary(stream, static_cast<uint32_t>(this->nodes.size()));
+    for (const auto &node : this->nodes)
+    {
+        write_binary(stream, static_cast<int32_t>(node.id));
+        write_binary(stream, static_cast<int32_t>(node.layer));
+        write_binary(stream, static_cast<uint8_t>(node.activation_function));
+    }
+
+    // The genes reference the nodes by their index, which is kept when the nodes are read back
+    write_binary(stream, static_cast<uint32_t>(this->genes.size()));
+    for (const auto &gene : this->genes)
+    {
+        write_binary(stream, static_cast<int32_t>(gene.from_node));
+        write_binary(stream, static_cast<int32_t>(gene.to_node));
+        write_binary(stream, gene.weight);
+        write_binary(stream, static_cast<int32_t>(gene.innovation_nb));
+        write_binary(stream, static_cast<uint8_t>(gene.enabled));
+    }
+}
+
+neat::Genome *neat::Genome::read(std::istream &stream)
+{
+    std::unique_ptr<neat::Genome> genome = std::make_unique<neat::Genome>();
+
+    int32_t inputs, outputs, layers, next_node;
+    read_binary(stream, genome->id);
+    read_binary(stream, inputs);
+    read_binary(stream, outputs);
+    read_binary(stream, layers);
+    read_binary(stream, next_node);
+    read_binary(stream, genome->fitness);
+    genome->inputs = inputs;
+    genome->outputs = outputs;
+    genome->layers = layers;
+    genome->next_node = next_node;
+
+    uint32_t nb_nodes;
+    read_binary(stream, nb_nodes);
+    for (uint32_t i = 0; i < nb_nodes; ++i)
+    {
+        int32_t id, layer;
+        uint8_t activation_function;
+        read_binary(stream, id);
+        read_binary(stream, layer);
+        read_binary(stream, activation_function);
+
+        if (activation_function >= NB_ACTIVATION_FUNCTIONS)
+        {
+            throw std::runtime_error("Invalid activation function in the nodes of the genome " + genome->id);
+        }
+        genome->nodes.emplace_back(id, static_cast<ActivationFunctionType>(activation_function), layer);
+    }
+
+    uint32_t nb_genes;
+    read_binary(stream, nb_genes);
+    for (uint32_t i = 0; i < nb_genes; ++i)
+    {
+        int32_t from_node, to_node, innovation_nb;
+        double weight;
+        uint8_t enabled;
+        read_binary(stream, from_node);
+        read_binary(stream, to_node);
+        read_binary(stream, weight);
+        read_binary(stream, innovation_nb);
+        read_binary(stream, enabled);
+
+        if (from_node < 0 || to_node < 0 || from_node >= static_cast<int>(nb_nodes) || to_node >= static_cast<int>(nb_nodes))
+        {
+            throw std::runtime_error("Invalid node index in the genes of the genome " + genome->id);
+        }
+
+        // The genes were written sorted by innovation number
+        genome->genes.emplace_back(from_node, to_node, weight, innovation_nb, enabled != 0);
+    }
+
+    genome->generate_network();
+    return genome.release();
+}
+
 void neat::Genome::save(const std::string &file_path)
 {
     try
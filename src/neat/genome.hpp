@@ -2,34 +2,42 @@
 #define NEAT_GENOME_HPP
 
 #include <iostream>
+#include <istream>
+#include <ostream>
 #include <vector>
 #include <string>
+#include <memory>
+#include <cstdint>
 #include "json.hpp"
 #include "config.hpp"
+#include "node.hpp"
 #include "connection_gene.hpp"
+#include "compiled_network.hpp"
+#include "innovation_history.hpp"
 
 namespace neat
 {
 
-    class ConnectionHistory; // Forward declaration
-    class Node;              // Forward declaration
-
     /**
      * @brief Represents a genome in the NEAT (NeuroEvolution of Augmenting Topologies) algorithm.
+     *
+     * The nodes and the genes are stored by value in contiguous vectors and reference each other by index,
+     * so copying a genome copies a few flat vectors.
      */
     class Genome
     {
     public:
-        std::string id;                                     // Unique identifier for the genome.
-        Config config;                                      // Configuration settings for NEAT.
-        std::vector<std::shared_ptr<ConnectionGene>> genes; // List of connection genes.
-        std::vector<std::shared_ptr<Node>> nodes;           // List of nodes in the genome.
-        int inputs;                                         // Number of input nodes.
-        int outputs;                                        // Number of output nodes.
-        int layers;                                         // Number of layers in the neural network.
-        int next_node;                                      // ID for the next node to be added.
-        std::vector<std::shared_ptr<Node>> network;         // Fully connected network.
-        double fitness;                                     // Fitness score of the genome.
+        std::string id;                                    // Unique identifier for the genome.
+        Config config;                                     // Configuration settings for NEAT.
+        std::vector<ConnectionGene> genes;                 // List of connection genes, sorted by innovation number.
+        std::vector<Node> nodes;                           // List of nodes in the genome.
+        int inputs;                                        // Number of input nodes.
+        int outputs;                                       // Number of output nodes.
+        int layers;                                        // Number of layers in the neural network.
+        int next_node;                                     // ID for the next node to be added.
+        std::vector<int> network;                          // Indexes of the nodes of the fully connected network, layer by layer.
+        double fitness;                                    // Fitness score of the genome.
+        std::unique_ptr<CompiledNetwork> compiled_network; // Flat network used by feed_forward, rebuilt after a change of the genome.
 
         Genome();
         Genome(const Config &config, bool crossover = false);
@@ -41,28 +49,50 @@ namespace neat
 
         /**
          * @brief Fully connects the genome's neural network.
-         * @param innovation_history List of connection history for innovation tracking.
+         * @param innovation_history History of the innovations shared by the genomes.
          */
-        void fully_connect(std::vector<std::shared_ptr<ConnectionHistory>> innovation_history);
+        void fully_connect(InnovationHistory &innovation_history);
 
         /**
-         * @brief Retrieves a node based on its ID.
+         * @brief Retrieves the index of a node based on its ID.
          * @param id ID of the node.
-         * @return Pointer to the node if found, nullptr otherwise.
+         * @return Index of the node in the nodes if found, -1 otherwise.
          */
-        std::shared_ptr<Node> get_node(int id);
+        int get_node(int id) const;
+
+        /**
+         * @brief Adds a connection gene, keeping the genes sorted by innovation number.
+         * The output connections of the nodes must be connected again after it.
+         * @param gene The connection gene to add.
+         */
+        void add_gene(const ConnectionGene &gene);
 
         /**
          * @brief Connects nodes based on the genome's genes.
          */
         void connect_nodes();
 
+        /**
+         * @brief Checks if two nodes are connected by a gene, in either direction.
+         * @param node1 Index of the first node.
+         * @param node2 Index of the second node.
+         * @return True if connected, false otherwise.
+         */
+        bool is_connected(int node1, int node2) const;
+
         /**
          * @brief Performs a feed-forward operation on the neural network.
+         * The network is compiled at the first call after a change made by the methods of the genome.
          * @param input_values List of double values.
-         * @return List of output values.
+         * @return List of output values, valid until the next feed forward.
+         */
+        const std::vector<double> &feed_forward(const std::vector<double> &input_values);
+
+        /**
+         * @brief Compiles the network into its flat representation used by feed_forward.
+         * It must be called after changing the nodes or the genes of the genome directly.
          */
-        std::vector<double> feed_forward(std::vector<double> input_values);
+        void compile();
 
         /**
          * @brief Generates the network structure by adding nodes and connections.
@@ -71,9 +101,9 @@ namespace neat
 
         /**
          * @brief Adds a node to the genome.
-         * @param innovation_history List of connection history for innovation tracking.
+         * @param innovation_history History of the innovations shared by the genomes.
          */
-        void add_node(std::vector<std::shared_ptr<ConnectionHistory>> innovation_history);
+        void add_node(InnovationHistory &innovation_history);
 
         /**
          * @brief Removes a node from the genome.
@@ -82,9 +112,9 @@ namespace neat
 
         /**
          * @brief Adds a connection to the genome.
-         * @param innovation_history List of connection history for innovation tracking.
+         * @param innovation_history History of the innovations shared by the genomes.
          */
-        void add_connection(std::vector<std::shared_ptr<ConnectionHistory>> innovation_history);
+        void add_connection(InnovationHistory &innovation_history);
 
         /**
          * @brief Removes a connection from the genome.
@@ -99,12 +129,12 @@ namespace neat
 
         /**
          * @brief Gets the innovation number for a connection between two nodes.
-         * @param innovation_history List of connection history for innovation tracking.
-         * @param from_node Pointer to the source node.
-         * @param to_node Pointer to the target node.
+         * @param innovation_history History of the innovations shared by the genomes.
+         * @param from_node Index of the source node.
+         * @param to_node Index of the target node.
          * @return Innovation number for the connection.
          */
-        int get_innovation_number(std::vector<std::shared_ptr<ConnectionHistory>> innovation_history, std::shared_ptr<Node> from_node, std::shared_ptr<Node> to_node) const;
+        int get_innovation_number(InnovationHistory &innovation_history, int from_node, int to_node) const;
 
         /**
          * @brief Checks if the genome is fully connected.
@@ -114,9 +144,9 @@ namespace neat
 
         /**
          * @brief Mutates the genome based on configuration settings.
-         * @param innovation_history List of connection history for innovation tracking.
+         * @param innovation_history History of the innovations shared by the genomes.
          */
-        void mutate(std::vector<std::shared_ptr<ConnectionHistory>> innovation_history);
+        void mutate(InnovationHistory &innovation_history);
 
         /**
          * @brief Performs crossover with another genome to create a child genome.
@@ -145,6 +175,13 @@ namespace neat
          */
         bool is_equal(Genome *other);
 
+        /**
+         * @brief Calculates a hash of the content of the genome: its structure, its weights and its activation functions.
+         * The id and the fitness are not part of the hash, so the clones of a genome have the same hash.
+         * @return Hash of the genome.
+         */
+        uint64_t hash() const;
+
         /**
          * @brief Creates a clone of the genome.
          * @return Cloned genome.
@@ -164,6 +201,20 @@ namespace neat
          */
         static Genome *from_json(const nlohmann::json &json);
 
+        /**
+         * @brief Writes the genome to a binary stream.
+         * @param stream The output stream.
+         */
+        void write(std::ostream &stream) const;
+
+        /**
+         * @brief Reads a genome written by write from a binary stream.
+         * @param stream The input stream.
+         * @return Genome read from the stream.
+         * @throws std::runtime_error If the stream is truncated or corrupted.
+         */
+        static Genome *read(std::istream &stream);
+
         /**
          * @brief Saves the genome to a binary file.
          * @param file_path Path to the file.
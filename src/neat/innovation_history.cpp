@@ -0,0 +1,120 @@
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include "json.hpp"
+#include "binary_io.hpp"
+#include "innovation_history.hpp"
+
+// Next innovation number, shared by all the histories so their new connections never get the same number
+static std::atomic<int> next_innovation_nb(1);
+
+neat::InnovationHistory::InnovationHistory() {}
+
+neat::InnovationHistory::InnovationHistory(const InnovationHistory &other)
+{
+    std::lock_guard<std::mutex> lock(other.mutex);
+    this->innovations = other.innovations;
+}
+
+neat::InnovationHistory &neat::InnovationHistory::operator=(const InnovationHistory &other)
+{
+    if (this != &other)
+    {
+        std::scoped_lock lock(this->mutex, other.mutex);
+        this->innovations = other.innovations;
+    }
+    return *this;
+}
+
+uint64_t neat::InnovationHistory::get_key(int from_node_id, int to_node_id)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(from_node_id)) << 32) | static_cast<uint32_t>(to_node_id);
+}
+
+int neat::InnovationHistory::get_innovation_number(int from_node_id, int to_node_id)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    // Add the connection to the history if it is a new mutation
+    auto [it, is_new] = this->innovations.try_emplace(get_key(from_node_id, to_node_id), 0);
+    if (is_new)
+    {
+        it->second = next_innovation_nb++;
+    }
+
+    return it->second;
+}
+
+size_t neat::InnovationHistory::size() const
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->innovations.size();
+}
+
+nlohmann::json neat::InnovationHistory::to_json() const
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    nlohmann::json json = nlohmann::json::array();
+    for (const auto &[key, innovation_nb] : this->innovations)
+    {
+        json.push_back({
+            {"from_node_id", static_cast<int>(key >> 32)},
+            {"to_node_id", static_cast<int>(key & 0xFFFFFFFF)},
+            {"innovation_nb", innovation_nb},
+        });
+    }
+    return json;
+}
+
+neat::InnovationHistory neat::InnovationHistory::from_json(const nlohmann::json &json)
+{
+    InnovationHistory history;
+    for (const auto &innovation_json : json)
+    {
+        int innovation_nb = innovation_json["innovation_nb"];
+        history.innovations[get_key(innovation_json["from_node_id"], innovation_json["to_node_id"])] = innovation_nb;
+        reserve_innovation_number(innovation_nb);
+    }
+    return history;
+}
+
+void neat::InnovationHistory::write(std::ostream &stream) const
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    write_binary(stream, static_cast<uint64_t>(this->innovations.size()));
+    for (const auto &[key, innovation_nb] : this->innovations)
+    {
+        write_binary(stream, key);
+        write_binary(stream, static_cast<int32_t>(innovation_nb));
+    }
+}
+
+neat::InnovationHistory neat::InnovationHistory::read(std::istream &stream)
+{
+    InnovationHistory history;
+
+    uint64_t size;
+    read_binary(stream, size);
+    history.innovations.reserve(size);
+    for (uint64_t i = 0; i < size; ++i)
+    {
+        uint64_t key;
+        int32_t innovation_nb;
+        read_binary(stream, key);
+        read_binary(stream, innovation_nb);
+        history.innovations[key] = innovation_nb;
+        reserve_innovation_number(innovation_nb);
+    }
+    return history;
+}
+
+void neat::InnovationHistory::reserve_innovation_number(int innovation_nb)
+{
+    // The new innovation numbers must come after the loaded ones
+    int next = next_innovation_nb.load();
+    while (next <= innovation_nb && !next_innovation_nb.compare_exchange_weak(next, innovation_nb + 1))
+    {
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef NEAT_INNOVATION_HISTORY_HPP
+#define NEAT_INNOVATION_HISTORY_HPP
+
+#include <cstdint>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include "json.hpp"
+
+namespace neat
+{
+
+    /**
+     * @brief Registry of the innovation numbers of the connections, indexed by the ids of their nodes.
+     *
+     * It is shared by reference by the genomes of a population and can be used by several threads at once.
+     */
+    class InnovationHistory
+    {
+    public:
+        InnovationHistory();
+
+        /**
+         * @brief Copy the innovations of another history.
+         * @param other The history to copy.
+         */
+        InnovationHistory(const InnovationHistory &other);
+
+        /**
+         * @brief Copy the innovations of another history.
+         * @param other The history to copy.
+         * @return This history.
+         */
+        InnovationHistory &operator=(const InnovationHistory &other);
+
+        /**
+         * @brief Get the innovation number of the connection between two nodes, a new number is registered if the connection is new.
+         * @param from_node_id ID of the source node.
+         * @param to_node_id ID of the target node.
+         * @return Innovation number of the connection.
+         */
+        int get_innovation_number(int from_node_id, int to_node_id);
+
+        /**
+         * @brief Get the number of connections registered in the history.
+         * @return The number of connections.
+         */
+        size_t size() const;
+
+        /**
+         * @brief Converts the history to a JSON object.
+         * @return JSON representation of the history.
+         */
+        nlohmann::json to_json() const;
+
+        /**
+         * @brief Creates a history from a JSON object, the next new innovation numbers come after the loaded ones.
+         * @param json JSON object representing the history.
+         * @return History created from the JSON object.
+         */
+        static InnovationHistory from_json(const nlohmann::json &json);
+
+        /**
+         * @brief Writes the history to a binary stream.
+         * @param stream The output stream.
+         */
+        void write(std::ostream &stream) const;
+
+        /**
+         * @brief Reads a history written by write from a binary stream, the next new innovation numbers come after the loaded ones.
+         * @param stream The input stream.
+         * @return History read from the stream.
+         */
+        static InnovationHistory read(std::istream &stream);
+
+    private:
+        std::unordered_map<uint64_t, int> innovations; // Innovation number of each connection, indexed by the ids of its nodes.
+        mutable std::mutex mutex;                      // Mutex protecting the innovations.
+
+        /**
+         * @brief Get the key of a connection in the innovations.
+         * @param from_node_id ID of the source node.
+         * @param to_node_id ID of the target node.
+         * @return The key of the connection.
+         */
+        static uint64_t get_key(int from_node_id, int to_node_id);
+
+        /**
+         * @brief Make sure the new innovation numbers come after a loaded one.
+         * @param innovation_nb The loaded innovation number.
+         */
+        static void reserve_innovation_number(int innovation_nb);
+    };
+
+}
+
+#endif
@@ -1,15 +1,27 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <random>
 #include "math_utils.hpp"
 
+RandomGenerator &neat::get_random_generator()
+{
+    thread_local RandomGenerator generator((static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}());
+    return generator;
+}
+
+void neat::seed_random_generator(uint64_t master_seed, uint64_t stream)
+{
+    if (master_seed != 0)
+    {
+        get_random_generator().seed(derive_seed(master_seed, stream));
+    }
+}
+
 double neat::randrange(double min, double max)
 {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<double> distribution(min, max);
-    return distribution(gen);
+    return min + (max - min) * get_random_generator().next_double();
 }
 
 double neat::uniform(double min, double max)
@@ -19,7 +31,8 @@ double neat::uniform(double min, double max)
 
 double neat::normal(double mean, double stdev)
 {
-    double u1 = randrange();
+    // u1 is in (0, 1], so its logarithm is finite
+    double u1 = 1.0 - randrange();
     double u2 = randrange();
     double z = sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
     return mean + stdev * z;
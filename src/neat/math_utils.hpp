@@ -1,8 +1,28 @@
 #ifndef NEAT_MATH_UTILS_HPP
 #define NEAT_MATH_UTILS_HPP
 
+#include <cstdint>
+#include "../utils/random.hpp"
+
 namespace neat
 {
+    /**
+     * Gets the generator of the calling thread, used by all the random functions of the module.
+     * Each thread has its own generator, seeded randomly until seed_random_generator is called.
+     *
+     * @return The generator of the calling thread.
+     */
+    RandomGenerator &get_random_generator();
+
+    /**
+     * Seeds the generator of the calling thread with a stream derived from a master seed,
+     * so the values drawn afterwards only depend on the master seed and the stream, not on the thread.
+     *
+     * @param master_seed The master seed. 0 leaves the generator unchanged, for non reproducible runs.
+     * @param stream The index of the stream.
+     */
+    void seed_random_generator(uint64_t master_seed, uint64_t stream);
+
     /**
      * Generates a random double value in the range [min, max).
      *
@@ -31,4 +51,4 @@ namespace neat
     double normal(double mean, double stdev);
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -7,23 +7,18 @@
 
 namespace neat
 {
-    // Type alias for the function pointer
-    using ActivationFunctionPointer = double (*)(double);
-
-    class ConnectionGene; // Forward declaration
-
     /**
      * @brief Represents a node in a neural network.
      */
     class Node
     {
     public:
-        int id;                                                          // Unique identifier for the node.
-        double input_sum;                                                // Accumulated input sum for the node.
-        double output_value;                                             // Output value after activation.
-        std::vector<std::shared_ptr<ConnectionGene>> output_connections; // List of outgoing connections.
-        int layer;                                                       // Layer to which the node belongs.
-        neat::ActivationFunction activation_function;                    // Activation function of the node.
+        int id;                                       // Unique identifier for the node.
+        double input_sum;                             // Accumulated input sum for the node.
+        double output_value;                          // Output value after activation.
+        std::vector<int> output_connections;          // Indexes of the outgoing connection genes in the genome.
+        int layer;                                    // Layer to which the node belongs.
+        ActivationFunctionType activation_function;  // Activation function of the node.
 
         /**
          * @brief Constructor for the Node class.
@@ -31,22 +26,13 @@ namespace neat
          * @param activation_function Activation function of the node.
          * @param layer Layer to which the node belongs.
          */
-        Node(int id, ActivationFunction activation_function, int layer);
-
-        /**
-         * @brief Destructor for the Node class.
-         */
-        ~Node();
+        Node(int id, ActivationFunctionType activation_function, int layer);
 
         /**
          * @brief Activate the node using its activation function.
+         * @param fast Flag to use the fast approximation of the sigmoid, tanh and swish functions. Default is false.
          */
-        void activate();
-
-        /**
-         * @brief Propagate the output to connected nodes.
-         */
-        void propagate_output();
+        void activate(bool fast = false);
 
         /**
          * @brief Mutates the node's properties based on the NEAT algorithm.
@@ -54,33 +40,12 @@ namespace neat
          */
         void mutate(const Config &config);
 
-        /**
-         * @brief Checks if the node is connected to another node.
-         * @param node Pointer to the target node.
-         * @return True if connected, false otherwise.
-         */
-        bool is_connected_to(std::shared_ptr<Node> node);
-
         /**
          * @brief Compare two nodes.
          * @param other The node to compare with it.
-         * @return True if the nodes are the same and connection genes, otherwise false.
-         */
-        bool is_equal(std::shared_ptr<Node> other);
-
-        /**
-         * @brief Creates a clone of the node.
-         * @return Pointer to the cloned node.
-         */
-        std::shared_ptr<Node> clone();
-
-    private:
-        /**
-         * @brief Retrieves the activation function based on the specified enum.
-         * @param activation_function Activation function specified by the enum.
-         * @return Pointer to the activation function.
+         * @return True if the nodes have the same id, layer and activation function, otherwise false.
          */
-        ActivationFunctionPointer get_function(ActivationFunction function);
+        bool is_equal(const Node &other) const;
     };
 
 }
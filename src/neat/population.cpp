@@ -1,32 +1,42 @@
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <vector>
 #include <algorithm>
 #include <functional>
-#include <thread>
 #include <fstream>
 #include <filesystem>
 #include "json.hpp"
+#include "binary_io.hpp"
 #include "config.hpp"
+#include "math_utils.hpp"
 #include "genome.hpp"
-#include "connection_history.hpp"
+#include "innovation_history.hpp"
 #include "species.hpp"
+#include "../utils/thread_pool.hpp"
 #include "population.hpp"
 
+// Index of the stream of random values used to create the genome at an index of a generation
+static uint64_t get_random_stream(int generation, size_t index)
+{
+    return (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(index);
+}
+
 neat::Population::Population(const Config &config, bool init_genomes) : config(config)
 {
     this->generation = 0;
     this->best_fitness = 0;
     this->average_fitness = 0;
     this->best_genome = nullptr;
-    this->innovation_history = {};
     this->species = {};
     this->genomes = {};
+    this->thread_pool = nullptr;
 
     if (init_genomes)
     {
         for (int i = 0; i < this->config.population_size; ++i)
         {
+            seed_random_generator(this->config.seed, get_random_stream(0, i));
             Genome *genome = new Genome(config);
             genome->mutate(this->innovation_history);
             genome->generate_network();
@@ -66,50 +76,78 @@ void neat::Population::set_best_genome()
     }
 }
 
+void neat::Population::set_thread_pool(ThreadPool *thread_pool)
+{
+    this->thread_pool = thread_pool;
+}
+
+ThreadPool *neat::Population::get_thread_pool()
+{
+    if (this->thread_pool == nullptr)
+    {
+        this->own_thread_pool = std::make_unique<ThreadPool>(std::max(0, this->config.num_threads));
+        this->thread_pool = this->own_thread_pool.get();
+    }
+    return this->thread_pool;
+}
+
 void neat::Population::run(std::function<void(Genome *, int)> evaluate_genome, int nb_generations, std::function<void(Population *, int)> callback_generation)
 {
+    ThreadPool *pool = this->get_thread_pool();
+
     for (int i = 0; i < nb_generations; ++i)
     {
-        // Use threads to evaluate genomes in parallel
-        std::vector<std::thread> threads;
-        for (size_t j = 0; j < this->genomes.size(); ++j)
-            threads.emplace_back([&, j]()
-                                 { evaluate_genome(this->genomes[j], i); });
+        // Evaluate the genomes in parallel, chunk by chunk, and wait for all of them
+        pool->parallel_for(this->genomes.size(), [&](size_t j)
+                           { evaluate_genome(this->genomes[j], i); });
 
-        // Wait for all threads to finish
-        for (auto &thread : threads)
+        if (this->evolve(i, callback_generation))
         {
-            thread.join();
+            break;
         }
+    }
+}
 
-        this->speciate();
-        this->sort_species();
-        this->update_species();
-        this->set_best_genome();
-        this->set_average_fitness();
-        this->kill_stagnant_species();
-        this->kill_bad_species();
-        this->reproduce_species();
-        this->reset_on_extinction();
-
-        // Callback function for each generation
-        if (callback_generation)
-        {
-            callback_generation(this, i);
-        }
+void neat::Population::run_lockstep(std::function<void(const std::vector<Genome *> &, int)> evaluate_genomes, int nb_generations, std::function<void(Population *, int)> callback_generation)
+{
+    for (int i = 0; i < nb_generations; ++i)
+    {
+        // Evaluate all the genomes of the generation together
+        evaluate_genomes(this->genomes, i);
 
-        // Stop the algorithm if the fitness threshold is reached
-        if (!this->config.no_fitness_termination && this->best_genome->fitness > this->config.fitness_threshold)
+        if (this->evolve(i, callback_generation))
         {
             break;
         }
+    }
+}
 
-        // Stop the algorithm if the best fitness is infinity
-        if (this->best_fitness == std::numeric_limits<double>::infinity())
-        {
-            break;
-        }
+bool neat::Population::evolve(int generation, std::function<void(Population *, int)> callback_generation)
+{
+    this->speciate();
+    this->sort_species();
+    this->update_species();
+    this->set_best_genome();
+    this->set_average_fitness();
+    this->kill_stagnant_species();
+    this->kill_bad_species();
+    this->reproduce_species();
+    this->reset_on_extinction();
+
+    // Callback function for each generation
+    if (callback_generation)
+    {
+        callback_generation(this, generation);
+    }
+
+    // Stop the algorithm if the fitness threshold is reached
+    if (!this->config.no_fitness_termination && this->best_genome->fitness > this->config.fitness_threshold)
+    {
+        return true;
     }
+
+    // Stop the algorithm if the best fitness is infinity
+    return this->best_fitness == std::numeric_limits<double>::infinity();
 }
 
 void neat::Population::speciate()
@@ -120,14 +158,36 @@ void neat::Population::speciate()
         s->genomes.clear();
     }
 
+    // Calculate the distances of the genomes to the champions of the existing species in parallel
+    size_t nb_species = this->species.size();
+    std::vector<int> excess_and_disjoint(this->genomes.size() * nb_species);
+    std::vector<float> avg_weight_diff(this->genomes.size() * nb_species);
+    if (nb_species > 0)
+    {
+        this->get_thread_pool()->parallel_for(this->genomes.size(), [&](size_t i)
+                                              {
+                                                  for (size_t j = 0; j < nb_species; ++j)
+                                                  {
+                                                      Species *s = this->species[j];
+                                                      excess_and_disjoint[i * nb_species + j] = s->get_excess_disjoint_genes(this->genomes[i], s->champion);
+                                                      avg_weight_diff[i * nb_species + j] = s->average_weight_diff(this->genomes[i], s->champion);
+                                                  } });
+    }
+
     // Group the genomes by species
-    for (auto &g : this->genomes)
+    for (size_t i = 0; i < this->genomes.size(); ++i)
     {
+        Genome *g = this->genomes[i];
         bool species_found = false;
 
-        for (auto &s : this->species)
+        for (size_t j = 0; j < this->species.size(); ++j)
         {
-            if (s->same_species(g, this->config))
+            Species *s = this->species[j];
+
+            // The distances to the champions of the species created in this loop are not calculated yet
+            bool same_species = j < nb_species ? s->same_species(excess_and_disjoint[i * nb_species + j], avg_weight_diff[i * nb_species + j], this->config)
+                                               : s->same_species(g, this->config);
+            if (same_species)
             {
                 s->add_to_species(g);
                 species_found = true;
@@ -158,9 +218,16 @@ void neat::Population::reproduce_species()
     // Create a vector to store the new generation of genomes
     std::vector<Genome *> children;
 
+    // Each child draws its random values from its own stream, so the next generation only depends on the seed
+    auto seed_next_child = [&]()
+    {
+        seed_random_generator(this->config.seed, get_random_stream(this->generation + 1, children.size()));
+    };
+
     for (auto &s : this->species)
     {
         // Clone the champion of each species and add it to the new generation
+        seed_next_child();
         children.push_back(s->champion->clone());
 
         // Calculate the number of children based on the species' contribution to the total average fitness
@@ -169,6 +236,7 @@ void neat::Population::reproduce_species()
         // Generate babies and add them to the new generation
         for (int i = 0; i < nb_of_children; ++i)
         {
+            seed_next_child();
             children.push_back(s->give_me_baby(this->innovation_history));
         }
     }
@@ -177,12 +245,14 @@ void neat::Population::reproduce_species()
     Genome *previous_best = genomes[0];
     if (children.size() < static_cast<size_t>(population_size))
     {
+        seed_next_child();
         children.push_back(previous_best->clone());
     }
 
     // If there are still not enough babies, get babies from the best species until reaching the target population size
     while (children.size() < static_cast<size_t>(population_size))
     {
+        seed_next_child();
         children.push_back(species[0]->give_me_baby(this->innovation_history));
     }
 
@@ -291,6 +361,37 @@ void neat::Population::update_species()
     }
 }
 
+void neat::Population::add_immigrants(const std::vector<Genome *> &immigrants)
+{
+    // The first genome is the champion of the best species, it is kept
+    size_t nb_immigrants = std::min(immigrants.size(), this->genomes.empty() ? 0 : this->genomes.size() - 1);
+
+    for (size_t i = 0; i < nb_immigrants; ++i)
+    {
+        Genome *immigrant = immigrants[i];
+
+        // The immigrants read from JSON have the default configuration, they get the one of the population
+        immigrant->config = this->config;
+
+        // The innovation numbers of another population do not match the ones of this population
+        for (auto &gene : immigrant->genes)
+        {
+            gene.innovation_nb = this->innovation_history.get_innovation_number(immigrant->nodes[gene.from_node].id, immigrant->nodes[gene.to_node].id);
+        }
+        std::sort(immigrant->genes.begin(), immigrant->genes.end(), [](const ConnectionGene &g1, const ConnectionGene &g2)
+                  { return g1.innovation_nb < g2.innovation_nb; });
+        immigrant->generate_network();
+
+        this->genomes[this->genomes.size() - 1 - i] = immigrant;
+    }
+
+    // No room for the other immigrants
+    for (size_t i = nb_immigrants; i < immigrants.size(); ++i)
+    {
+        delete immigrants[i];
+    }
+}
+
 neat::Population *neat::Population::clone()
 {
     Population *clone = new Population(this->config);
@@ -351,6 +452,7 @@ void neat::Population::save(const std::string &filename)
         json["generation"] = this->generation;
         json["average_fitness"] = this->average_fitness;
         json["best_fitness"] = this->best_fitness;
+        json["innovation_history"] = this->innovation_history.to_json();
 
         // Save the best genome
         if (this->best_genome != nullptr)
@@ -405,6 +507,12 @@ neat::Population *neat::Population::load(const std::string &filename, const Conf
         loadedPopulation->average_fitness = population_json["average_fitness"];
         loadedPopulation->generation = population_json["generation"];
 
+        if (population_json.contains("innovation_history"))
+        {
+            // Deserialize the history of the innovations
+            loadedPopulation->innovation_history = InnovationHistory::from_json(population_json["innovation_history"]);
+        }
+
         if (population_json.contains("best_genome"))
         {
             // Deserialize the champion genome
@@ -442,3 +550,147 @@ neat::Population *neat::Population::load(const std::string &filename, const Conf
         return nullptr;
     }
 }
+
+void neat::Population::write(std::ostream &stream) const
+{
+    stream.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    write_binary(stream, CHECKPOINT_VERSION);
+
+    write_binary(stream, static_cast<int32_t>(this->generation));
+    write_binary(stream, this->average_fitness);
+    write_binary(stream, this->best_fitness);
+    this->innovation_history.write(stream);
+
+    // Write the best genome
+    write_binary(stream, static_cast<uint8_t>(this->best_genome != nullptr));
+    if (this->best_genome != nullptr)
+    {
+        this->best_genome->write(stream);
+    }
+
+    // Write the species
+    write_binary(stream, static_cast<uint32_t>(this->species.size()));
+    for (const auto &s : this->species)
+    {
+        s->write(stream);
+    }
+
+    // Write the genomes
+    write_binary(stream, static_cast<uint32_t>(this->genomes.size()));
+    for (const auto &g : this->genomes)
+    {
+        g->write(stream);
+    }
+}
+
+neat::Population *neat::Population::read(std::istream &stream, const Config &config)
+{
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    uint32_t version;
+    if (!stream.read(magic, sizeof(magic)) || std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0)
+    {
+        throw std::runtime_error("The stream is not a checkpoint of a population");
+    }
+    read_binary(stream, version);
+    if (version != CHECKPOINT_VERSION)
+    {
+        throw std::runtime_error("The version of the checkpoint is not supported: " + std::to_string(version));
+    }
+
+    std::unique_ptr<Population> population = std::make_unique<Population>(config, false);
+
+    int32_t generation;
+    read_binary(stream, generation);
+    read_binary(stream, population->average_fitness);
+    read_binary(stream, population->best_fitness);
+    population->generation = generation;
+    population->innovation_history = InnovationHistory::read(stream);
+
+    // Read the best genome
+    uint8_t has_best_genome;
+    read_binary(stream, has_best_genome);
+    if (has_best_genome)
+    {
+        population->best_genome = Genome::read(stream);
+        population->best_genome->config = config;
+    }
+
+    // Read the species
+    uint32_t nb_species;
+    read_binary(stream, nb_species);
+    for (uint32_t i = 0; i < nb_species; ++i)
+    {
+        Species *species = Species::read(stream);
+        population->species.push_back(species);
+        if (species->champion != nullptr)
+        {
+            species->champion->config = config;
+        }
+        for (auto &g : species->genomes)
+        {
+            g->config = config;
+        }
+    }
+
+    // Read the genomes
+    uint32_t nb_genomes;
+    read_binary(stream, nb_genomes);
+    for (uint32_t i = 0; i < nb_genomes; ++i)
+    {
+        Genome *genome = Genome::read(stream);
+        genome->config = config;
+        population->genomes.push_back(genome);
+    }
+
+    return population.release();
+}
+
+void neat::Population::save_checkpoint(const std::string &filename) const
+{
+    try
+    {
+        // Check if the directory exists, create it if not
+        std::filesystem::path dir = std::filesystem::path(filename).parent_path();
+        if (!dir.empty() && !std::filesystem::exists(dir))
+        {
+            std::filesystem::create_directories(dir);
+        }
+
+        // Write to a temporary file renamed afterwards, so the previous checkpoint stays valid until the new one is complete
+        std::string temporary_file = filename + ".tmp";
+        std::ofstream file(temporary_file, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Failed to open file for writing: " + temporary_file);
+        }
+        this->write(file);
+        file.close();
+        if (!file)
+        {
+            throw std::runtime_error("Failed to write the file: " + temporary_file);
+        }
+        std::filesystem::rename(temporary_file, filename);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Failed to save the checkpoint of the population: " << e.what() << std::endl;
+    }
+}
+
+neat::Population *neat::Population::load_checkpoint(const std::string &filename, const Config &config)
+{
+    try
+    {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Failed to open file for reading: " + filename);
+        }
+        return Population::read(file, config);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Failed to load the checkpoint of the population: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
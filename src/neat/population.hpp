@@ -2,15 +2,29 @@
 #define NEAT_POPULATION_HPP
 
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <algorithm>
 #include <functional>
+#include <istream>
+#include <memory>
+#include <ostream>
 #include "genome.hpp"
 #include "species.hpp"
-#include "connection_history.hpp"
+#include "innovation_history.hpp"
+#include "../utils/thread_pool.hpp"
 
 namespace neat
 {
+    /**
+     * @brief Magic bytes at the beginning of every checkpoint of a population.
+     */
+    constexpr char CHECKPOINT_MAGIC[8] = {'N', 'E', 'A', 'T', 'C', 'K', 'P', 'T'};
+
+    /**
+     * @brief Version of the binary layout of the checkpoints. Checkpoints with another version are rejected.
+     */
+    constexpr uint32_t CHECKPOINT_VERSION = 2;
 
     /**
      * @class Population
@@ -25,8 +39,10 @@ namespace neat
         int generation;                                                     // Current generation number.
         double best_fitness;                                                // Fitness of the best genome.
         double average_fitness;                                             // Average fitness of the population.
-        std::vector<std::shared_ptr<ConnectionHistory>> innovation_history; // List of connection history to track innovations.
+        InnovationHistory innovation_history;                               // History of the innovations shared by the genomes.
         std::vector<Species *> species;                                     // List of species within the population.
+        ThreadPool *thread_pool;                                            // Pool of threads evaluating the genomes, given or created at the first run.
+        std::unique_ptr<ThreadPool> own_thread_pool;                        // Pool of threads created by the population when none is given.
 
         /**
          * @brief Constructor for the Population class.
@@ -45,16 +61,46 @@ namespace neat
          */
         void set_best_genome();
 
+        /**
+         * @brief Set the pool of threads evaluating the genomes, to share the pool of the caller.
+         * @param thread_pool The pool of threads, it must outlive the population.
+         */
+        void set_thread_pool(ThreadPool *thread_pool);
+
+        /**
+         * @brief Get the pool of threads evaluating the genomes, it is created at the first call if none is given.
+         * @return The pool of threads, sized from the number of threads of the configuration when it is created.
+         */
+        ThreadPool *get_thread_pool();
+
         /**
          * @brief Runs the NEAT algorithm for a specified number of generations.
+         * The genomes are evaluated in parallel by the threads of the pool.
          * @param evaluate_genome Function for evaluating the fitness of a genome.
          * @param nb_generations Number of generations to run the algorithm.
          * @param callback_generation Callback function for each generation (optional).
          */
         void run(std::function<void(Genome *, int)> evaluate_genome, int nb_generations, std::function<void(Population *, int)> callback_generation = nullptr);
 
+        /**
+         * @brief Runs the NEAT algorithm for a specified number of generations, evaluating all the genomes of a generation in a single call.
+         * @param evaluate_genomes Function for evaluating the fitness of all the genomes of a generation together.
+         * @param nb_generations Number of generations to run the algorithm.
+         * @param callback_generation Callback function for each generation (optional).
+         */
+        void run_lockstep(std::function<void(const std::vector<Genome *> &, int)> evaluate_genomes, int nb_generations, std::function<void(Population *, int)> callback_generation = nullptr);
+
+        /**
+         * @brief Evolves the evaluated genomes into the next generation.
+         * @param generation Index of the generation in the current run.
+         * @param callback_generation Callback function for each generation (optional).
+         * @return True if the algorithm must stop, false otherwise.
+         */
+        bool evolve(int generation, std::function<void(Population *, int)> callback_generation = nullptr);
+
         /**
          * @brief Groups the genomes into species based on their compatibility.
+         * The distances to the champions of the existing species are calculated in parallel before the genomes are assigned.
          */
         void speciate();
 
@@ -99,6 +145,13 @@ namespace neat
          */
         void update_species();
 
+        /**
+         * @brief Replaces the last genomes of the next generation by genomes coming from another population.
+         * The innovation numbers of their genes are taken from the history of this population, by the ids of the connected nodes.
+         * @param immigrants The genomes to add, owned by the population afterwards. The ones without room are deleted.
+         */
+        void add_immigrants(const std::vector<Genome *> &immigrants);
+
         /**
          * @brief Return a copy of this population.
          * @return A copy of this population.
@@ -117,6 +170,36 @@ namespace neat
          * @param config NEAT configuration settings.
          */
         static neat::Population *load(const std::string &filename, const Config &config);
+
+        /**
+         * @brief Write a binary checkpoint of the population: its genomes, its species and its innovation history.
+         * @param stream The output stream.
+         */
+        void write(std::ostream &stream) const;
+
+        /**
+         * @brief Read a population from a binary checkpoint written by write.
+         * @param stream The input stream.
+         * @param config NEAT configuration settings, given to all the genomes.
+         * @return The population read from the stream.
+         * @throws std::runtime_error If the stream is not a checkpoint of a supported version, or is truncated.
+         */
+        static neat::Population *read(std::istream &stream, const Config &config);
+
+        /**
+         * @brief Save a binary checkpoint of the population to a file.
+         * It is written next to the file and renamed once complete, so an interrupted save never leaves a partial checkpoint.
+         * @param filename Name of the checkpoint file.
+         */
+        void save_checkpoint(const std::string &filename) const;
+
+        /**
+         * @brief Load the population from a binary checkpoint file.
+         * @param filename Name of the checkpoint file.
+         * @param config NEAT configuration settings.
+         * @return The loaded population, nullptr if the file can't be read.
+         */
+        static neat::Population *load_checkpoint(const std::string &filename, const Config &config);
     };
 }
 
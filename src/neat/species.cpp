@@ -4,7 +4,10 @@
 #include <algorithm>
 #include <fstream>
 #include <filesystem>
+#include <memory>
 #include "json.hpp"
+#include "binary_io.hpp"
+#include "math_utils.hpp"
 #include "genome.hpp"
 #include "species.hpp"
 
@@ -44,14 +47,16 @@ void neat::Species::add_to_species(Genome *genome)
 }
 
 bool neat::Species::same_species(Genome *genome, const Config &config)
+{
+    return this->same_species(get_excess_disjoint_genes(genome, this->champion), average_weight_diff(genome, this->champion), config);
+}
+
+bool neat::Species::same_species(int excess_and_disjoint, float avg_weight_diff, const Config &config)
 {
     float compatibility_threshold = config.compatibility_threshold;
     float compatibility_disjoint_coefficient = config.compatibility_disjoint_coefficient;
     float compatibility_weight_coefficient = config.compatibility_weight_coefficient;
 
-    int excess_and_disjoint = get_excess_disjoint_genes(genome, this->champion);
-    float avg_weight_diff = average_weight_diff(genome, this->champion);
-
     int large_genome_normalizer = this->genomes.size() - 20;
     if (large_genome_normalizer < 1)
     {
@@ -67,16 +72,25 @@ bool neat::Species::same_species(Genome *genome, const Config &config)
 
 int neat::Species::get_excess_disjoint_genes(Genome *genome1, Genome *genome2)
 {
+    // Merge the genes of the genomes, sorted by innovation number
     int matching = 0;
-    for (auto &g1 : genome1->genes)
+    auto it1 = genome1->genes.begin();
+    auto it2 = genome2->genes.begin();
+    while (it1 != genome1->genes.end() && it2 != genome2->genes.end())
     {
-        for (auto &g2 : genome2->genes)
+        if (it1->innovation_nb < it2->innovation_nb)
         {
-            if (g1->innovation_nb == g2->innovation_nb)
-            {
-                matching++;
-                break;
-            }
+            ++it1;
+        }
+        else if (it2->innovation_nb < it1->innovation_nb)
+        {
+            ++it2;
+        }
+        else
+        {
+            matching++;
+            ++it1;
+            ++it2;
         }
     }
 
@@ -90,18 +104,27 @@ float neat::Species::average_weight_diff(Genome *genome1, Genome *genome2)
         return 0;
     }
 
+    // Merge the genes of the genomes, sorted by innovation number
     int matching = 0;
     float total_diff = 0;
-    for (auto &g1 : genome1->genes)
+    auto it1 = genome1->genes.begin();
+    auto it2 = genome2->genes.begin();
+    while (it1 != genome1->genes.end() && it2 != genome2->genes.end())
     {
-        for (auto &g2 : genome2->genes)
+        if (it1->innovation_nb < it2->innovation_nb)
         {
-            if (g1->innovation_nb == g2->innovation_nb)
-            {
-                matching++;
-                total_diff += std::abs(g1->weight - g2->weight);
-                break;
-            }
+            ++it1;
+        }
+        else if (it2->innovation_nb < it1->innovation_nb)
+        {
+            ++it2;
+        }
+        else
+        {
+            matching++;
+            total_diff += std::abs(it1->weight - it2->weight);
+            ++it1;
+            ++it2;
         }
     }
 
@@ -141,10 +164,10 @@ void neat::Species::set_average_fitness()
     average_fitness = sum / this->genomes.size();
 }
 
-neat::Genome *neat::Species::give_me_baby(std::vector<std::shared_ptr<ConnectionHistory>> innovation_history)
+neat::Genome *neat::Species::give_me_baby(InnovationHistory &innovation_history)
 {
     Genome *baby;
-    if (rand() / static_cast<float>(RAND_MAX) < 0.25)
+    if (randrange() < 0.25)
     {
         baby = select_genome()->clone();
     }
@@ -181,7 +204,7 @@ neat::Genome *neat::Species::select_genome()
     for (size_t i = 0; i < this->genomes.size(); ++i)
     {
         running_sum += this->genomes[i]->fitness;
-        if (running_sum > rand() / static_cast<float>(RAND_MAX) * fitness_sum)
+        if (running_sum > randrange() * fitness_sum)
         {
             return this->genomes[i];
         }
@@ -228,10 +251,10 @@ bool neat::Species::is_equal(Species *other)
                 found = true;
                 break;
             }
-            if (!found)
-            {
-                return false;
-            }
+        }
+        if (!found)
+        {
+            return false;
         }
     }
 
@@ -286,6 +309,52 @@ neat::Species *neat::Species::from_json(const nlohmann::json &json)
 
     return species;
 }
+void neat::Species::write(std::ostream &stream) const
+{
+    write_binary(stream, this->best_fitness);
+    write_binary(stream, this->average_fitness);
+    write_binary(stream, static_cast<int32_t>(this->stagnation));
+
+    write_binary(stream, static_cast<uint8_t>(this->champion != nullptr));
+    if (this->champion != nullptr)
+    {
+        this->champion->write(stream);
+    }
+
+    write_binary(stream, static_cast<uint32_t>(this->genomes.size()));
+    for (const auto &genome : this->genomes)
+    {
+        genome->write(stream);
+    }
+}
+
+neat::Species *neat::Species::read(std::istream &stream)
+{
+    std::unique_ptr<Species> species = std::make_unique<Species>();
+
+    int32_t stagnation;
+    read_binary(stream, species->best_fitness);
+    read_binary(stream, species->average_fitness);
+    read_binary(stream, stagnation);
+    species->stagnation = stagnation;
+
+    uint8_t has_champion;
+    read_binary(stream, has_champion);
+    if (has_champion)
+    {
+        species->champion = Genome::read(stream);
+    }
+
+    uint32_t nb_genomes;
+    read_binary(stream, nb_genomes);
+    for (uint32_t i = 0; i < nb_genomes; ++i)
+    {
+        species->genomes.push_back(Genome::read(stream));
+    }
+
+    return species.release();
+}
+
 void neat::Species::save(const std::string &file_path)
 {
     try
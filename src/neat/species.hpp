@@ -1,10 +1,12 @@
 #ifndef SPECIES_H
 #define SPECIES_H
 
+#include <istream>
+#include <ostream>
 #include <vector>
 #include "genome.hpp"
 #include "config.hpp"
-#include "connection_history.hpp"
+#include "innovation_history.hpp"
 
 namespace neat
 {
@@ -48,9 +50,18 @@ namespace neat
          */
         bool same_species(Genome *genome, const Config &config);
 
+        /**
+         * @brief Checks if a genome belongs to this species from its distance to the champion.
+         * @param excess_and_disjoint The number of excess and disjoint genes between the genome and the champion.
+         * @param avg_weight_diff The average weight difference between the genome and the champion.
+         * @param config NEAT configuration settings.
+         * @return True if the genome is in this species, False otherwise.
+         */
+        bool same_species(int excess_and_disjoint, float avg_weight_diff, const Config &config);
+
         /**
          * @brief Returns the number of excess and disjoint genes between two genomes.
-         * i.e., returns the number of genes which don't match.
+         * i.e., returns the number of genes which don't match. The genes of the genomes are merged in their innovation order.
          * @param genome1 The first genome.
          * @param genome2 The second genome.
          * @return The number of excess and disjoint genes.
@@ -59,6 +70,7 @@ namespace neat
 
         /**
          * @brief Returns the average weight difference between matching genes in two genomes.
+         * The genes of the genomes are merged in their innovation order.
          * @param genome1 The first genome.
          * @param genome2 The second genome.
          * @return The average weight difference.
@@ -77,10 +89,10 @@ namespace neat
 
         /**
          * @brief Gets a baby genome from the genomes in this species.
-         * @param innovation_history List of connection history to track innovations.
+         * @param innovation_history History of the innovations shared by the genomes.
          * @return The baby genome.
          */
-        Genome *give_me_baby(std::vector<std::shared_ptr<ConnectionHistory>> innovation_history);
+        Genome *give_me_baby(InnovationHistory &innovation_history);
 
         /**
          * @brief Selects a genome from the species based on its fitness.
@@ -125,6 +137,20 @@ namespace neat
          */
         static Species *from_json(const nlohmann::json &json);
 
+        /**
+         * @brief Writes the species and its genomes to a binary stream.
+         * @param stream The output stream.
+         */
+        void write(std::ostream &stream) const;
+
+        /**
+         * @brief Reads a species written by write from a binary stream.
+         * @param stream The input stream.
+         * @return Species read from the stream.
+         * @throws std::runtime_error If the stream is truncated or corrupted.
+         */
+        static Species *read(std::istream &stream);
+
         /**
          * @brief Save the species to a file.
          * @param file_path The path to the file.
@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
 #include "../activation_functions.hpp"
 
 TEST(TestActivationFunctions, Step)
@@ -77,3 +79,55 @@ TEST(TestActivationFunctions, Swish)
     ASSERT_NEAR(neat::swish(1), 1 / (1 + std::exp(-1)), 1e-6);
     ASSERT_NEAR(neat::swish(-1), -1 / (1 + std::exp(1)), 1e-6);
 }
+
+TEST(TestActivationFunctions, Names)
+{
+    // The names are only used to read and write the configuration and the genomes
+    for (int i = 0; i < neat::NB_ACTIVATION_FUNCTIONS; ++i)
+    {
+        neat::ActivationFunctionType type = static_cast<neat::ActivationFunctionType>(i);
+        ASSERT_EQ(neat::get_activation_function_type(neat::get_activation_function_name(type)), type);
+    }
+    ASSERT_EQ(neat::get_activation_function_name(neat::ActivationFunctionType::LEAKY_RELU), "leaky_relu");
+    ASSERT_EQ(neat::get_activation_function_type("unknown"), neat::ActivationFunctionType::SIGMOID);
+}
+
+TEST(TestActivationFunctions, FastApproximations)
+{
+    for (double x = -20; x <= 20; x += 0.01)
+    {
+        ASSERT_NEAR(neat::fast_tanh(x), std::tanh(x), 1e-4);
+        ASSERT_NEAR(neat::fast_sigmoid(x), neat::sigmoid(x), 1e-4);
+        ASSERT_NEAR(neat::fast_swish(x), neat::swish(x), 1e-4);
+    }
+
+    // Only the sigmoid, tanh and swish functions are approximated
+    ASSERT_EQ(neat::get_activation_function(neat::ActivationFunctionType::TANH, true), neat::fast_tanh);
+    ASSERT_EQ(neat::get_activation_function(neat::ActivationFunctionType::TANH, false), neat::tanh);
+    ASSERT_EQ(neat::get_activation_function(neat::ActivationFunctionType::RELU, true), neat::relu);
+}
+
+TEST(TestActivationFunctions, BatchActivation)
+{
+    std::vector<double> inputs;
+    for (double x = -10; x <= 10; x += 0.37)
+    {
+        inputs.push_back(x);
+    }
+
+    // The batch activation gives the same values as the scalar one, bit for bit
+    for (bool fast : {false, true})
+    {
+        for (int i = 0; i < neat::NB_ACTIVATION_FUNCTIONS; ++i)
+        {
+            neat::ActivationFunctionType type = static_cast<neat::ActivationFunctionType>(i);
+            std::vector<double> outputs(inputs.size());
+            neat::activate(type, inputs.data(), outputs.data(), inputs.size(), fast);
+
+            for (size_t j = 0; j < inputs.size(); ++j)
+            {
+                ASSERT_EQ(outputs[j], neat::activate(type, inputs[j], fast));
+            }
+        }
+    }
+}
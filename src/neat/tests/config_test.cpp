@@ -42,10 +42,13 @@ TEST_F(ConfigTest, ValidConfigFile)
         fitness_threshold = 100
         no_fitness_termination = true
         reset_on_extinction = true
+        num_threads = 4
+        seed = 42
 
         # GENOME
         activation_default = sigmoid
         activation_mutate_rate = 0.1
+        fast_activations = true
         num_inputs = 10
         num_outputs = 2
         compatibility_disjoint_coefficient = 1.0
@@ -88,8 +91,11 @@ TEST_F(ConfigTest, ValidConfigFile)
     ASSERT_DOUBLE_EQ(config.fitness_threshold, 100);
     ASSERT_TRUE(config.no_fitness_termination);
     ASSERT_TRUE(config.reset_on_extinction);
+    ASSERT_EQ(config.num_threads, 4);
+    ASSERT_EQ(config.seed, 42);
     ASSERT_EQ(config.activation_default, "sigmoid");
     ASSERT_EQ(config.activation_mutate_rate, 0.1);
+    ASSERT_TRUE(config.fast_activations);
     ASSERT_EQ(config.num_inputs, 10);
     ASSERT_EQ(config.num_outputs, 2);
     ASSERT_EQ(config.compatibility_disjoint_coefficient, 1.0);
@@ -4,17 +4,18 @@
 #include <memory>
 #include <algorithm>
 #include <fstream>
+#include <sstream>
 #include "../config.hpp"
 #include "../genome.hpp"
 #include "../connection_gene.hpp"
-#include "../connection_history.hpp"
+#include "../innovation_history.hpp"
 
 class GenomeTest : public testing::Test
 {
 protected:
     // Mock NeatConfig
     neat::Config config;
-    std::vector<std::shared_ptr<neat::ConnectionHistory>> connection_history;
+    neat::InnovationHistory innovation_history;
 
     void SetUp() override
     {
@@ -23,15 +24,6 @@ protected:
         config.num_inputs = 2;
         config.num_outputs = 2;
         config.num_hidden_layers = 1;
-
-        // Set up ConnectionHistory
-        connection_history = {};
-    }
-
-    void TearDown() override
-    {
-        // Clear connection_history after each test
-        connection_history.clear();
     }
 };
 
@@ -53,93 +45,201 @@ TEST_F(GenomeTest, Init)
 TEST_F(GenomeTest, FullyConnect)
 {
     neat::Genome *genome = new neat::Genome(config);
-    genome->fully_connect(connection_history);
+    genome->fully_connect(innovation_history);
 
     // Check if the genes are generated properly
     ASSERT_EQ(genome->genes.size(), 8);
     // From layer 0 to 1
-    ASSERT_EQ(genome->genes[0]->from_node->id, 0);
-    ASSERT_EQ(genome->genes[0]->to_node->id, 2);
-    ASSERT_EQ(genome->genes[1]->from_node->id, 0);
-    ASSERT_EQ(genome->genes[1]->to_node->id, 3);
-    ASSERT_EQ(genome->genes[2]->from_node->id, 1);
-    ASSERT_EQ(genome->genes[2]->to_node->id, 2);
-    ASSERT_EQ(genome->genes[3]->from_node->id, 1);
-    ASSERT_EQ(genome->genes[3]->to_node->id, 3);
+    ASSERT_EQ(genome->nodes[genome->genes[0].from_node].id, 0);
+    ASSERT_EQ(genome->nodes[genome->genes[0].to_node].id, 2);
+    ASSERT_EQ(genome->nodes[genome->genes[1].from_node].id, 0);
+    ASSERT_EQ(genome->nodes[genome->genes[1].to_node].id, 3);
+    ASSERT_EQ(genome->nodes[genome->genes[2].from_node].id, 1);
+    ASSERT_EQ(genome->nodes[genome->genes[2].to_node].id, 2);
+    ASSERT_EQ(genome->nodes[genome->genes[3].from_node].id, 1);
+    ASSERT_EQ(genome->nodes[genome->genes[3].to_node].id, 3);
     // From layer 1 to 2
-    ASSERT_EQ(genome->genes[4]->from_node->id, 2);
-    ASSERT_EQ(genome->genes[4]->to_node->id, 4);
-    ASSERT_EQ(genome->genes[5]->from_node->id, 2);
-    ASSERT_EQ(genome->genes[5]->to_node->id, 5);
-    ASSERT_EQ(genome->genes[6]->from_node->id, 3);
-    ASSERT_EQ(genome->genes[6]->to_node->id, 4);
-    ASSERT_EQ(genome->genes[7]->from_node->id, 3);
-    ASSERT_EQ(genome->genes[7]->to_node->id, 5);
+    ASSERT_EQ(genome->nodes[genome->genes[4].from_node].id, 2);
+    ASSERT_EQ(genome->nodes[genome->genes[4].to_node].id, 4);
+    ASSERT_EQ(genome->nodes[genome->genes[5].from_node].id, 2);
+    ASSERT_EQ(genome->nodes[genome->genes[5].to_node].id, 5);
+    ASSERT_EQ(genome->nodes[genome->genes[6].from_node].id, 3);
+    ASSERT_EQ(genome->nodes[genome->genes[6].to_node].id, 4);
+    ASSERT_EQ(genome->nodes[genome->genes[7].from_node].id, 3);
+    ASSERT_EQ(genome->nodes[genome->genes[7].to_node].id, 5);
 }
 
 TEST_F(GenomeTest, GetNode)
 {
     neat::Genome *genome = new neat::Genome(config);
-    std::shared_ptr<neat::Node> node = genome->get_node(0);
+    int node = genome->get_node(0);
 
-    ASSERT_NE(node, nullptr);
-    ASSERT_EQ(node->id, 0);
+    ASSERT_NE(node, -1);
+    ASSERT_EQ(genome->nodes[node].id, 0);
+    ASSERT_EQ(genome->get_node(100), -1);
+}
+
+TEST_F(GenomeTest, AddGene)
+{
+    neat::Genome *genome = new neat::Genome(config);
+    for (int innovation_nb : {3, 1, 4, 0, 2})
+    {
+        genome->add_gene(neat::ConnectionGene(0, 2, 0.5, innovation_nb, true));
+    }
+
+    // Check the genes are sorted by innovation number
+    ASSERT_EQ(genome->genes.size(), 5);
+    for (int i = 0; i < 5; ++i)
+    {
+        ASSERT_EQ(genome->genes[i].innovation_nb, i);
+    }
+
+    // Check the genes stay sorted after the mutations
+    genome->fully_connect(innovation_history);
+    for (int i = 0; i < 10; ++i)
+    {
+        genome->mutate(innovation_history);
+        genome->add_node(innovation_history);
+    }
+    ASSERT_TRUE(std::is_sorted(genome->genes.begin(), genome->genes.end(), [](const auto &g1, const auto &g2)
+                               { return g1.innovation_nb < g2.innovation_nb; }));
+    delete genome;
 }
 
 TEST_F(GenomeTest, ConnectNodes)
 {
     neat::Genome *genome = new neat::Genome(config);
-    genome->fully_connect(connection_history);
+    genome->fully_connect(innovation_history);
     genome->connect_nodes();
 
     // Check if the connections are set properly
-    ASSERT_EQ(genome->nodes[0]->output_connections.size(), 2);
-    ASSERT_EQ(genome->nodes[1]->output_connections.size(), 2);
-    ASSERT_EQ(genome->nodes[2]->output_connections.size(), 2);
-    ASSERT_EQ(genome->nodes[3]->output_connections.size(), 2);
-    ASSERT_EQ(genome->nodes[4]->output_connections.size(), 0);
-    ASSERT_EQ(genome->nodes[5]->output_connections.size(), 0);
+    ASSERT_EQ(genome->nodes[0].output_connections.size(), 2);
+    ASSERT_EQ(genome->nodes[1].output_connections.size(), 2);
+    ASSERT_EQ(genome->nodes[2].output_connections.size(), 2);
+    ASSERT_EQ(genome->nodes[3].output_connections.size(), 2);
+    ASSERT_EQ(genome->nodes[4].output_connections.size(), 0);
+    ASSERT_EQ(genome->nodes[5].output_connections.size(), 0);
+
+    // Check the connections are the genes of the nodes
+    for (size_t n = 0; n < genome->nodes.size(); ++n)
+    {
+        for (int c : genome->nodes[n].output_connections)
+        {
+            ASSERT_EQ(genome->genes[c].from_node, static_cast<int>(n));
+        }
+    }
+}
+
+TEST_F(GenomeTest, IsConnected)
+{
+    neat::Genome *genome = new neat::Genome(config);
+    genome->add_gene(neat::ConnectionGene(0, 2, 1.0, 1, true));
+
+    // Connected in both directions, not connected without a gene
+    ASSERT_TRUE(genome->is_connected(0, 2));
+    ASSERT_TRUE(genome->is_connected(2, 0));
+    ASSERT_FALSE(genome->is_connected(0, 3));
+    delete genome;
 }
 
 TEST_F(GenomeTest, FeedForward)
 {
     neat::Genome *genome = new neat::Genome(config);
-    genome->fully_connect(connection_history);
+    genome->fully_connect(innovation_history);
 
     std::vector<double> inputValues = {1, 0};
     std::vector<double> outputValues = genome->feed_forward(inputValues);
 
     // Check if the output values are calculated properly
     ASSERT_EQ(outputValues.size(), 2);
-    ASSERT_EQ(outputValues[0], genome->nodes[2]->output_value);
-    ASSERT_EQ(outputValues[1], genome->nodes[3]->output_value);
+    ASSERT_EQ(outputValues[0], genome->nodes[2].output_value);
+    ASSERT_EQ(outputValues[1], genome->nodes[3].output_value);
+}
+
+// Feed forward by engaging the nodes of the genome one by one
+static std::vector<double> feed_forward_nodes(neat::Genome *genome, const std::vector<double> &input_values)
+{
+    for (int i = 0; i < genome->inputs; ++i)
+    {
+        genome->nodes[i].output_value = input_values[i];
+    }
+    for (int n : genome->network)
+    {
+        neat::Node &node = genome->nodes[n];
+        node.activate();
+        for (int c : node.output_connections)
+        {
+            const neat::ConnectionGene &gene = genome->genes[c];
+            if (gene.enabled)
+            {
+                genome->nodes[gene.to_node].input_sum += gene.weight * node.output_value;
+            }
+        }
+    }
+    std::vector<double> outs(genome->outputs, 0.0);
+    for (int i = 0; i < genome->outputs; ++i)
+    {
+        outs[i] = genome->nodes[genome->inputs + i].output_value;
+    }
+    for (auto &n : genome->nodes)
+    {
+        n.input_sum = 0;
+    }
+    return outs;
+}
+
+TEST_F(GenomeTest, FeedForwardCompiled)
+{
+    config.activation_mutate_rate = 0.5;
+    neat::Genome *genome = new neat::Genome(config);
+    genome->fully_connect(innovation_history);
+
+    for (int k = 0; k < 10; ++k)
+    {
+        genome->mutate(innovation_history);
+        genome->add_node(innovation_history);
+        genome->generate_network();
+
+        // Check the outputs are the same as the ones of the nodes, bit for bit
+        for (const auto &input_values : std::vector<std::vector<double>>{{1, 0}, {0.3, -0.7}, {-2.5, 4.2}})
+        {
+            std::vector<double> outputs = genome->feed_forward(input_values);
+            ASSERT_NE(genome->compiled_network, nullptr);
+            ASSERT_EQ(outputs, feed_forward_nodes(genome, input_values));
+        }
+    }
+
+    // Check the network is compiled again after a change of the genome
+    genome->mutate(innovation_history);
+    ASSERT_EQ(genome->compiled_network, nullptr);
+    delete genome;
 }
 
 TEST_F(GenomeTest, GenerateNetwork)
 {
     neat::Genome *genome = new neat::Genome(config);
-    genome->fully_connect(connection_history);
+    genome->fully_connect(innovation_history);
     genome->generate_network();
 
     // Check if the network is generated properly
     ASSERT_EQ(genome->network.size(), 6);
     // 2 input nodes + 2 output nodes
-    ASSERT_EQ(genome->network[0]->id, 0); // First input node
-    ASSERT_EQ(genome->network[1]->id, 1); // Second input node
-    ASSERT_EQ(genome->network[2]->id, 2); // First node in the hidden layer
-    ASSERT_EQ(genome->network[3]->id, 3); // Second node in the hidden layer
-    ASSERT_EQ(genome->network[4]->id, 4); // First output node
-    ASSERT_EQ(genome->network[5]->id, 5); // Second output node
+    ASSERT_EQ(genome->nodes[genome->network[0]].id, 0); // First input node
+    ASSERT_EQ(genome->nodes[genome->network[1]].id, 1); // Second input node
+    ASSERT_EQ(genome->nodes[genome->network[2]].id, 2); // First node in the hidden layer
+    ASSERT_EQ(genome->nodes[genome->network[3]].id, 3); // Second node in the hidden layer
+    ASSERT_EQ(genome->nodes[genome->network[4]].id, 4); // First output node
+    ASSERT_EQ(genome->nodes[genome->network[5]].id, 5); // Second output node
 }
 
 TEST_F(GenomeTest, AddNode)
 {
     neat::Genome *genome = new neat::Genome(config);
-    genome->fully_connect(connection_history);
+    genome->fully_connect(innovation_history);
     const size_t initialNumGenes = genome->genes.size();
     const size_t initialNumNodes = genome->nodes.size();
 
-    genome->add_node(connection_history);
+    genome->add_node(innovation_history);
 
     // Check if a new node and connections are added properly
     // 1 new connection + 2 existing connections
@@ -151,8 +251,8 @@ TEST_F(GenomeTest, AddNode)
 TEST_F(GenomeTest, RemoveNode)
 {
     neat::Genome *genome = new neat::Genome(config);
-    genome->fully_connect(connection_history);
-    genome->add_node(connection_history);
+    genome->fully_connect(innovation_history);
+    genome->add_node(innovation_history);
     const size_t initialNumGenes = genome->genes.size();
     const size_t initialNumNodes = genome->nodes.size();
 
@@ -170,7 +270,7 @@ TEST_F(GenomeTest, AddConnection)
     neat::Genome *genome = new neat::Genome(config);
     const size_t initialNumGenes = genome->genes.size();
 
-    genome->add_connection(connection_history);
+    genome->add_connection(innovation_history);
 
     // Check if a new connection is added properly
     ASSERT_EQ(genome->genes.size(), initialNumGenes + 1);
@@ -179,7 +279,7 @@ TEST_F(GenomeTest, AddConnection)
 TEST_F(GenomeTest, RemoveConnection)
 {
     neat::Genome *genome = new neat::Genome(config);
-    genome->fully_connect(connection_history);
+    genome->fully_connect(innovation_history);
     const size_t initialNumGenes = genome->genes.size();
 
     genome->remove_connection();
@@ -202,18 +302,24 @@ TEST_F(GenomeTest, NewConnectionWeight)
 TEST_F(GenomeTest, GetInnovationNumber)
 {
     neat::Genome *genome = new neat::Genome(config);
-    std::shared_ptr<neat::Node> fromNode = std::make_shared<neat::Node>(0, "sigmoid", 0);
-    std::shared_ptr<neat::Node> toNode = std::make_shared<neat::Node>(2, "sigmoid", 1);
-    int innovationNumber = genome->get_innovation_number(connection_history, fromNode, toNode);
+    int fromNode = 0;
+    int toNode = 2;
+    int innovationNumber = genome->get_innovation_number(innovation_history, fromNode, toNode);
 
     // Check if the innovation number is obtained properly
     ASSERT_EQ(typeid(innovationNumber), typeid(int));
+    ASSERT_EQ(innovation_history.size(), 1);
+
+    // Check the same connection gets the same number and a new connection a new number
+    ASSERT_EQ(genome->get_innovation_number(innovation_history, fromNode, toNode), innovationNumber);
+    ASSERT_NE(genome->get_innovation_number(innovation_history, toNode, fromNode), innovationNumber);
+    ASSERT_EQ(innovation_history.size(), 2);
 }
 
 TEST_F(GenomeTest, FullyConnected)
 {
     neat::Genome *genome = new neat::Genome(config);
-    genome->fully_connect(connection_history);
+    genome->fully_connect(innovation_history);
 
     // Check if the genome is considered fully connected
     ASSERT_TRUE(genome->fully_connected());
@@ -225,7 +331,7 @@ TEST_F(GenomeTest, Mutate)
     int initialNumGenes = genome->genes.size();
     int initialNumNodes = genome->genes.size();
 
-    genome->mutate(connection_history);
+    genome->mutate(innovation_history);
 
     // Check if mutations are applied properly
     // Mutations may add new genes
@@ -238,8 +344,8 @@ TEST_F(GenomeTest, Crossover)
 {
     neat::Genome *parent1 = new neat::Genome(config);
     neat::Genome *parent2 = new neat::Genome(config);
-    parent1->fully_connect(connection_history);
-    parent2->fully_connect(connection_history);
+    parent1->fully_connect(innovation_history);
+    parent2->fully_connect(innovation_history);
     parent1->fitness = 1;
     parent2->fitness = 0.5;
 
@@ -254,12 +360,12 @@ TEST_F(GenomeTest, Crossover)
 TEST_F(GenomeTest, MatchingGene)
 {
     neat::Genome *genome = new neat::Genome(config);
-    genome->fully_connect(connection_history);
+    genome->fully_connect(innovation_history);
 
-    std::sort(genome->genes.begin(), genome->genes.end(), [](const std::shared_ptr<neat::ConnectionGene> g1, const std::shared_ptr<neat::ConnectionGene> g2)
-              { return g1->innovation_nb < g2->innovation_nb; });
+    std::sort(genome->genes.begin(), genome->genes.end(), [](const neat::ConnectionGene &g1, const neat::ConnectionGene &g2)
+              { return g1.innovation_nb < g2.innovation_nb; });
 
-    int matchingGeneIndex = genome->matching_gene(genome, genome->genes[0]->innovation_nb);
+    int matchingGeneIndex = genome->matching_gene(genome, genome->genes[0].innovation_nb);
 
     // Check if matching gene is found properly
     ASSERT_EQ(matchingGeneIndex, 0);
@@ -268,7 +374,7 @@ TEST_F(GenomeTest, MatchingGene)
 TEST_F(GenomeTest, CloneTest)
 {
     neat::Genome *genome = new neat::Genome(config);
-    genome->fully_connect(connection_history);
+    genome->fully_connect(innovation_history);
     neat::Genome *clone = genome->clone();
 
     // Check if cloning the genome produces a valid clone
@@ -276,12 +382,42 @@ TEST_F(GenomeTest, CloneTest)
     ASSERT_NE(&clone, &genome);
     ASSERT_EQ(clone->genes.size(), genome->genes.size());
     ASSERT_EQ(clone->nodes.size(), genome->nodes.size());
+    ASSERT_TRUE(clone->is_equal(genome));
+
+    // The clone does not share its genes with the genome
+    clone->genes[0].weight += 1;
+    ASSERT_FALSE(clone->is_equal(genome));
+}
+
+TEST_F(GenomeTest, Hash)
+{
+    neat::Genome *genome = new neat::Genome(config);
+    genome->fully_connect(innovation_history);
+
+    // A clone has the same content, so the same hash
+    neat::Genome *clone = genome->clone();
+    clone->fitness = 10;
+    ASSERT_EQ(clone->hash(), genome->hash());
+
+    // A change of weight, of activation function or of structure changes the hash
+    clone->genes[0].weight += 0.5;
+    ASSERT_NE(clone->hash(), genome->hash());
+    clone->genes[0].weight = genome->genes[0].weight;
+    clone->nodes[2].activation_function = genome->nodes[2].activation_function == neat::ActivationFunctionType::RELU ? neat::ActivationFunctionType::TANH : neat::ActivationFunctionType::RELU;
+    ASSERT_NE(clone->hash(), genome->hash());
+    clone->nodes[2].activation_function = genome->nodes[2].activation_function;
+    ASSERT_EQ(clone->hash(), genome->hash());
+    clone->add_node(innovation_history);
+    ASSERT_NE(clone->hash(), genome->hash());
+
+    delete genome;
+    delete clone;
 }
 
 TEST_F(GenomeTest, JSON)
 {
     neat::Genome *genome = new neat::Genome(config);
-    genome->fully_connect(connection_history);
+    genome->fully_connect(innovation_history);
 
     // Convert the genome to a JSON object
     nlohmann::json genomeJson = genome->to_json();
@@ -306,10 +442,39 @@ TEST_F(GenomeTest, JSON)
     ASSERT_TRUE(newGenome->is_equal(genome));
 }
 
+TEST_F(GenomeTest, Binary)
+{
+    neat::Genome *genome = new neat::Genome(config);
+    genome->fully_connect(innovation_history);
+    genome->add_node(innovation_history);
+    genome->genes[0].enabled = false;
+    genome->fitness = 0.75;
+    genome->generate_network();
+
+    // Write the genome to a binary stream and read it back
+    std::stringstream stream;
+    genome->write(stream);
+    neat::Genome *newGenome = neat::Genome::read(stream);
+
+    // Check if the new genome is the same
+    ASSERT_NE(newGenome, genome);
+    ASSERT_TRUE(newGenome->is_equal(genome));
+    ASSERT_EQ(newGenome->id, genome->id);
+    ASSERT_EQ(newGenome->fitness, genome->fitness);
+    ASSERT_EQ(newGenome->next_node, genome->next_node);
+    ASSERT_EQ(newGenome->hash(), genome->hash());
+    ASSERT_EQ(newGenome->network, genome->network);
+
+    // A truncated stream is rejected
+    std::string data = stream.str();
+    std::stringstream truncated_stream(data.substr(0, data.size() / 2));
+    ASSERT_THROW(neat::Genome::read(truncated_stream), std::runtime_error);
+}
+
 TEST_F(GenomeTest, SaveLoadTest)
 {
     neat::Genome *genome = new neat::Genome(config);
-    genome->fully_connect(connection_history);
+    genome->fully_connect(innovation_history);
 
     // Create a temporary directory for testing
     std::string tempDir = "./temp"; // Replace with the actual path
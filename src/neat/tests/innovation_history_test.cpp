@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "../innovation_history.hpp"
+
+TEST(InnovationHistoryTest, GetInnovationNumber)
+{
+    neat::InnovationHistory history;
+    ASSERT_EQ(history.size(), 0);
+
+    // A new connection gets a new number
+    int innovation_nb = history.get_innovation_number(1, 2);
+    ASSERT_EQ(history.size(), 1);
+    ASSERT_NE(history.get_innovation_number(2, 1), innovation_nb);
+    ASSERT_NE(history.get_innovation_number(1, 3), innovation_nb);
+    ASSERT_EQ(history.size(), 3);
+
+    // The same connection gets the same number
+    ASSERT_EQ(history.get_innovation_number(1, 2), innovation_nb);
+    ASSERT_EQ(history.size(), 3);
+
+    // Another history never gives the same number to a new connection
+    neat::InnovationHistory other;
+    ASSERT_NE(other.get_innovation_number(1, 2), innovation_nb);
+}
+
+TEST(InnovationHistoryTest, Copy)
+{
+    neat::InnovationHistory history;
+    int innovation_nb = history.get_innovation_number(1, 2);
+
+    neat::InnovationHistory copy = history;
+    ASSERT_EQ(copy.size(), 1);
+    ASSERT_EQ(copy.get_innovation_number(1, 2), innovation_nb);
+}
+
+TEST(InnovationHistoryTest, Threads)
+{
+    neat::InnovationHistory history;
+
+    // The threads get the same numbers for the same connections
+    std::vector<std::vector<int>> numbers(4, std::vector<int>(100));
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numbers.size(); ++t)
+    {
+        threads.emplace_back([&, t]()
+                             { for (int i = 0; i < 100; ++i) { numbers[t][i] = history.get_innovation_number(i, i + 1); } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(history.size(), 100);
+    for (size_t t = 1; t < numbers.size(); ++t)
+    {
+        ASSERT_EQ(numbers[t], numbers[0]);
+    }
+}
+
+TEST(InnovationHistoryTest, JSON)
+{
+    neat::InnovationHistory history;
+    int innovation_nb = history.get_innovation_number(1, 2);
+    history.get_innovation_number(3, 4);
+
+    nlohmann::json json = history.to_json();
+    ASSERT_EQ(json.size(), 2);
+
+    neat::InnovationHistory loaded = neat::InnovationHistory::from_json(json);
+    ASSERT_EQ(loaded.size(), 2);
+    ASSERT_EQ(loaded.get_innovation_number(1, 2), innovation_nb);
+
+    // The new numbers come after the loaded ones
+    ASSERT_GT(loaded.get_innovation_number(5, 6), innovation_nb + 1);
+}
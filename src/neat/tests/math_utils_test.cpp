@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include <cmath>
+#include <thread>
+#include <vector>
 #include "../math_utils.hpp"
 
 // Test cases for randrange function
@@ -43,4 +45,31 @@ TEST(MathUtilsTest, Normal)
     stdev = 3.0;
     result = neat::normal(mean, stdev);
     ASSERT_TRUE(std::isfinite(result));
-}
\ No newline at end of file
+}
+// Test cases for seed_random_generator function
+TEST(MathUtilsTest, SeedRandomGenerator)
+{
+    // The values drawn after seeding only depend on the seed and the stream
+    neat::seed_random_generator(42, 7);
+    std::vector<double> values;
+    for (int i = 0; i < 10; ++i)
+    {
+        values.push_back(neat::randrange());
+    }
+
+    std::vector<double> thread_values;
+    std::thread thread([&]()
+                       {
+                           neat::seed_random_generator(42, 7);
+                           for (int i = 0; i < 10; ++i)
+                           {
+                               thread_values.push_back(neat::randrange());
+                           } });
+    thread.join();
+    ASSERT_EQ(values, thread_values);
+
+    // A master seed of 0 leaves the generator unchanged
+    neat::seed_random_generator(42, 7);
+    neat::seed_random_generator(0, 7);
+    ASSERT_EQ(neat::randrange(), values[0]);
+}
@@ -2,6 +2,8 @@
 #include <gmock/gmock.h>
 #include <vector>
 #include <random>
+#include <sstream>
+#include <filesystem>
 #include "../config.hpp"
 #include "../population.hpp"
 
@@ -94,6 +96,31 @@ TEST_F(PopulationTest, ReproduceSpecies)
     ASSERT_EQ(p->genomes.size(), config.population_size);
 }
 
+TEST_F(PopulationTest, RunLockstep)
+{
+    neat::Population *p = new neat::Population(config);
+
+    // Evaluate all the genomes of a generation in a single call
+    int nb_calls = 0;
+    auto evaluate_genomes = [&](const std::vector<neat::Genome *> &genomes, int generation)
+    {
+        ASSERT_EQ(genomes, p->genomes);
+        ASSERT_EQ(generation, nb_calls);
+        for (auto &g : genomes)
+        {
+            g->fitness = 1 + generation;
+        }
+        nb_calls++;
+    };
+
+    p->run_lockstep(evaluate_genomes, 3);
+
+    // Assert that the generations are evaluated and evolved
+    ASSERT_EQ(nb_calls, 3);
+    ASSERT_EQ(p->generation, 3);
+    ASSERT_GT(p->best_fitness, 0);
+}
+
 TEST_F(PopulationTest, SortSpecies)
 {
     neat::Population *p = new neat::Population(config);
@@ -241,6 +268,44 @@ TEST_F(PopulationTest, UpdateSpecies)
     ASSERT_EQ(updatedGenomes.size(), config.min_species_size);
 }
 
+TEST_F(PopulationTest, AddImmigrants)
+{
+    neat::Population *p = new neat::Population(config);
+    neat::Population *other = new neat::Population(config);
+
+    // The immigrants come from another population, with another history of innovations, and are read from JSON like the migrations
+    std::vector<neat::Genome *> immigrants;
+    for (int i = 0; i < 3; ++i)
+    {
+        neat::Genome *genome = other->genomes[i]->clone();
+        genome->add_node(other->innovation_history);
+        immigrants.push_back(neat::Genome::from_json(genome->to_json()));
+        delete genome;
+    }
+    p->add_immigrants(immigrants);
+
+    // The immigrants replace the last genomes, their innovation numbers come from the history of the population
+    ASSERT_EQ(p->genomes.size(), config.population_size);
+    for (int i = 0; i < 3; ++i)
+    {
+        neat::Genome *immigrant = p->genomes[config.population_size - 1 - i];
+        ASSERT_EQ(immigrant, immigrants[i]);
+        ASSERT_FALSE(immigrant->network.empty());
+
+        // The immigrants get the configuration of the population
+        ASSERT_EQ(immigrant->config.population_size, config.population_size);
+        ASSERT_EQ(immigrant->config.weight_mutate_rate, config.weight_mutate_rate);
+        ASSERT_EQ(immigrant->config.num_hidden_layers, config.num_hidden_layers);
+        ASSERT_EQ(immigrant->config.fast_activations, config.fast_activations);
+        for (const auto &gene : immigrant->genes)
+        {
+            ASSERT_EQ(gene.innovation_nb, p->innovation_history.get_innovation_number(immigrant->nodes[gene.from_node].id, immigrant->nodes[gene.to_node].id));
+        }
+        ASSERT_TRUE(std::is_sorted(immigrant->genes.begin(), immigrant->genes.end(), [](const auto &g1, const auto &g2)
+                                   { return g1.innovation_nb < g2.innovation_nb; }));
+    }
+}
+
 TEST_F(PopulationTest, Clone)
 {
     neat::Population *population = new neat::Population(config);
@@ -305,6 +370,8 @@ TEST_F(PopulationTest, SaveAndLoad)
     ASSERT_EQ(loadedPopulation->generation, population->generation);
     ASSERT_EQ(loadedPopulation->genomes.size(), population->genomes.size());
     ASSERT_EQ(loadedPopulation->species.size(), population->species.size());
+    ASSERT_EQ(loadedPopulation->innovation_history.size(), population->innovation_history.size());
+    ASSERT_GT(loadedPopulation->innovation_history.size(), 0);
 
     // Check if the loaded best genome is valid
     if (population->best_genome != nullptr)
@@ -326,4 +393,95 @@ TEST_F(PopulationTest, SaveAndLoad)
 
     // Remove the temporary directory
     std::filesystem::remove_all(tempDir);
-}
\ No newline at end of file
+}
+TEST_F(PopulationTest, Checkpoint)
+{
+    // Create a population with species and a best genome
+    neat::Population *population = new neat::Population(this->config);
+    population->speciate();
+    population->best_genome = population->genomes[0];
+    population->generation = 3;
+    population->best_fitness = 0.5;
+    population->average_fitness = 0.25;
+
+    // Save the checkpoint of the population
+    std::string tempDir = "./temp";
+    std::string filePath = tempDir + "/test_population.bin";
+    population->save_checkpoint(filePath);
+
+    ASSERT_TRUE(std::filesystem::exists(filePath));
+    ASSERT_FALSE(std::filesystem::exists(filePath + ".tmp"));
+
+    // Load the checkpoint
+    neat::Population *loadedPopulation = neat::Population::load_checkpoint(filePath, this->config);
+
+    ASSERT_NE(loadedPopulation, nullptr);
+    ASSERT_EQ(loadedPopulation->generation, population->generation);
+    ASSERT_EQ(loadedPopulation->best_fitness, population->best_fitness);
+    ASSERT_EQ(loadedPopulation->average_fitness, population->average_fitness);
+    ASSERT_EQ(loadedPopulation->innovation_history.size(), population->innovation_history.size());
+    ASSERT_TRUE(loadedPopulation->best_genome->is_equal(population->best_genome));
+
+    ASSERT_EQ(loadedPopulation->genomes.size(), population->genomes.size());
+    for (size_t i = 0; i < loadedPopulation->genomes.size(); ++i)
+    {
+        ASSERT_TRUE(loadedPopulation->genomes[i]->is_equal(population->genomes[i]));
+        ASSERT_EQ(loadedPopulation->genomes[i]->config.population_size, this->config.population_size);
+    }
+
+    ASSERT_EQ(loadedPopulation->species.size(), population->species.size());
+    for (size_t i = 0; i < loadedPopulation->species.size(); ++i)
+    {
+        ASSERT_TRUE(loadedPopulation->species[i]->is_equal(population->species[i]));
+    }
+
+    // The checkpoint is smaller than the JSON save
+    std::string jsonPath = tempDir + "/test_population.json";
+    population->save(jsonPath);
+    ASSERT_LT(std::filesystem::file_size(filePath), std::filesystem::file_size(jsonPath));
+
+    // A stream which is not a checkpoint is rejected
+    std::stringstream stream("not a checkpoint");
+    ASSERT_THROW(neat::Population::read(stream, this->config), std::runtime_error);
+    ASSERT_EQ(neat::Population::load_checkpoint(jsonPath, this->config), nullptr);
+
+    // Remove the temporary directory
+    std::filesystem::remove_all(tempDir);
+}
+
+TEST_F(PopulationTest, Seed)
+{
+    // Run a population and describe its genomes, without the innovation numbers shared by all the populations of the process
+    auto run_population = [&](uint64_t seed)
+    {
+        config.seed = seed;
+        neat::Population *p = new neat::Population(config);
+        p->run([](neat::Genome *genome, int generation)
+               {
+                   genome->fitness = 1;
+                   for (const auto &gene : genome->genes)
+                   {
+                       genome->fitness += std::abs(gene.weight);
+                   } },
+               3);
+
+        std::vector<std::string> description;
+        for (const auto &g : p->genomes)
+        {
+            std::string genome_description = g->id;
+            for (const auto &gene : g->genes)
+            {
+                genome_description += " " + std::to_string(g->nodes[gene.from_node].id) + "-" + std::to_string(g->nodes[gene.to_node].id) + ":" + std::to_string(gene.weight) + (gene.enabled ? "" : "x");
+            }
+            description.push_back(genome_description);
+        }
+        return description;
+    };
+
+    // The runs with the same seed are identical
+    std::vector<std::string> run1 = run_population(42);
+    std::vector<std::string> run2 = run_population(42);
+    std::vector<std::string> run3 = run_population(43);
+    ASSERT_EQ(run1, run2);
+    ASSERT_NE(run1, run3);
+}
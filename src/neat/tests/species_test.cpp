@@ -9,7 +9,7 @@ class SpeciesTest : public testing::Test
 protected:
     neat::Config config;
     neat::Genome *genome;
-    std::vector<std::shared_ptr<neat::ConnectionHistory>> connection_history;
+    neat::InnovationHistory innovation_history;
     neat::Species *species;
 
     void SetUp() override
@@ -19,8 +19,7 @@ protected:
         config.num_outputs = 2;
 
         genome = new neat::Genome(config);
-        connection_history = init_connection_history(10, 2);
-        genome->fully_connect(connection_history);
+        genome->fully_connect(innovation_history);
 
         species = new neat::Species(genome);
     }
@@ -29,26 +28,6 @@ protected:
     {
         delete species;
     }
-
-    std::vector<std::shared_ptr<neat::ConnectionHistory>> init_connection_history(int num_inputs, int num_outputs)
-    {
-        std::vector<std::shared_ptr<neat::ConnectionHistory>> connections;
-        int innovation_nb = 0;
-        std::vector<int> innovation_nbs(num_inputs * num_outputs + 1);
-
-        for (int i = 0; i < num_inputs; ++i)
-        {
-            std::shared_ptr<neat::Node> node_input = std::make_shared<neat::Node>(i, "relu", 0);
-            for (int j = 0; j < num_outputs; ++j)
-            {
-                std::shared_ptr<neat::Node> node_output = std::make_shared<neat::Node>(j, "sigmoid", 1);
-                connections.push_back(std::make_shared<neat::ConnectionHistory>(node_input, node_output, innovation_nb));
-                ++innovation_nb;
-            }
-        }
-
-        return connections;
-    }
 };
 
 TEST_F(SpeciesTest, Init)
@@ -74,8 +53,8 @@ TEST_F(SpeciesTest, SameSpeciesFalse)
     otherConfig.num_outputs = 1;
 
     neat::Genome *otherGenome = new neat::Genome(otherConfig);
-    std::vector<std::shared_ptr<neat::ConnectionHistory>> otherConnectionHistory = init_connection_history(5, 1);
-    otherGenome->fully_connect(otherConnectionHistory);
+    neat::InnovationHistory otherInnovationHistory;
+    otherGenome->fully_connect(otherInnovationHistory);
 
     ASSERT_FALSE(species->same_species(otherGenome, config));
 
@@ -101,8 +80,8 @@ TEST_F(SpeciesTest, ExcessDisjointGenes)
 
     // Test with two totally different genomes
     neat::Genome *otherGenomeDifferent = new neat::Genome(config);
-    std::vector<std::shared_ptr<neat::ConnectionHistory>> otherConnectionHistoryDifferent = init_connection_history(10, 2);
-    otherGenomeDifferent->fully_connect(otherConnectionHistoryDifferent);
+    neat::InnovationHistory otherInnovationHistoryDifferent;
+    otherGenomeDifferent->fully_connect(otherInnovationHistoryDifferent);
     double resultDifferent = species->get_excess_disjoint_genes(genome, otherGenomeDifferent);
     ASSERT_GT(resultDifferent, 0.0);
     delete otherGenomeDifferent;
@@ -125,8 +104,8 @@ TEST_F(SpeciesTest, AverageWeightDifference)
 
     // Test average weight diff of two totally different genomes
     neat::Genome *otherGenomeDifferent = new neat::Genome(config);
-    std::vector<std::shared_ptr<neat::ConnectionHistory>> otherConnectionHistoryDifferent = init_connection_history(10, 2);
-    otherGenomeDifferent->fully_connect(otherConnectionHistoryDifferent);
+    neat::InnovationHistory otherInnovationHistoryDifferent;
+    otherGenomeDifferent->fully_connect(otherInnovationHistoryDifferent);
     double resultDifferent = species->average_weight_diff(genome, otherGenomeDifferent);
     ASSERT_DOUBLE_EQ(resultDifferent, 100.0);
     delete otherGenomeDifferent;
@@ -140,9 +119,8 @@ TEST_F(SpeciesTest, AverageWeightDifference)
     // Test average weight diff with two genomes a little bit different
     neat::Genome *otherGenomeLittleDifferent = genome->clone();
     otherGenomeLittleDifferent->config.weight_mutate_rate = 1.0;
-    std::vector<std::shared_ptr<neat::ConnectionHistory>>
-        otherGenomeLittleDifferentHistory = init_connection_history(10, 2);
-    otherGenomeLittleDifferent->mutate(otherGenomeLittleDifferentHistory);
+    neat::InnovationHistory otherInnovationHistoryLittleDifferent;
+    otherGenomeLittleDifferent->mutate(otherInnovationHistoryLittleDifferent);
     double resultLittleDifferent = species->average_weight_diff(genome, otherGenomeLittleDifferent);
     ASSERT_GT(resultLittleDifferent, 0.0);
     delete otherGenomeLittleDifferent;
@@ -197,7 +175,7 @@ TEST_F(SpeciesTest, GiveMeBaby)
     neat::Genome *mockGenome = new neat::Genome(config);
 
     // Call the function to generate a baby genome
-    neat::Genome *babyGenome = species->give_me_baby(connection_history);
+    neat::Genome *babyGenome = species->give_me_baby(innovation_history);
 
     // Assert that the result is a valid genome
     ASSERT_TRUE(babyGenome != nullptr);
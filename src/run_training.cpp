@@ -7,7 +7,7 @@ int main(int argc, char *argv[])
 {
     if (argc < 3)
     {
-        std::cerr << "Usage: " << argv[0] << " <id> <config_file_path> [--debug]" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <id> <config_file_path> [--debug] [--islands <nb_islands>] [--export-json]" << std::endl;
         return 1;
     }
 
@@ -21,10 +21,50 @@ int main(int argc, char *argv[])
         config_file_path = config_file_path.substr(1, config_file_path.size() - 2);
     }
 
-    // Check for the debug flag.
-    bool debug = (argc > 3 && std::string(argv[3]) == "--debug");
+    // Check for the options.
+    bool debug = false;
+    int nb_islands = 0;
+    int island = -1;
+    bool export_json = false;
+    for (int i = 3; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        if (option == "--debug")
+        {
+            debug = true;
+        }
+        else if (option == "--islands" && i + 1 < argc)
+        {
+            nb_islands = std::stoi(argv[++i]);
+        }
+        else if (option == "--export-json")
+        {
+            export_json = true;
+        }
+        else if (option == "--island" && i + 1 < argc)
+        {
+            // Used by the coordinator to start the process of an island
+            island = std::stoi(argv[++i]);
+        }
+    }
+
+    // Export the saved population of the training to JSON, without training it.
+    if (export_json)
+    {
+        Training training(id, config_file_path, debug, island);
+        training.export_population(training.directory / "population_export.json");
+        return 0;
+    }
+
+    // The coordinator prepares the data shared by the islands and runs them in their own processes.
+    if (nb_islands > 0)
+    {
+        Training training(id, config_file_path, debug, -1, true);
+        training.prepare();
+        return training.run_islands(nb_islands, argv[0]);
+    }
 
-    Training training(id, config_file_path, debug);
+    Training training(id, config_file_path, debug, island);
     training.prepare();
     training.run();
     return 0;
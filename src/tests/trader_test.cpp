@@ -161,6 +161,24 @@ TEST_F(TraderTest, UpdateWithPosition)
     ASSERT_EQ(trader->nb_trades_today, 0);
 }
 
+TEST_F(TraderTest, UpdateWithViews)
+{
+    std::vector<Candle> timeline = {
+        Candle{.date = date, .close = 1.0},
+        Candle{.date = date + 15 * 60, .close = 1.1},
+    };
+    trader->candles = {};
+
+    // Call the update method with a view of the shared timeline
+    trader->update(CandlesViews{{TimeFrame::M15, CandlesView(timeline, 0, 2)}});
+
+    // Check the trader reads the candles through the view without copying them
+    ASSERT_TRUE(trader->candles.empty());
+    ASSERT_EQ(trader->current_date, date + 15 * 60);
+    ASSERT_EQ(&trader->get_candles(TimeFrame::M15).back(), &timeline[1]);
+    ASSERT_TRUE(trader->get_candles(TimeFrame::H1).empty());
+}
+
 TEST_F(TraderTest, UpdateWithNewDay)
 {
     // Mock data for testing
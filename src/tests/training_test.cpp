@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <stdexcept>
 #include "../configs/serialization.hpp"
 #include "../neat/genome.hpp"
 #include "../utils/time_frame.hpp"
@@ -187,23 +188,28 @@ TEST_F(TrainingTest, LoadCandles)
     {
         time_t date = training->dates[i];
 
-        ASSERT_TRUE(training->candles.find(date) != training->candles.end());
+        ASSERT_TRUE(training->candles_windows.find(date) != training->candles_windows.end());
 
-        ASSERT_TRUE(training->candles[date].find(TimeFrame::M15) != training->candles[date].end());
-        ASSERT_TRUE(training->candles[date].find(TimeFrame::M30) != training->candles[date].end());
-        ASSERT_TRUE(training->candles[date].find(TimeFrame::H1) != training->candles[date].end());
+        ASSERT_TRUE(training->candles_windows[date].find(TimeFrame::M15) != training->candles_windows[date].end());
+        ASSERT_TRUE(training->candles_windows[date].find(TimeFrame::M30) != training->candles_windows[date].end());
+        ASSERT_TRUE(training->candles_windows[date].find(TimeFrame::H1) != training->candles_windows[date].end());
 
-        ASSERT_FALSE(training->candles[date][TimeFrame::M15].empty());
-        ASSERT_FALSE(training->candles[date][TimeFrame::M30].empty());
-        ASSERT_FALSE(training->candles[date][TimeFrame::H1].empty());
+        ASSERT_FALSE(training->candles_windows[date][TimeFrame::M15].empty());
+        ASSERT_FALSE(training->candles_windows[date][TimeFrame::M30].empty());
+        ASSERT_FALSE(training->candles_windows[date][TimeFrame::H1].empty());
 
-        ASSERT_EQ(training->candles[date][TimeFrame::M15].back().date, date);
-        ASSERT_LE(training->candles[date][TimeFrame::M30].back().date, date);
-        ASSERT_LE(training->candles[date][TimeFrame::H1].back().date, date);
+        ASSERT_EQ(training->candles_windows[date][TimeFrame::M15].back().date, date);
+        ASSERT_LE(training->candles_windows[date][TimeFrame::M30].back().date, date);
+        ASSERT_LE(training->candles_windows[date][TimeFrame::H1].back().date, date);
 
-        ASSERT_EQ(training->candles[date][TimeFrame::M15].size(), CANDLES_WINDOW);
-        ASSERT_EQ(training->candles[date][TimeFrame::M30].size(), CANDLES_WINDOW);
-        ASSERT_EQ(training->candles[date][TimeFrame::H1].size(), CANDLES_WINDOW);
+        ASSERT_EQ(training->candles_windows[date][TimeFrame::M15].size(), CANDLES_WINDOW);
+        ASSERT_EQ(training->candles_windows[date][TimeFrame::M30].size(), CANDLES_WINDOW);
+        ASSERT_EQ(training->candles_windows[date][TimeFrame::H1].size(), CANDLES_WINDOW);
+
+        // The windows are views of the timelines, the candles are not copied
+        ASSERT_EQ(training->candles_windows[date][TimeFrame::M15].timeline, training->candles[TimeFrame::M15].data());
+        ASSERT_EQ(training->candles_windows[date][TimeFrame::M30].timeline, training->candles[TimeFrame::M30].data());
+        ASSERT_EQ(training->candles_windows[date][TimeFrame::H1].timeline, training->candles[TimeFrame::H1].data());
     }
 }
 
@@ -235,6 +241,35 @@ TEST_F(TrainingTest, LoadIndicators)
     }
 }
 
+TEST_F(TrainingTest, LoadIndicatorsPrecomputed)
+{
+    training->config.training.precompute_indicators = true;
+    training->load_candles();
+    training->load_indicators();
+
+    ASSERT_EQ(training->indicators.size(), training->dates.size());
+
+    for (const auto &[date, indicators_data] : training->indicators)
+    {
+        ASSERT_EQ(indicators_data.size(), 3);
+        for (const auto &[tf, data] : indicators_data)
+        {
+            ASSERT_EQ(data.size(), 2);
+            for (const auto &[id, values] : data)
+            {
+                ASSERT_EQ(values.size(), INDICATOR_WINDOW);
+            }
+
+            // The values are normalized on the window of the date
+            for (const auto &value : data.at("rsi"))
+            {
+                ASSERT_GE(value, 0.0);
+                ASSERT_LE(value, 1.0);
+            }
+        }
+    }
+}
+
 TEST_F(TrainingTest, LoadBaseCurrencyConversionRate)
 {
     training->load_candles();
@@ -251,7 +286,7 @@ TEST_F(TrainingTest, CacheData)
 
     TimeFrame loop_timeframe = config.strategy.timeframe;
     int loop_timeframe_minutes = get_time_frame_in_minutes(loop_timeframe);
-    int nb_dates = training->candles.size();
+    int nb_dates = training->candles_windows.size();
 
     // Check the dates is in the cache
     ASSERT_EQ(training->cache->data.size(), nb_dates);
@@ -259,7 +294,7 @@ TEST_F(TrainingTest, CacheData)
 
     // Get the dates from the candles of loop_timeframe
     std::vector<time_t> dates;
-    for (const auto &[date, candles_data] : training->candles)
+    for (const auto &[date, candles_data] : training->candles_windows)
     {
         dates.push_back(date);
     }
@@ -267,15 +302,12 @@ TEST_F(TrainingTest, CacheData)
     // Check the dates in the cache
     for (const auto &date : dates)
     {
-        std::string date_string = std::to_string(date);
-        ASSERT_TRUE(training->cache->has(date_string));
+        ASSERT_TRUE(training->cache->has(date));
     }
 
     for (const auto &date : dates)
     {
-        std::string date_string = std::to_string(date);
-
-        for (const auto &[timeframe, candles] : training->cache->get(date_string).candles)
+        for (const auto &[timeframe, candles] : training->cache->get(date).candles)
         {
             // Check the candles are not empty
             ASSERT_FALSE(candles.empty());
@@ -283,11 +315,11 @@ TEST_F(TrainingTest, CacheData)
             // Check the last candle date
             if (timeframe == loop_timeframe)
             {
-                ASSERT_EQ(training->cache->get(date_string).candles[timeframe].back().date, date);
+                ASSERT_EQ(training->cache->get(date).candles.at(timeframe).back().date, date);
             }
             else
             {
-                ASSERT_LE(training->cache->get(date_string).candles[timeframe].back().date, date);
+                ASSERT_LE(training->cache->get(date).candles.at(timeframe).back().date, date);
             }
 
             // Check the the candle dates are well ordered
@@ -298,7 +330,7 @@ TEST_F(TrainingTest, CacheData)
         }
 
         // Check the the indicators are in the cache
-        for (const auto &[timeframe, indicators_data] : training->cache->get(date_string).indicators)
+        for (const auto &[timeframe, indicators_data] : training->cache->get(date).indicators)
         {
             for (const auto &[id, data] : indicators_data)
             {
@@ -307,10 +339,39 @@ TEST_F(TrainingTest, CacheData)
         }
 
         // Check the the base currency conversion rate is in the cache
-        ASSERT_GT(training->cache->get(date_string).base_currency_conversion_rate, 0);
+        ASSERT_GT(training->cache->get(date).base_currency_conversion_rate, 0);
     }
 }
 
+TEST_F(TrainingTest, LoadFeatures)
+{
+    training->load_candles();
+    training->load_indicators();
+    training->load_base_currency_conversion_rate();
+    training->cache_data();
+    training->load_features();
+
+    ASSERT_EQ(training->nb_features, training->count_indicators());
+    ASSERT_EQ(training->features.size(), training->cache->size() * training->nb_features);
+
+    // Check the rows are the inputs the trader gets from the indicators
+    for (const auto &date : training->dates)
+    {
+        int index = training->cache->find(date);
+        ASSERT_GE(index, 0);
+        std::vector<double> inputs = Trader::get_indicators_inputs(training->config, training->cache->at(index).indicators);
+        std::vector<double> row(training->features.begin() + index * training->nb_features, training->features.begin() + (index + 1) * training->nb_features);
+        ASSERT_EQ(row, inputs);
+    }
+
+    // The rows are the same when the cache is loaded from its file, its indicators are read in place
+    std::vector<double> features = training->features;
+    delete training->cache;
+    training->cache = Cache::load(training->cache_file.generic_string());
+    training->load_features();
+    ASSERT_EQ(training->features, features);
+}
+
 TEST_F(TrainingTest, GetAllTimeframes)
 {
     std::vector<TimeFrame> timeframes = training->get_all_timeframes();
@@ -320,6 +381,211 @@ TEST_F(TrainingTest, GetAllTimeframes)
     ASSERT_TRUE(std::find(timeframes.begin(), timeframes.end(), TimeFrame::H1) != timeframes.end());
 }
 
+TEST_F(TrainingTest, CalculateConfigHash)
+{
+    uint64_t hash = training->calculate_config_hash();
+    ASSERT_EQ(hash, training->calculate_config_hash());
+
+    // The hash changes with the parameters the prepared data depend on
+    training->config.training.training_end_date += 86400;
+    ASSERT_NE(hash, training->calculate_config_hash());
+}
+
+TEST_F(TrainingTest, EvaluateGenomesLockstep)
+{
+    training->prepare();
+
+    // Evaluate the genomes one after another
+    std::vector<neat::Genome *> genomes = training->population->genomes;
+    std::vector<double> fitnesses;
+    for (auto &genome : genomes)
+    {
+        training->evaluate_genome(genome, 0);
+        fitnesses.push_back(genome->fitness);
+    }
+    training->current_generation_traders.clear();
+
+    // Evaluate the genomes together, the fitnesses are the same
+    training->evaluate_genomes(genomes, 0);
+    ASSERT_EQ(training->current_generation_traders.size(), genomes.size());
+    for (size_t i = 0; i < genomes.size(); ++i)
+    {
+        ASSERT_EQ(training->current_generation_traders[i]->genome, genomes[i]);
+        ASSERT_EQ(genomes[i]->fitness, fitnesses[i]);
+    }
+}
+
+TEST_F(TrainingTest, EvaluateGenomesRacing)
+{
+    training->prepare();
+
+    // Evaluate the genomes on the whole period
+    std::vector<neat::Genome *> genomes = training->population->genomes;
+    std::vector<double> fitnesses;
+    for (auto &genome : genomes)
+    {
+        training->evaluate_genome(genome, 0);
+        fitnesses.push_back(genome->fitness);
+    }
+    training->current_generation_traders.clear();
+
+    // Evaluate the genomes with a racing, all the genomes get a fitness
+    training->config.training.racing_slices = 4;
+    training->config.training.racing_survival_rate = 0.5;
+    training->evaluate_genomes(genomes, 0);
+    ASSERT_EQ(training->current_generation_traders.size(), genomes.size());
+
+    // The genomes which won the racing went through the whole period and have the same fitness
+    int nb_same_fitness = 0;
+    for (size_t i = 0; i < genomes.size(); ++i)
+    {
+        ASSERT_GE(genomes[i]->fitness, 0);
+        if (genomes[i]->fitness == fitnesses[i])
+        {
+            nb_same_fitness++;
+        }
+    }
+    ASSERT_GE(nb_same_fitness, 1);
+}
+
+TEST_F(TrainingTest, RestoreEvaluation)
+{
+    training->prepare();
+    training->evaluation_hash = training->calculate_evaluation_hash();
+
+    // Evaluate the genomes of a generation
+    std::vector<neat::Genome *> genomes = training->population->genomes;
+    for (auto &genome : genomes)
+    {
+        training->evaluate_genome(genome, 0);
+    }
+    std::vector<Trader *> traders = training->current_generation_traders;
+    training->current_generation_traders.clear();
+    ASSERT_EQ(training->next_evaluated_traders.size(), genomes.size());
+
+    // The clones of the genomes get the evaluations of the last generation
+    training->evaluated_traders.swap(training->next_evaluated_traders);
+    training->next_evaluated_traders.clear();
+    for (size_t i = 0; i < genomes.size(); ++i)
+    {
+        neat::Genome *clone = genomes[i]->clone();
+        Trader *trader = new Trader(clone, training->config);
+        ASSERT_TRUE(training->restore_evaluation(trader, clone->hash()));
+        ASSERT_EQ(trader->fitness, traders[i]->fitness);
+        ASSERT_EQ(trader->score, traders[i]->score);
+        ASSERT_EQ(trader->fitness_details, traders[i]->fitness_details);
+        ASSERT_EQ(trader->balance_history, traders[i]->balance_history);
+    }
+
+    // The restored evaluations are the same as the ones of a new run
+    training->evaluated_traders.clear();
+    for (size_t i = 0; i < genomes.size(); ++i)
+    {
+        neat::Genome *clone = genomes[i]->clone();
+        training->evaluate_genome(clone, 1);
+        ASSERT_EQ(clone->fitness, traders[i]->fitness);
+    }
+
+    // A change of the configuration changes the evaluations
+    uint64_t evaluation_hash = training->evaluation_hash;
+    training->config.evaluation.minimum_nb_trades = training->config.evaluation.minimum_nb_trades.value_or(0) + 1;
+    ASSERT_NE(training->calculate_evaluation_hash(), evaluation_hash);
+}
+
+TEST_F(TrainingTest, ReplayTrader)
+{
+    training->prepare();
+
+    // The traders of the generation do not keep their histories after the evaluation
+    neat::Genome *genome = training->population->genomes[0];
+    training->evaluate_genome(genome, 0);
+    Trader *trader = training->current_generation_traders.back();
+    ASSERT_TRUE(trader->balance_history.empty());
+    ASSERT_TRUE(trader->trades_history.empty());
+
+    // The replayed trader gets the histories back with the same evaluation
+    Trader *replayed_trader = training->replay_trader(trader);
+    ASSERT_EQ(replayed_trader->genome, genome);
+    ASSERT_FALSE(replayed_trader->balance_history.empty());
+    ASSERT_EQ(replayed_trader->fitness, trader->fitness);
+    ASSERT_EQ(replayed_trader->stats.total_trades, trader->stats.total_trades);
+    ASSERT_EQ(replayed_trader->stats.final_balance, trader->stats.final_balance);
+    delete replayed_trader;
+}
+
+TEST_F(TrainingTest, Migrate)
+{
+    Training *island_0 = new Training("test_islands", config_file_path.generic_string(), false, 0);
+    Training *island_1 = new Training("test_islands", config_file_path.generic_string(), false, 1);
+    ASSERT_EQ(island_0->directory, std::filesystem::path("reports/test_islands/island_0"));
+    ASSERT_EQ(island_0->migrations_directory, island_1->migrations_directory);
+    ASSERT_EQ(island_0->cache_file, island_1->cache_file);
+
+    // The first island sends its best genome, the second island receives it in its population
+    island_0->config.training.migration_size = 1;
+    island_0->population->best_genome = island_0->population->genomes[0];
+    island_1->population->best_genome = island_1->population->genomes[0];
+    island_0->migrate(4);
+    island_1->migrate(4);
+    ASSERT_EQ(island_1->imported_migrations[0], 4);
+    ASSERT_TRUE(island_1->population->genomes.back()->is_equal(island_0->population->genomes[0]));
+
+    // The genomes are imported once
+    island_1->migrate(9);
+    ASSERT_EQ(island_1->imported_migrations[0], 4);
+
+    // Only the last genomes sent by an island are kept in the spool directory
+    ASSERT_TRUE(std::filesystem::exists(island_1->migrations_directory / "island_1_generation_9.json"));
+    ASSERT_FALSE(std::filesystem::exists(island_1->migrations_directory / "island_1_generation_4.json"));
+
+    // The imported genomes are saved with the training, they are not imported again after a restart
+    island_1->best_trader = new Trader(island_1->population->genomes[0], island_1->config);
+    island_1->save();
+    Training *restarted_island_1 = new Training("test_islands", config_file_path.generic_string(), false, 1);
+    ASSERT_EQ(restarted_island_1->imported_migrations, island_1->imported_migrations);
+    delete restarted_island_1;
+
+    // The progress of the islands is aggregated by the coordinator
+    std::ofstream island_save_file(island_0->training_save_file);
+    island_save_file << nlohmann::json({{"current_generation", 2}, {"best_fitnesses", {{"0", 1.0}, {"1", 2.0}}}, {"average_fitnesses", {{"0", 0.5}, {"1", 1.0}}}}).dump();
+    island_save_file.close();
+    Training *coordinator = new Training("test_islands", config_file_path.generic_string(), false, -1, true);
+    ASSERT_EQ(coordinator->population, nullptr);
+    coordinator->aggregate_islands(2);
+    ASSERT_TRUE(std::filesystem::exists(coordinator->islands_save_file));
+    ASSERT_EQ(coordinator->best_fitnesses[1], 2.0);
+    ASSERT_EQ(coordinator->average_fitnesses[0], 0.5);
+
+    std::filesystem::remove_all("reports/test_islands");
+    delete island_0;
+    delete island_1;
+    delete coordinator;
+}
+
+TEST_F(TrainingTest, IslandsSeeds)
+{
+    Training *island_0 = new Training("test_islands", config_file_path.generic_string(), false, 0);
+    Training *island_1 = new Training("test_islands", config_file_path.generic_string(), false, 1);
+
+    // The islands with the same seed evolve different populations
+    island_0->config.neat.seed = 42;
+    island_1->config.neat.seed = 42;
+    ASSERT_NE(island_0->get_neat_config().seed, island_1->get_neat_config().seed);
+    neat::Population *population_0 = new neat::Population(island_0->get_neat_config(), true);
+    neat::Population *population_1 = new neat::Population(island_1->get_neat_config(), true);
+    ASSERT_NE(population_0->genomes[0]->id, population_1->genomes[0]->id);
+    ASSERT_FALSE(population_0->genomes[0]->is_equal(population_1->genomes[0]));
+
+    // Without islands, the seed of the configuration is used as it is
+    ASSERT_EQ(training->get_neat_config().seed, training->config.neat.seed);
+
+    std::filesystem::remove_all("reports/test_islands");
+    delete population_0;
+    delete population_1;
+    delete island_0;
+    delete island_1;
+}
+
 TEST_F(TrainingTest, Run)
 {
     for (int i = 0; i < 10; ++i)
@@ -391,6 +657,20 @@ TEST_F(TrainingTest, MonteCarloSimulation)
 
     // Asserts that the evaluation went well
     ASSERT_EQ(result, 0);
+
+    // The bootstrap model needs the trades history of the trader
+    ASSERT_THROW(training->evaluate_trader_with_monte_carlo_simulation(trader, 1000, 0.1, MonteCarloModel::BOOTSTRAP), std::invalid_argument);
+
+    std::vector<double> returns = {0.02, -0.02, 0.01, -0.01};
+    for (double pnl_net_percent : returns)
+    {
+        Trade trade;
+        trade.pnl_net_percent = pnl_net_percent;
+        trade.closed = true;
+        trader->trades_history.push_back(trade);
+    }
+    result = training->evaluate_trader_with_monte_carlo_simulation(trader, 1000, 0.1, MonteCarloModel::BOOTSTRAP);
+    ASSERT_EQ(result, 0);
 }
 
 TEST_F(TrainingTest, GenerateFitnessReport)
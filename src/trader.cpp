@@ -51,11 +51,14 @@ Trader::Trader(neat::Genome *genome, Config config, Logger *logger)
     // Vision
     this->candles = {};
     this->current_date = 0;
+    this->current_calendar = BarCalendar();
+    this->current_tp_sl_levels = nullptr;
     this->current_base_currency_conversion_rate = 1.0;
 
     // History
     this->balance_history = {};
     this->trades_history = {};
+    this->record_balance_history = true;
 
     // Trading stuff
     this->balance = config.general.initial_balance;
@@ -99,77 +102,117 @@ Trader::~Trader()
  * @param base_currency_conversion_rate Conversion rate when the base asset traded is different from the account currency.
  * @param position_infos Vector of position information.
  */
-void Trader::look(IndicatorsData &indicators_data, double base_currency_conversion_rate, std::vector<PositionInfo> position_infos)
+void Trader::look(const IndicatorsData &indicators_data, double base_currency_conversion_rate, const std::vector<PositionInfo> &position_infos)
+{
+    std::vector<double> indicators_values = Trader::get_indicators_inputs(this->config, indicators_data);
+    this->look(indicators_values.data(), indicators_values.size(), base_currency_conversion_rate, position_infos);
+}
+
+/**
+ * @brief Get inputs for genome from the precomputed values of the indicators.
+ * @param indicators_values Values of the indicators, in the order given by get_indicators_inputs.
+ * @param nb_indicators_values Number of values of the indicators.
+ * @param base_currency_conversion_rate Conversion rate when the base asset traded is different from the account currency.
+ * @param position_infos Vector of position information.
+ */
+void Trader::look(const double *indicators_values, size_t nb_indicators_values, double base_currency_conversion_rate, const std::vector<PositionInfo> &position_infos)
 {
-    std::vector<double> indicators_values = {};
     this->current_base_currency_conversion_rate = base_currency_conversion_rate;
 
-    for (const auto &[tf, indicators] : this->config.training.inputs.indicators)
-    {
-        for (const auto &indicator : indicators)
-        {
-            indicators_values.push_back(indicators_data[tf][indicator->id].back());
-            if ((this->config.strategy.can_open_long_trade.value_or(true) && this->config.strategy.can_close_trade.value_or(false)) || (this->config.strategy.can_open_short_trade.value_or(true) && this->config.strategy.can_close_trade.value_or(false)) || (this->config.strategy.can_open_long_trade.value_or(true) && this->config.strategy.can_open_short_trade.value_or(true)))
-            {
-                indicators_values.push_back(indicators_data[tf][indicator->id + "-reverse"].back());
-            }
-        }
-    }
+    // The vision keeps its capacity from a bar to the next one
+    this->vision.assign(indicators_values, indicators_values + nb_indicators_values);
 
     // Get the position information
-    std::vector<double> position_info = {};
     for (const auto &info : position_infos)
     {
         if (this->current_position == nullptr)
         {
-            position_info.push_back(0);
+            this->vision.push_back(0);
         }
         else if (info == PositionInfo::TYPE)
         {
             if (this->current_position->side == PositionSide::LONG)
             {
-                position_info.push_back(1);
+                this->vision.push_back(1);
             }
             else if (this->current_position->side == PositionSide::SHORT)
             {
-                position_info.push_back(-1);
+                this->vision.push_back(-1);
             }
             else
             {
-                position_info.push_back(0);
+                this->vision.push_back(0);
             }
         }
         else if (info == PositionInfo::PNL)
         {
             double position_pnl_percent = this->current_position->size > 0 ? this->current_position->pnl / this->balance : 0;
-            position_info.push_back(position_pnl_percent);
+            this->vision.push_back(position_pnl_percent);
         }
         else if (info == PositionInfo::DURATION)
         {
             if (this->config.strategy.maximum_trade_duration.has_value())
             {
-                position_info.push_back(static_cast<double>(this->duration_in_position) / static_cast<double>(this->config.strategy.maximum_trade_duration.value_or(1)));
+                this->vision.push_back(static_cast<double>(this->duration_in_position) / static_cast<double>(this->config.strategy.maximum_trade_duration.value_or(1)));
             }
             else
             {
                 // Cannot normalize the duration if the maximum trade duration is not set
-                position_info.push_back(0.0);
+                this->vision.push_back(0.0);
             }
         }
     }
 
-    // Concat the indicators values and the position information
-    std::vector<double> inputs = {};
-    inputs.insert(inputs.end(), indicators_values.begin(), indicators_values.end());
-    inputs.insert(inputs.end(), position_info.begin(), position_info.end());
-
-    this->vision = inputs;
     if (this->logger != nullptr)
     {
         this->logger->info(this->log_header() + "Looking at the market.");
     }
 }
 
+/**
+ * @brief Get the values of the indicators given as inputs to the genome, in the order the trader looks at them.
+ * The reverse value of each indicator follows its value when the strategy can trade both ways.
+ * @param config Configuration object.
+ * @param indicators_data Indicator data for all time frames.
+ * @return Vector of the last value of each indicator input.
+ */
+std::vector<double> Trader::get_indicators_inputs(const Config &config, const IndicatorsData &indicators_data)
+{
+    std::vector<double> indicators_values = {};
+    for (const auto &[tf, id] : Trader::get_indicators_inputs_ids(config))
+    {
+        indicators_values.push_back(indicators_data.at(tf).at(id).back());
+    }
+
+    return indicators_values;
+}
+
+/**
+ * @brief Get the indicators given as inputs to the genome, in the order the trader looks at them.
+ * The reverse value of each indicator follows its value when the strategy can trade both ways.
+ * @param config Configuration object.
+ * @return Vector of the time frame and the id of each indicator input.
+ */
+std::vector<std::pair<TimeFrame, std::string>> Trader::get_indicators_inputs_ids(const Config &config)
+{
+    std::vector<std::pair<TimeFrame, std::string>> indicators_ids = {};
+    bool with_reverse = (config.strategy.can_open_long_trade.value_or(true) && config.strategy.can_close_trade.value_or(false)) || (config.strategy.can_open_short_trade.value_or(true) && config.strategy.can_close_trade.value_or(false)) || (config.strategy.can_open_long_trade.value_or(true) && config.strategy.can_open_short_trade.value_or(true));
+
+    for (const auto &[tf, indicators] : config.training.inputs.indicators)
+    {
+        for (const auto &indicator : indicators)
+        {
+            indicators_ids.push_back({tf, indicator->id});
+            if (with_reverse)
+            {
+                indicators_ids.push_back({tf, indicator->id + "-reverse"});
+            }
+        }
+    }
+
+    return indicators_ids;
+}
+
 /**
  * @brief Get the outputs from the neural network.
  */
@@ -206,31 +249,108 @@ void Trader::update(CandlesData &candles)
         return;
     }
 
-    // Update the candles
+    // Update the candles, the trader reads its own copy of them
     this->candles = candles;
+    this->candles_views.clear();
+    this->current_tp_sl_levels = nullptr;
+    this->process_candles(this->get_calendar());
+}
 
-    // Detect if it's a new day, and reset the number of trades made today
-    if (this->current_date != 0)
+/**
+ * @brief Update the trader with the windows of the candle timelines at the current date.
+ * @param candles Views of the candles for all time frames.
+ */
+void Trader::update(const CandlesViews &candles)
+{
+    if (candles.empty())
+    {
+        std::cerr << "No candles data provided." << std::endl;
+        return;
+    }
+
+    // Update the views of the candles, the candles themselves are not copied
+    this->candles_views = candles;
+    this->current_tp_sl_levels = nullptr;
+    this->process_candles(this->get_calendar());
+}
+
+/**
+ * @brief Update the trader with the windows of the candle timelines at the current date and their precomputed calendar fields and take profit and stop loss levels.
+ * @param candles Views of the candles for all time frames.
+ * @param calendar Calendar fields of the last candle of the strategy time frame (see get_bar_calendar).
+ * @param tp_sl_levels Take profit and stop loss levels of the last candle of the strategy time frame, they must outlive the next update.
+ */
+void Trader::update(const CandlesViews &candles, const BarCalendar &calendar, const TpSlLevels &tp_sl_levels)
+{
+    if (candles.empty())
     {
-        struct tm last_date_tm = time_t_to_tm(this->current_date);
-        int last_year = last_date_tm.tm_year;
-        int last_month = last_date_tm.tm_mon;
-        int last_day = last_date_tm.tm_mday;
+        std::cerr << "No candles data provided." << std::endl;
+        return;
+    }
 
-        struct tm current_date_tm = time_t_to_tm(this->candles[this->config.strategy.timeframe].back().date);
-        int current_year = current_date_tm.tm_year;
-        int current_month = current_date_tm.tm_mon;
-        int current_day = current_date_tm.tm_mday;
+    // Update the views of the candles, the calendar fields and the levels are read instead of being computed from the candles
+    this->candles_views = candles;
+    this->current_tp_sl_levels = &tp_sl_levels;
+    this->process_candles(calendar);
+}
 
-        bool is_new_day = last_year != current_year || last_month != current_month || last_day != current_day;
-        if (is_new_day)
-        {
-            this->nb_trades_today = 0;
-        }
+/**
+ * @brief Compute the calendar fields of the last candle of the strategy time frame.
+ * @return Calendar fields of the candle.
+ */
+BarCalendar Trader::get_calendar() const
+{
+    return get_bar_calendar(this->get_candles(this->config.strategy.timeframe).back().date, this->config.strategy.timeframe, this->config.strategy.trading_schedule);
+}
+
+/**
+ * @brief Get the candles of a time frame at the current date.
+ * @param time_frame Time frame of the candles.
+ * @return View of the candles, empty if there is no candle for the time frame.
+ */
+CandlesView Trader::get_candles(TimeFrame time_frame) const
+{
+    if (!this->candles_views.empty())
+    {
+        auto it = this->candles_views.find(time_frame);
+        return it != this->candles_views.end() ? it->second : CandlesView();
+    }
+
+    auto it = this->candles.find(time_frame);
+    return it != this->candles.end() ? CandlesView(it->second) : CandlesView();
+}
+
+/**
+ * @brief Calculate the take profit and stop loss prices of a new position, from the precomputed levels if any.
+ * @param market_price The current market price.
+ * @param side The side of the position.
+ * @return The take profit and stop loss prices.
+ */
+std::tuple<double, double> Trader::get_tp_sl_prices(double market_price, PositionSide side) const
+{
+    const TakeProfitStopLossConfig &tp_sl_config = this->config.strategy.take_profit_stop_loss_config;
+    if (this->current_tp_sl_levels != nullptr)
+    {
+        return calculate_tp_sl_price(market_price, *this->current_tp_sl_levels, side, tp_sl_config, this->symbol_info);
+    }
+    return calculate_tp_sl_price(market_price, this->get_candles(this->config.strategy.timeframe), side, tp_sl_config, this->symbol_info);
+}
+
+/**
+ * @brief Run the update of the trader once its candles have been replaced (see update).
+ * @param calendar Calendar fields of the last candle of the strategy time frame.
+ */
+void Trader::process_candles(const BarCalendar &calendar)
+{
+    // Detect if it's a new day, and reset the number of trades made today
+    if (this->current_date != 0 && calendar.day != this->current_calendar.day)
+    {
+        this->nb_trades_today = 0;
     }
 
     // Update the current date
-    this->current_date = this->candles[this->config.strategy.timeframe].back().date;
+    this->current_date = this->get_candles(this->config.strategy.timeframe).back().date;
+    this->current_calendar = calendar;
 
     if (this->logger != nullptr)
     {
@@ -268,18 +388,12 @@ void Trader::update(CandlesData &candles)
     }
 
     // Close the trade before a rest day (day without trading session)
-    int next_date = this->current_date + get_time_frame_in_minutes(this->config.strategy.timeframe) * 60;
-    if (this->config.strategy.trading_schedule.has_value())
+    if (calendar.next_is_rest_day)
     {
-        TradingSchedule trading_schedule = this->config.strategy.trading_schedule.value();
-        int next_day = time_t_to_tm(next_date).tm_wday;
-        if (!has_session_for_day(next_day, trading_schedule))
+        this->close_position_by_market();
+        if (this->logger != nullptr)
         {
-            this->close_position_by_market();
-            if (this->logger != nullptr)
-            {
-                this->logger->info(this->log_header() + "Closed the position before a rest day.");
-            }
+            this->logger->info(this->log_header() + "Closed the position before a rest day.");
         }
     }
 
@@ -312,7 +426,11 @@ void Trader::update(CandlesData &candles)
     }
 
     // Record the balance to history
-    this->balance_history.push_back(this->balance);
+    if (this->record_balance_history)
+    {
+        this->balance_history.push_back(this->balance);
+    }
+    this->stats.add_balance(this->balance);
 
     if (this->logger != nullptr)
     {
@@ -332,15 +450,10 @@ void Trader::update(CandlesData &candles)
  */
 bool Trader::can_trade()
 {
-    Candle last_candle = this->candles[this->config.strategy.timeframe].back();
+    Candle last_candle = this->get_candles(this->config.strategy.timeframe).back();
 
     // Check if the trader can trade at the moment according to the schedule
-    bool schedule_is_ok = true;
-    if (this->config.strategy.trading_schedule.has_value())
-    {
-        TradingSchedule trading_schedule = this->config.strategy.trading_schedule.value();
-        schedule_is_ok = is_on_trading_schedule(this->current_date, trading_schedule);
-    }
+    bool schedule_is_ok = this->current_calendar.tradable;
 
     // Check the number of trades made today
     bool number_of_trades_per_day_is_ok = this->nb_trades_today < this->config.strategy.maximum_trades_per_day.value();
@@ -369,7 +482,7 @@ bool Trader::can_trade()
 int Trader::trade()
 {
     int loop_interval_minutes = get_time_frame_in_minutes(this->config.strategy.timeframe);
-    Candle last_candle = this->candles[this->config.strategy.timeframe].back();
+    Candle last_candle = this->get_candles(this->config.strategy.timeframe).back();
 
     // Position information
     bool has_position = this->current_position != nullptr;
@@ -420,8 +533,7 @@ int Trader::trade()
                 if (want_long && this->config.strategy.can_open_long_trade.value_or(true))
                 {
                     // Calculate order parameters
-                    std::vector<Candle> candles = this->candles[this->config.strategy.timeframe];
-                    auto order_prices = calculate_tp_sl_price(last_candle.close, candles, PositionSide::LONG, this->config.strategy.take_profit_stop_loss_config, this->symbol_info);
+                    auto order_prices = this->get_tp_sl_prices(last_candle.close, PositionSide::LONG);
                     double tp_price = std::get<0>(order_prices);
                     double sl_price = std::get<1>(order_prices);
                     double sl_pips = calculate_pips(last_candle.close, sl_price, this->symbol_info);
@@ -439,8 +551,7 @@ int Trader::trade()
                 else if (want_short && this->config.strategy.can_open_short_trade.value_or(true))
                 {
                     // Calculate order parameters
-                    std::vector<Candle> candles = this->candles[this->config.strategy.timeframe];
-                    auto order_prices = calculate_tp_sl_price(last_candle.close, candles, PositionSide::SHORT, this->config.strategy.take_profit_stop_loss_config, this->symbol_info);
+                    auto order_prices = this->get_tp_sl_prices(last_candle.close, PositionSide::SHORT);
                     double tp_price = std::get<0>(order_prices);
                     double sl_price = std::get<1>(order_prices);
                     double sl_pips = calculate_pips(last_candle.close, sl_price, this->symbol_info);
@@ -870,11 +981,20 @@ void Trader::calculate_score()
 }
 
 /**
- * @brief Calcule the trader statistics.
+ * @brief Calcule the trader statistics, from the balances and the trades accumulated during the simulation.
  */
 void Trader::calculate_stats()
 {
-    this->stats.calculate(this->trades_history, this->balance_history);
+    this->stats.finish();
+}
+
+/**
+ * @brief Release the memory of the balance and trades histories, once the fitness is calculated they are only needed for the reports.
+ */
+void Trader::release_histories()
+{
+    std::vector<double>().swap(this->balance_history);
+    std::vector<Trade>().swap(this->trades_history);
 }
 
 /**
@@ -894,8 +1014,6 @@ void Trader::open_position_by_market(double price, double size, OrderSide side)
 
     if (side == OrderSide::LONG)
     {
-        this->stats.total_trades++;
-        this->stats.total_long_trades++;
         this->balance -= fees;
         this->duration_in_position = 0;
         this->current_position = new Position{
@@ -921,8 +1039,6 @@ void Trader::open_position_by_market(double price, double size, OrderSide side)
     }
     else if (side == OrderSide::SHORT)
     {
-        this->stats.total_trades++;
-        this->stats.total_short_trades++;
         this->balance -= fees;
         this->duration_in_position = 0;
         this->current_position = new Position{
@@ -962,7 +1078,7 @@ void Trader::close_position_by_market(double price)
     }
     else
     {
-        Candle last_candle = this->candles[this->config.strategy.timeframe].back();
+        Candle last_candle = this->get_candles(this->config.strategy.timeframe).back();
         price = last_candle.close;
     }
 
@@ -982,6 +1098,7 @@ void Trader::close_position_by_market(double price)
 
         // Update the balance
         this->balance = std::max(0.0, this->balance + this->current_position->pnl - fees);
+        this->stats.add_trade(this->trades_history.back());
 
         if (this->logger != nullptr)
         {
@@ -1026,6 +1143,7 @@ void Trader::close_position_by_limit(double price)
 
         // Update the balance
         this->balance = std::max(0.0, this->balance + this->current_position->pnl - fees);
+        this->stats.add_trade(this->trades_history.back());
 
         if (this->logger != nullptr)
         {
@@ -1066,7 +1184,7 @@ void Trader::create_open_order(OrderType type, OrderSide side, double price)
  */
 void Trader::check_open_orders()
 {
-    Candle last_candle = this->candles[this->config.strategy.timeframe].back();
+    Candle last_candle = this->get_candles(this->config.strategy.timeframe).back();
 
     if (this->open_orders.size() > 0)
     {
@@ -1155,7 +1273,7 @@ void Trader::check_position_liquidation()
     if (this->current_position != nullptr)
     {
         double liquidation_price = calculate_liquidation_price(this->current_position, this->config.general.leverage, this->symbol_info);
-        double current_price = this->candles[this->config.strategy.timeframe].back().close;
+        double current_price = this->get_candles(this->config.strategy.timeframe).back().close;
 
         if (this->current_position->side == PositionSide::LONG)
         {
@@ -1192,7 +1310,7 @@ void Trader::update_position_pnl(double price)
 {
     if (this->current_position != nullptr)
     {
-        double current_price = price != 0.0 ? price : this->candles[this->config.strategy.timeframe].back().close;
+        double current_price = price != 0.0 ? price : this->get_candles(this->config.strategy.timeframe).back().close;
         this->current_position->pnl = calculate_profit_loss(current_price, *this->current_position, this->symbol_info, this->current_base_currency_conversion_rate);
     }
 }
@@ -1210,7 +1328,7 @@ void Trader::update_trailing_stop_loss()
 
     TrailingStopLossConfig config = this->config.strategy.trailing_stop_loss_config.value();
     Order *stop_loss_order = &this->open_orders[1];
-    double current_price = this->candles[this->config.strategy.timeframe].back().close;
+    double current_price = this->get_candles(this->config.strategy.timeframe).back().close;
 
     if (config.type == TypeTrailingStopLoss::PERCENT)
     {
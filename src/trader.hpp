@@ -2,6 +2,7 @@
 #define TRADER_HPP
 
 #include <ctime>
+#include <tuple>
 #include <vector>
 #include <unordered_map>
 #include "libs/json.hpp"
@@ -17,13 +18,17 @@ public:
     SymbolInfo symbol_info;
 
     // Vision
-    CandlesData candles;
+    CandlesData candles;        // Own copy of the candles given to update, read when there are no views.
+    CandlesViews candles_views; // Views of the shared candles of the current date given to update.
     double current_base_currency_conversion_rate;
     time_t current_date;
+    BarCalendar current_calendar;           // Calendar fields of the current date.
+    const TpSlLevels *current_tp_sl_levels; // Precomputed take profit and stop loss levels of the current date, nullptr to compute them from the candles.
 
     // History
     std::vector<double> balance_history;
     std::vector<Trade> trades_history;
+    bool record_balance_history; // Record the balance at each candle, only needed for the reports since the statistics are accumulated online
 
     // Trading stuffs
     double balance;
@@ -71,7 +76,33 @@ public:
      * @param base_currency_conversion_rate Conversion rate when the base asset traded is different from the account currency.
      * @param position_infos Vector of position information.
      */
-    void look(IndicatorsData &indicators, double base_currency_conversion_rate, std::vector<PositionInfo> position_infos);
+    void look(const IndicatorsData &indicators, double base_currency_conversion_rate, const std::vector<PositionInfo> &position_infos);
+
+    /**
+     * @brief Get inputs for genome from the precomputed values of the indicators.
+     * @param indicators_values Values of the indicators, in the order given by get_indicators_inputs.
+     * @param nb_indicators_values Number of values of the indicators.
+     * @param base_currency_conversion_rate Conversion rate when the base asset traded is different from the account currency.
+     * @param position_infos Vector of position information.
+     */
+    void look(const double *indicators_values, size_t nb_indicators_values, double base_currency_conversion_rate, const std::vector<PositionInfo> &position_infos);
+
+    /**
+     * @brief Get the values of the indicators given as inputs to the genome, in the order the trader looks at them.
+     * The reverse value of each indicator follows its value when the strategy can trade both ways.
+     * @param config Configuration object.
+     * @param indicators Indicator data for all time frames.
+     * @return Vector of the last value of each indicator input.
+     */
+    static std::vector<double> get_indicators_inputs(const Config &config, const IndicatorsData &indicators);
+
+    /**
+     * @brief Get the indicators given as inputs to the genome, in the order the trader looks at them.
+     * The reverse value of each indicator follows its value when the strategy can trade both ways.
+     * @param config Configuration object.
+     * @return Vector of the time frame and the id of each indicator input.
+     */
+    static std::vector<std::pair<TimeFrame, std::string>> get_indicators_inputs_ids(const Config &config);
 
     /**
      * @brief Get the outputs from the neural network.
@@ -96,6 +127,29 @@ public:
      */
     void update(CandlesData &candles);
 
+    /**
+     * @brief Update the trader with the windows of the candle timelines at the current date.
+     * The trader only keeps the views, the timelines must outlive the next update.
+     * @param candles Views of the candles for all time frames.
+     */
+    void update(const CandlesViews &candles);
+
+    /**
+     * @brief Update the trader with the windows of the candle timelines at the current date and their precomputed calendar fields and take profit and stop loss levels.
+     * The trader only keeps the views and the levels, they must outlive the next update.
+     * @param candles Views of the candles for all time frames.
+     * @param calendar Calendar fields of the last candle of the strategy time frame (see get_bar_calendar).
+     * @param tp_sl_levels Take profit and stop loss levels of the last candle of the strategy time frame.
+     */
+    void update(const CandlesViews &candles, const BarCalendar &calendar, const TpSlLevels &tp_sl_levels);
+
+    /**
+     * @brief Get the candles of a time frame at the current date.
+     * @param time_frame Time frame of the candles.
+     * @return View of the candles, empty if there is no candle for the time frame.
+     */
+    CandlesView get_candles(TimeFrame time_frame) const;
+
     /**
      * @brief Check if the trader can trade.
      */
@@ -118,10 +172,15 @@ public:
     void calculate_score();
 
     /**
-     * @brief Calcule the trader statistics.
+     * @brief Calcule the trader statistics, from the balances and the trades accumulated during the simulation.
      */
     void calculate_stats();
 
+    /**
+     * @brief Release the memory of the balance and trades histories, once the fitness is calculated they are only needed for the reports.
+     */
+    void release_histories();
+
     /**
      * @brief Open a position by market.
      * @param price Price of the market order.
@@ -216,6 +275,26 @@ public:
     void generate_report(const std::string &filename, time_t start_date, time_t end_date);
 
 private:
+    /**
+     * @brief Compute the calendar fields of the last candle of the strategy time frame.
+     * @return Calendar fields of the candle.
+     */
+    BarCalendar get_calendar() const;
+
+    /**
+     * @brief Calculate the take profit and stop loss prices of a new position, from the precomputed levels if any.
+     * @param market_price The current market price.
+     * @param side The side of the position.
+     * @return The take profit and stop loss prices.
+     */
+    std::tuple<double, double> get_tp_sl_prices(double market_price, PositionSide side) const;
+
+    /**
+     * @brief Run the update of the trader once its candles have been replaced (see update).
+     * @param calendar Calendar fields of the last candle of the strategy time frame.
+     */
+    void process_candles(const BarCalendar &calendar);
+
     /**
      * @brief Display the common log header.
      * @return String representation of the log header.
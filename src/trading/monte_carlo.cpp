@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "../types.hpp"
+#include "../utils/random.hpp"
+#include "../utils/thread_pool.hpp"
+#include "monte_carlo.hpp"
+
+/**
+ * @brief Get the returns of the closed trades, net of the fees, as fractions of the balance.
+ *
+ * @param trades The trades.
+ * @return The returns of the closed trades.
+ */
+std::vector<double> get_trades_returns(const std::vector<Trade> &trades)
+{
+    std::vector<double> returns;
+    returns.reserve(trades.size());
+    for (const auto &trade : trades)
+    {
+        if (trade.closed)
+        {
+            returns.push_back(trade.pnl_net_percent);
+        }
+    }
+    return returns;
+}
+
+/**
+ * @brief Calculate a percentile of sorted values, as the value of its nearest rank.
+ *
+ * @param sorted_values The values sorted in ascending order.
+ * @param percentile The percentile in [0, 1].
+ * @return The value of the percentile.
+ */
+double calculate_percentile(const std::vector<double> &sorted_values, double percentile)
+{
+    size_t index = static_cast<size_t>(percentile * sorted_values.size());
+    return sorted_values[std::min(index, sorted_values.size() - 1)];
+}
+
+/**
+ * @brief Get the distribution of the values of the simulations.
+ *
+ * @param values The values of the simulations, they are sorted.
+ * @return The distribution of the values.
+ */
+static MonteCarloDistribution get_distribution(std::vector<double> &values)
+{
+    std::sort(values.begin(), values.end());
+
+    size_t size = values.size();
+    double median = size % 2 != 0 ? values[size / 2] : (values[size / 2 - 1] + values[size / 2]) / 2.0;
+
+    return {
+        values.front(),
+        calculate_percentile(values, 0.05),
+        calculate_percentile(values, 0.25),
+        median,
+        calculate_percentile(values, 0.75),
+        calculate_percentile(values, 0.95),
+        values.back(),
+    };
+}
+
+/**
+ * @brief Run the simulations of sequences of trades, each trade changing the balance by a return drawn from a generator.
+ *
+ * @param draw_return The function drawing the return of a trade from a generator.
+ * @param nb_trades The number of trades of each simulation.
+ * @param initial_balance The initial balance of each simulation.
+ * @param nb_simulations The number of simulations.
+ * @param seed The seed of the random values.
+ * @param thread_pool The pool to run the simulations in parallel, nullptr to run them in the calling thread.
+ * @return The distributions of the final balance and the maximum drawdown.
+ */
+template <typename DrawReturn>
+static MonteCarloResults run_simulation(DrawReturn draw_return, int nb_trades, double initial_balance, int nb_simulations, uint64_t seed, ThreadPool *thread_pool)
+{
+    if (nb_simulations <= 0)
+    {
+        throw std::invalid_argument("The number of simulations must be positive.");
+    }
+
+    std::vector<double> final_balances(nb_simulations);
+    std::vector<double> max_drawdowns(nb_simulations);
+
+    // Run the simulations of a range, the generator is seeded again for each simulation
+    auto simulate = [&](size_t first, size_t last)
+    {
+        RandomGenerator generator;
+        for (size_t i = first; i < last; i++)
+        {
+            generator.seed(derive_seed(seed, i));
+
+            double balance = initial_balance;
+            double peak_balance = initial_balance;
+            double max_drawdown = 0;
+            for (int j = 0; j < nb_trades && balance > 0; j++)
+            {
+                // The balance can not go below zero, the simulation stops there
+                balance = std::max(0.0, balance * (1.0 + draw_return(generator)));
+                if (balance > peak_balance)
+                {
+                    peak_balance = balance;
+                }
+                else if (peak_balance > 0)
+                {
+                    max_drawdown = std::max(max_drawdown, (peak_balance - balance) / peak_balance);
+                }
+            }
+
+            final_balances[i] = balance;
+            max_drawdowns[i] = max_drawdown;
+        }
+    };
+
+    if (thread_pool == nullptr)
+    {
+        simulate(0, nb_simulations);
+    }
+    else
+    {
+        // Split the simulations in chunks, a task for each simulation would cost more than the simulation itself
+        size_t nb_chunks = std::min(static_cast<size_t>(nb_simulations), 8 * thread_pool->size());
+        thread_pool->parallel_for(
+            nb_chunks, [&](size_t chunk)
+            { simulate(chunk * nb_simulations / nb_chunks, (chunk + 1) * nb_simulations / nb_chunks); });
+    }
+
+    return {get_distribution(final_balances), get_distribution(max_drawdowns)};
+}
+
+/**
+ * @brief Simulate sequences of trades by resampling with replacement the returns of real trades (bootstrap).
+ * Each simulation draws from its own stream of random values derived from the seed, so the results do not depend on the number of threads.
+ *
+ * @param trades_returns The returns of the trades to resample, as fractions of the balance.
+ * @param nb_trades The number of trades of each simulation.
+ * @param initial_balance The initial balance of each simulation.
+ * @param nb_simulations The number of simulations.
+ * @param seed The seed of the random values.
+ * @param thread_pool The pool to run the simulations in parallel. Default is nullptr, to run them in the calling thread.
+ * @return The distributions of the final balance and the maximum drawdown.
+ * @throws std::invalid_argument If there are no simulations or no trades to resample.
+ */
+MonteCarloResults run_bootstrap_simulation(const std::vector<double> &trades_returns, int nb_trades, double initial_balance, int nb_simulations, uint64_t seed, ThreadPool *thread_pool)
+{
+    if (trades_returns.empty())
+    {
+        throw std::invalid_argument("There are no trades to resample.");
+    }
+
+    double nb_returns = static_cast<double>(trades_returns.size());
+    auto draw_return = [&](RandomGenerator &generator)
+    {
+        return trades_returns[static_cast<size_t>(generator.next_double() * nb_returns)];
+    };
+
+    return run_simulation(draw_return, nb_trades, initial_balance, nb_simulations, seed, thread_pool);
+}
+
+/**
+ * @brief Simulate sequences of trades risking a fraction of the balance, won with a probability and a reward to risk ratio.
+ * Each simulation draws from its own stream of random values derived from the seed, so the results do not depend on the number of threads.
+ *
+ * @param win_rate The probability to win a trade.
+ * @param reward_risk_ratio The ratio of the gain of a winning trade to the risk.
+ * @param risk_per_trade The fraction of the balance lost by a losing trade.
+ * @param nb_trades The number of trades of each simulation.
+ * @param initial_balance The initial balance of each simulation.
+ * @param nb_simulations The number of simulations.
+ * @param seed The seed of the random values.
+ * @param thread_pool The pool to run the simulations in parallel. Default is nullptr, to run them in the calling thread.
+ * @return The distributions of the final balance and the maximum drawdown.
+ * @throws std::invalid_argument If there are no simulations.
+ */
+MonteCarloResults run_win_rate_simulation(double win_rate, double reward_risk_ratio, double risk_per_trade, int nb_trades, double initial_balance, int nb_simulations, uint64_t seed, ThreadPool *thread_pool)
+{
+    double winning_return = risk_per_trade * reward_risk_ratio;
+    double losing_return = -risk_per_trade;
+    auto draw_return = [&](RandomGenerator &generator)
+    {
+        return generator.next_double() < win_rate ? winning_return : losing_return;
+    };
+
+    return run_simulation(draw_return, nb_trades, initial_balance, nb_simulations, seed, thread_pool);
+}
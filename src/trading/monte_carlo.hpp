@@ -0,0 +1,90 @@
+#ifndef TRADING_MONTE_CARLO_HPP
+#define TRADING_MONTE_CARLO_HPP
+
+#include <cstdint>
+#include <vector>
+#include "../types.hpp"
+#include "../utils/thread_pool.hpp"
+
+/**
+ * @brief Enum for the model used to draw the trades of the simulations.
+ */
+enum class MonteCarloModel
+{
+    WIN_RATE, // Trades won with the win rate and the profit factor of the trader
+    BOOTSTRAP // Trades resampled from the trades history of the trader
+};
+
+/**
+ * @brief Struct representing the distribution of a value over the simulations.
+ */
+struct MonteCarloDistribution
+{
+    double minimum;        // Minimum value of the simulations
+    double percentile_5;   // 5th percentile
+    double lower_quartile; // 25th percentile
+    double median;         // Median
+    double upper_quartile; // 75th percentile
+    double percentile_95;  // 95th percentile
+    double maximum;        // Maximum value of the simulations
+};
+
+/**
+ * @brief Struct representing the results of a Monte Carlo simulation.
+ */
+struct MonteCarloResults
+{
+    MonteCarloDistribution final_balance; // Distribution of the final balances
+    MonteCarloDistribution max_drawdown;  // Distribution of the maximum drawdowns, as a fraction of the peak balance
+};
+
+/**
+ * @brief Get the returns of the closed trades, net of the fees, as fractions of the balance.
+ *
+ * @param trades The trades.
+ * @return The returns of the closed trades.
+ */
+std::vector<double> get_trades_returns(const std::vector<Trade> &trades);
+
+/**
+ * @brief Calculate a percentile of sorted values, as the value of its nearest rank.
+ *
+ * @param sorted_values The values sorted in ascending order.
+ * @param percentile The percentile in [0, 1].
+ * @return The value of the percentile.
+ */
+double calculate_percentile(const std::vector<double> &sorted_values, double percentile);
+
+/**
+ * @brief Simulate sequences of trades by resampling with replacement the returns of real trades (bootstrap).
+ * Each simulation draws from its own stream of random values derived from the seed, so the results do not depend on the number of threads.
+ *
+ * @param trades_returns The returns of the trades to resample, as fractions of the balance.
+ * @param nb_trades The number of trades of each simulation.
+ * @param initial_balance The initial balance of each simulation.
+ * @param nb_simulations The number of simulations.
+ * @param seed The seed of the random values.
+ * @param thread_pool The pool to run the simulations in parallel. Default is nullptr, to run them in the calling thread.
+ * @return The distributions of the final balance and the maximum drawdown.
+ * @throws std::invalid_argument If there are no simulations or no trades to resample.
+ */
+MonteCarloResults run_bootstrap_simulation(const std::vector<double> &trades_returns, int nb_trades, double initial_balance, int nb_simulations, uint64_t seed, ThreadPool *thread_pool = nullptr);
+
+/**
+ * @brief Simulate sequences of trades risking a fraction of the balance, won with a probability and a reward to risk ratio.
+ * Each simulation draws from its own stream of random values derived from the seed, so the results do not depend on the number of threads.
+ *
+ * @param win_rate The probability to win a trade.
+ * @param reward_risk_ratio The ratio of the gain of a winning trade to the risk.
+ * @param risk_per_trade The fraction of the balance lost by a losing trade.
+ * @param nb_trades The number of trades of each simulation.
+ * @param initial_balance The initial balance of each simulation.
+ * @param nb_simulations The number of simulations.
+ * @param seed The seed of the random values.
+ * @param thread_pool The pool to run the simulations in parallel. Default is nullptr, to run them in the calling thread.
+ * @return The distributions of the final balance and the maximum drawdown.
+ * @throws std::invalid_argument If there are no simulations.
+ */
+MonteCarloResults run_win_rate_simulation(double win_rate, double reward_risk_ratio, double risk_per_trade, int nb_trades, double initial_balance, int nb_simulations, uint64_t seed, ThreadPool *thread_pool = nullptr);
+
+#endif // TRADING_MONTE_CARLO_HPP
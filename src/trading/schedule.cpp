@@ -4,6 +4,7 @@
 #include <ctime>
 #include <vector>
 #include "../utils/date_conversion.hpp"
+#include "../utils/time_frame.hpp"
 #include "../types.hpp"
 #include "schedule.hpp"
 
@@ -14,38 +15,27 @@
  * @param trading_schedule The trading schedule for each day of the week.
  * @return The schedule for the given day.
  */
-std::vector<bool> get_day_schedule(const int day, const TradingSchedule &trading_schedule)
+const std::vector<bool> &get_day_schedule(const int day, const TradingSchedule &trading_schedule)
 {
-    std::vector<bool> day_schedule;
     switch (day)
     {
     case 0:
-        day_schedule = trading_schedule.sunday;
-        break;
+        return trading_schedule.sunday;
     case 1:
-        day_schedule = trading_schedule.monday;
-        break;
+        return trading_schedule.monday;
     case 2:
-        day_schedule = trading_schedule.tuesday;
-        break;
+        return trading_schedule.tuesday;
     case 3:
-        day_schedule = trading_schedule.wednesday;
-        break;
+        return trading_schedule.wednesday;
     case 4:
-        day_schedule = trading_schedule.thursday;
-        break;
+        return trading_schedule.thursday;
     case 5:
-        day_schedule = trading_schedule.friday;
-        break;
+        return trading_schedule.friday;
     case 6:
-        day_schedule = trading_schedule.saturday;
-        break;
+        return trading_schedule.saturday;
     default:
-        day_schedule = trading_schedule.sunday; // Default to Monday if invalid day
-        break;
+        return trading_schedule.sunday; // Default to Sunday if invalid day
     }
-
-    return day_schedule;
 }
 
 /**
@@ -59,7 +49,7 @@ bool is_on_trading_schedule(const time_t date, const TradingSchedule &trading_sc
 {
     std::tm date_tm = time_t_to_tm(date);
     int day = date_tm.tm_wday;
-    std::vector<bool> day_schedule = get_day_schedule(day, trading_schedule);
+    const std::vector<bool> &day_schedule = get_day_schedule(day, trading_schedule);
     return day_schedule[date_tm.tm_hour];
 }
 
@@ -70,7 +60,7 @@ bool is_on_trading_schedule(const time_t date, const TradingSchedule &trading_sc
  */
 bool has_session_for_day(const int day, const TradingSchedule &trading_schedule)
 {
-    std::vector<bool> day_schedule = get_day_schedule(day, trading_schedule);
+    const std::vector<bool> &day_schedule = get_day_schedule(day, trading_schedule);
 
     for (int i = 0; i < 24; i++)
     {
@@ -81,3 +71,29 @@ bool has_session_for_day(const int day, const TradingSchedule &trading_schedule)
     }
     return false;
 }
+
+/**
+ * @brief Compute the calendar fields of a bar, read by the traders instead of converting its date at each update.
+ *
+ * @param date The date of the bar.
+ * @param time_frame The time frame of the bars.
+ * @param trading_schedule The trading schedule for each day of the week, if any.
+ * @return The calendar fields of the bar.
+ */
+BarCalendar get_bar_calendar(const time_t date, const TimeFrame time_frame, const std::optional<TradingSchedule> &trading_schedule)
+{
+    BarCalendar calendar;
+
+    std::tm date_tm = time_t_to_tm(date);
+    calendar.day = (date_tm.tm_year + 1900) * 10000 + (date_tm.tm_mon + 1) * 100 + date_tm.tm_mday;
+
+    if (trading_schedule.has_value())
+    {
+        calendar.tradable = get_day_schedule(date_tm.tm_wday, trading_schedule.value())[date_tm.tm_hour];
+
+        time_t next_date = date + get_time_frame_in_minutes(time_frame) * 60;
+        calendar.next_is_rest_day = !has_session_for_day(time_t_to_tm(next_date).tm_wday, trading_schedule.value());
+    }
+
+    return calendar;
+}
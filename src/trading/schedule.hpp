@@ -3,6 +3,8 @@
 
 #include <array>
 #include <ctime>
+#include <optional>
+#include <vector>
 #include "../types.hpp"
 
 /**
@@ -12,7 +14,7 @@
  * @param trading_schedule The trading schedule for each day of the week.
  * @return The schedule for the given day.
  */
-std::vector<bool> get_day_schedule(const int day, const TradingSchedule &trading_schedule);
+const std::vector<bool> &get_day_schedule(const int day, const TradingSchedule &trading_schedule);
 
 /**
  * @brief Check if the given date and time are within the specified trading schedule.
@@ -30,4 +32,14 @@ bool is_on_trading_schedule(const time_t date, const TradingSchedule &trading_sc
  */
 bool has_session_for_day(const int day, const TradingSchedule &trading_schedule);
 
+/**
+ * @brief Compute the calendar fields of a bar, read by the traders instead of converting its date at each update.
+ *
+ * @param date The date of the bar.
+ * @param time_frame The time frame of the bars.
+ * @param trading_schedule The trading schedule for each day of the week, if any.
+ * @return The calendar fields of the bar.
+ */
+BarCalendar get_bar_calendar(const time_t date, const TimeFrame time_frame, const std::optional<TradingSchedule> &trading_schedule);
+
 #endif // TRADING_SCHEDULE_H
@@ -5,7 +5,6 @@
 #include <iostream>
 #include "../utils/math.hpp"
 #include "../utils/date_conversion.hpp"
-#include "../indicators/utils.hpp"
 #include "../libs/json.hpp"
 #include "stats.hpp"
 
@@ -56,6 +55,22 @@ void Stats::reset()
     this->sharpe_ratio = 0;
     this->sortino_ratio = 0;
     this->monthly_returns = {};
+
+    // Reset the online accumulation
+    this->nb_balances = 0;
+    this->last_balance = 0;
+    this->peak_balance = 0;
+    this->trough_balance = 0;
+    this->current_consecutive_winning_trades = 0;
+    this->current_consecutive_losing_trades = 0;
+    this->current_consecutive_profit = 0;
+    this->current_consecutive_loss = 0;
+    this->total_trade_duration = 0;
+    this->current_month = 0;
+    this->current_month_key = "";
+    this->current_month_return = 1.0;
+    this->monthly_returns_variance = RunningVariance();
+    this->negative_monthly_returns_variance = RunningVariance();
 }
 
 /**
@@ -67,38 +82,193 @@ void Stats::calculate(std::vector<Trade> &trades_history, std::vector<double> &b
 {
     this->reset();
 
-    // Select only closed trade
-    std::vector<Trade> closed_trades = {};
+    if (balance_history.empty())
+    {
+        std::cerr << "Error: cannot calculate statistics with an empty balance history." << std::endl;
+        return;
+    }
+
+    if (balance_history.size() < 2)
+    {
+        std::cerr << "Error: balance history is empty or has fewer than two data points." << std::endl;
+    }
+
+    // Accumulate the history as if it was added during the simulation
+    for (double balance : balance_history)
+    {
+        this->add_balance(balance);
+    }
+
     for (const auto &trade : trades_history)
     {
         if (trade.closed)
         {
-            closed_trades.push_back(trade);
+            this->add_trade(trade);
         }
     }
 
-    if (balance_history.empty())
+    this->finish();
+}
+
+/**
+ * @brief Add the balance of the trader at a new candle.
+ * @param balance Balance of the trader.
+ */
+void Stats::add_balance(double balance)
+{
+    // Update the maximum drawdown with the peak and the trough since the peak
+    if (this->nb_balances == 0)
     {
-        std::cerr << "Error: cannot calculate statistics with an empty balance history." << std::endl;
-        return;
+        this->peak_balance = balance;
+        this->trough_balance = balance;
+    }
+    else
+    {
+        if (balance > this->peak_balance)
+        {
+            this->peak_balance = balance;
+            this->trough_balance = balance;
+        }
+        else if (balance < this->trough_balance)
+        {
+            this->trough_balance = balance;
+        }
+
+        double drawdown = (this->peak_balance - this->trough_balance) / this->peak_balance;
+        this->max_drawdown = std::max(this->max_drawdown, drawdown);
+    }
+
+    this->nb_balances++;
+    this->last_balance = balance;
+}
+
+/**
+ * @brief Add a trade once it is closed, the trades must be added in the order they are closed.
+ * @param trade The closed trade.
+ */
+void Stats::add_trade(const Trade &trade)
+{
+    bool winning = trade.pnl >= 0;
+    bool long_trade = trade.side == PositionSide::LONG;
+
+    // Count the trades
+    this->total_trades++;
+    this->total_long_trades += long_trade;
+    this->total_short_trades += !long_trade;
+    this->total_winning_trades += winning;
+    this->total_winning_long_trades += winning && long_trade;
+    this->total_winning_short_trades += winning && !long_trade;
+    this->total_losing_trades += !winning;
+    this->total_losing_long_trades += !winning && long_trade;
+    this->total_losing_short_trades += !winning && !long_trade;
+
+    // Sum the profits, the losses and the fees
+    if (winning)
+    {
+        this->total_profit += trade.pnl;
+        this->max_profit = std::max(this->max_profit, trade.pnl);
+    }
+    else
+    {
+        // std::abs keeps the fraction of the loss, the unqualified abs of the previous versions truncated it to an int
+        this->total_loss += std::abs(trade.pnl);
+        this->max_loss = std::min(this->max_loss, trade.pnl);
+    }
+    this->total_fees += trade.fees;
+    this->total_net_profit = this->total_profit - this->total_loss - this->total_fees;
+
+    // Update the series of winning and losing trades
+    if (winning)
+    {
+        this->current_consecutive_winning_trades++;
+        this->current_consecutive_losing_trades = 0;
+        this->current_consecutive_profit += trade.pnl;
+        this->current_consecutive_loss = 0;
+        this->max_consecutive_winning_trades = std::max(this->max_consecutive_winning_trades, this->current_consecutive_winning_trades);
+        this->max_consecutive_profit = std::max(this->max_consecutive_profit, this->current_consecutive_profit);
+    }
+    else
+    {
+        this->current_consecutive_losing_trades++;
+        this->current_consecutive_winning_trades = 0;
+        this->current_consecutive_loss += trade.pnl;
+        this->current_consecutive_profit = 0;
+        this->max_consecutive_losing_trades = std::max(this->max_consecutive_losing_trades, this->current_consecutive_losing_trades);
+        this->max_consecutive_loss = std::min(this->max_consecutive_loss, this->current_consecutive_loss);
+    }
+
+    this->total_trade_duration += trade.duration;
+
+    // Compound the return of the month, the previous month is complete when a trade closes in a new one
+    std::tm exit_tm = time_t_to_tm(trade.exit_date);
+    int month = (exit_tm.tm_year + 1900) * 100 + exit_tm.tm_mon + 1;
+    if (month != this->current_month)
+    {
+        if (this->current_month != 0)
+        {
+            this->add_monthly_return(this->monthly_returns_variance, this->negative_monthly_returns_variance);
+        }
+        this->current_month = month;
+        this->current_month_key = time_t_to_string(trade.exit_date, "%Y-%m");
+        this->current_month_return = 1.0;
+    }
+    this->current_month_return *= (1.0 + trade.pnl_net_percent);
+}
+
+/**
+ * @brief Calculate the statistics which depend on all the balances and trades added.
+ *
+ * The accumulation is not changed, more balances and trades can be added and the statistics finished again.
+ */
+void Stats::finish()
+{
+    if (this->nb_balances > 0)
+    {
+        this->final_balance = this->last_balance;
     }
 
-    this->final_balance = balance_history.back();
     this->calculate_performance();
-    this->calculate_total_trades_stats(closed_trades);
-    this->calculate_profit_loss_stats(closed_trades);
-    this->calculate_max_drawdown(balance_history);
-    this->calculate_winrate_stats(closed_trades);
+    this->calculate_winrate_stats();
     this->calculate_average_profit_loss_stats();
     this->calculate_profit_factor();
-    this->calculate_maximum_profit_loss_stats(closed_trades);
-    this->calculate_maximum_consecutive_winning_lost_trades_stats(closed_trades);
-    this->calculate_maximum_consecutive_profit_loss_stats(closed_trades);
-    this->calculate_average_trade_duration(closed_trades);
-    this->calculate_monthly_returns(closed_trades);
-    this->calculate_average_investment_return(closed_trades);
-    this->calculate_sharpe_ratio(closed_trades);
-    this->calculate_sortino_ratio(closed_trades);
+
+    this->average_trade_duration = 0;
+    if (this->total_trades > 0)
+    {
+        this->average_trade_duration = this->total_trade_duration / static_cast<double>(this->total_trades);
+    }
+
+    // Add the return of the current month to copies of the accumulators
+    RunningVariance returns = this->monthly_returns_variance;
+    RunningVariance negative_returns = this->negative_monthly_returns_variance;
+    if (this->current_month != 0)
+    {
+        this->add_monthly_return(returns, negative_returns);
+    }
+
+    this->average_investment_return = returns.count > 0 ? returns.mean : 0.0;
+
+    // Calculate the Sharpe ratio
+    this->sharpe_ratio = 0;
+    if (returns.count > 0)
+    {
+        double std_dev = std::sqrt(returns.variance());
+        if (std_dev != 0)
+        {
+            this->sharpe_ratio = (this->average_investment_return - 0.0) / std_dev;
+        }
+    }
+
+    // Calculate the Sortino ratio
+    this->sortino_ratio = 0;
+    if (negative_returns.count > 0)
+    {
+        double std_dev = std::sqrt(negative_returns.variance());
+        if (std_dev != 0)
+        {
+            this->sortino_ratio = (this->average_investment_return - 0.0) / std_dev;
+        }
+    }
 }
 
 /**
@@ -257,115 +427,14 @@ void Stats::calculate_performance()
 }
 
 /**
- * @brief Calculate the total number of trades (long/short trades, winning/losing trades).
- * @param closed_trades Vector of Trade objects.
+ * @brief Calculate the win rates.
  */
-void Stats::calculate_total_trades_stats(const std::vector<Trade> &closed_trades)
-{
-    this->total_trades = closed_trades.size();
-    this->total_long_trades = std::count_if(closed_trades.begin(), closed_trades.end(), [](Trade trade)
-                                            { return trade.side == PositionSide::LONG; });
-    this->total_short_trades = this->total_trades - this->total_long_trades;
-
-    for (const auto &trade : closed_trades)
-    {
-        if (trade.pnl >= 0)
-        {
-            this->total_winning_trades++;
-            if (trade.side == PositionSide::LONG)
-            {
-                this->total_winning_long_trades++;
-            }
-            else
-            {
-                this->total_winning_short_trades++;
-            }
-        }
-        else
-        {
-            this->total_losing_trades++;
-            if (trade.side == PositionSide::LONG)
-            {
-                this->total_losing_long_trades++;
-            }
-            else
-            {
-                this->total_losing_short_trades++;
-            }
-        }
-    }
-}
-
-/**
- * @brief Calculate the total net profit, total profit, total loss and total fees.
- * @param closed_trades Vector of Trade objects.
- */
-void Stats::calculate_profit_loss_stats(const std::vector<Trade> &closed_trades)
-{
-    for (const auto &trade : closed_trades)
-    {
-        if (trade.pnl >= 0)
-        {
-            this->total_profit += trade.pnl;
-            this->total_fees += trade.fees;
-        }
-        else
-        {
-            this->total_loss += abs(trade.pnl);
-            this->total_fees += trade.fees;
-        }
-    }
-
-    this->total_net_profit = this->total_profit - this->total_loss - this->total_fees;
-}
-
-/**
- * @brief Calculate the maximum drawdown.
- * @param balance_history Vector of double.
- */
-void Stats::calculate_max_drawdown(const std::vector<double> &balance_history)
-{
-    if (balance_history.empty() || balance_history.size() < 2)
-    {
-        std::cerr << "Error: balance history is empty or has fewer than two data points." << std::endl;
-
-        this->max_drawdown = 0.0; // No drawdown if there are fewer than two data points
-    }
-
-    double peak = balance_history[0];
-    double trough = balance_history[0];
-    double max_drawdown = 0.0;
-
-    for (size_t i = 1; i < balance_history.size(); ++i)
-    {
-        double balance = balance_history[i];
-        if (balance > peak)
-        {
-            peak = balance;
-            trough = balance;
-        }
-        else if (balance < trough)
-        {
-            trough = balance;
-        }
-
-        double drawdown = (peak - trough) / peak;
-        max_drawdown = std::max(max_drawdown, drawdown);
-    }
-
-    this->max_drawdown = max_drawdown;
-}
-
-/**
- * @brief Calculate the total profit.
- * @param closed_trades Vector of Trade objects.
- */
-void Stats::calculate_winrate_stats(const std::vector<Trade> &closed_trades)
+void Stats::calculate_winrate_stats()
 {
     // Calculate the winrate
-    if (closed_trades.size() > 0)
+    if (this->total_trades > 0)
     {
-        this->win_rate = static_cast<double>(this->total_winning_trades) / static_cast<double>(closed_trades.size());
+        this->win_rate = static_cast<double>(this->total_winning_trades) / static_cast<double>(this->total_trades);
     }
 
     // Calculate the winrate for longs
@@ -411,206 +480,39 @@ void Stats::calculate_profit_factor()
 }
 
 /**
- * @brief Calculate the maximum profit and loss.
- * @param closed_trades Vector of Trade objects.
+ * @brief Record the return of the current month in the monthly returns and in accumulators of their variance.
+ * @param returns Accumulator of the monthly returns.
+ * @param negative_returns Accumulator of the negative monthly returns.
  */
-void Stats::calculate_maximum_profit_loss_stats(const std::vector<Trade> &closed_trades)
+void Stats::add_monthly_return(RunningVariance &returns, RunningVariance &negative_returns)
 {
-    // Calculate the maximum profit
-    if (this->total_winning_trades > 0)
-    {
-        this->max_profit = (*std::max_element(closed_trades.begin(), closed_trades.end(), [](Trade a, Trade b)
-                                              { return a.pnl < b.pnl; }))
-                               .pnl;
-    }
+    double monthly_return = decimal_round(this->current_month_return - 1.0, 4);
+    this->monthly_returns[this->current_month_key] = monthly_return;
 
-    // Calculate the maximum loss
-    if (this->total_losing_trades > 0)
+    returns.add(monthly_return);
+    if (monthly_return < 0)
     {
-        this->max_loss = (*std::min_element(closed_trades.begin(), closed_trades.end(), [](Trade a, Trade b)
-                                            { return a.pnl < b.pnl; }))
-                             .pnl;
+        negative_returns.add(monthly_return);
     }
 }
 
 /**
- * @brief Calculate the maximum consecutive profit and loss.
- * @param closed_trades Vector of Trade objects.
+ * @brief Add a value to the accumulator (Welford's algorithm).
+ * @param value The value to add.
  */
-void Stats::calculate_maximum_consecutive_winning_lost_trades_stats(const std::vector<Trade> &closed_trades)
+void RunningVariance::add(double value)
 {
-    // Calculate the maximum consecutive winning trades
-    this->max_consecutive_winning_trades = 0;
-    int current_consecutive_winning_trades = 0;
-    for (const auto &trade : closed_trades)
-    {
-        if (trade.pnl >= 0)
-        {
-            current_consecutive_winning_trades++;
-            this->max_consecutive_winning_trades = std::max(this->max_consecutive_winning_trades, current_consecutive_winning_trades);
-        }
-        else
-        {
-            current_consecutive_winning_trades = 0;
-        }
-    }
-
-    // Calculate the maximum consecutive lost trades
-    this->max_consecutive_losing_trades = 0;
-    int current_consecutive_lost_trades = 0;
-    for (const auto &trade : closed_trades)
-    {
-        if (trade.pnl < 0)
-        {
-            current_consecutive_lost_trades++;
-            this->max_consecutive_losing_trades = std::max(this->max_consecutive_losing_trades, current_consecutive_lost_trades);
-        }
-        else
-        {
-            current_consecutive_lost_trades = 0;
-        }
-    }
+    this->count++;
+    double delta = value - this->mean;
+    this->mean += delta / static_cast<double>(this->count);
+    this->m2 += delta * (value - this->mean);
 }
 
 /**
- * @brief Calculate the maximum consecutive profit and loss.
- * @param closed_trades Vector of Trade objects.
+ * @brief Get the population variance of the values added.
+ * @return The variance, 0 without value.
  */
-void Stats::calculate_maximum_consecutive_profit_loss_stats(const std::vector<Trade> &closed_trades)
+double RunningVariance::variance() const
 {
-    // Calculate the maximum consecutive profit
-    this->max_consecutive_profit = 0;
-    double current_consecutive_profit = 0;
-    for (const auto &trade : closed_trades)
-    {
-        if (trade.pnl >= 0)
-        {
-            current_consecutive_profit += trade.pnl;
-            this->max_consecutive_profit = std::max(this->max_consecutive_profit, current_consecutive_profit);
-        }
-        else
-        {
-            current_consecutive_profit = 0;
-        }
-    }
-
-    // Calculate the maximum consecutive loss
-    this->max_consecutive_loss = 0;
-    double current_consecutive_loss = 0;
-    for (const auto &trade : closed_trades)
-    {
-        if (trade.pnl < 0)
-        {
-            current_consecutive_loss += trade.pnl;
-            this->max_consecutive_loss = std::min(this->max_consecutive_loss, current_consecutive_loss);
-        }
-        else
-        {
-            current_consecutive_loss = 0;
-        }
-    }
+    return this->count > 0 ? this->m2 / static_cast<double>(this->count) : 0.0;
 }
-
-/**
- * @brief Calculate the average trade duration.
- * @param closed_trades Vector of Trade objects.
- */
-void Stats::calculate_average_trade_duration(const std::vector<Trade> &closed_trades)
-{
-    if (this->total_trades > 0)
-    {
-        double total_duration = 0;
-        for (auto &trade : closed_trades)
-        {
-            total_duration += trade.duration;
-        }
-        this->average_trade_duration = total_duration / static_cast<double>(this->total_trades);
-    }
-}
-
-/**
- * @brief Calculate the monthly returns.
- * @param closed_trades Vector of Trade objects.
- */
-void Stats::calculate_monthly_returns(const std::vector<Trade> &closed_trades)
-{
-    for (const auto &trade : closed_trades)
-    {
-        double trade_return = trade.pnl_net_percent;
-        std::string date_key = time_t_to_string(trade.exit_date, "%Y-%m");
-        if (this->monthly_returns.find(date_key) == this->monthly_returns.end())
-        {
-            this->monthly_returns[date_key] = 1.0;
-        }
-        this->monthly_returns[date_key] *= (1.0 + trade_return);
-    }
-
-    for (const auto &[month, monthly_return] : this->monthly_returns)
-    {
-        this->monthly_returns[month] = decimal_round(monthly_return - 1.0, 4);
-    }
-}
-
-/**
- * @brief Calculate the average investment return.
- * @param closed_trades Vector of Trade objects.
- */
-void Stats::calculate_average_investment_return(const std::vector<Trade> &closed_trades)
-{
-    if (this->monthly_returns.size() > 0)
-    {
-        for (const auto &[month, performance] : this->monthly_returns)
-        {
-            this->average_investment_return += performance / static_cast<double>(this->monthly_returns.size());
-        }
-    }
-}
-
-/**
- * @brief Calculate the Sharpe ratio.
- * @param closed_trades Vector of Trade objects.
- */
-void Stats::calculate_sharpe_ratio(const std::vector<Trade> &closed_trades)
-{
-    if (this->monthly_returns.size() > 0)
-    {
-        std::vector<double> monthly_investment_returns = {};
-        for (const auto &[month, performance] : this->monthly_returns)
-        {
-            monthly_investment_returns.push_back(performance);
-        }
-
-        double std_dev = calculate_standard_deviation(monthly_investment_returns, monthly_investment_returns.size()).back();
-        if (std_dev != 0)
-        {
-            this->sharpe_ratio = (average_investment_return - 0.0) / std_dev;
-        }
-    }
-}
-
-/**
- * @brief Calculate the Sortino ratio.
- * @param closed_trades Vector of Trade objects.
- */
-void Stats::calculate_sortino_ratio(const std::vector<Trade> &closed_trades)
-{
-    std::vector<double> monthly_investment_returns_negative = {};
-    std::vector<double> monthly_investment_returns = {};
-    for (const auto &[month, performance] : this->monthly_returns)
-    {
-        monthly_investment_returns.push_back(performance);
-        if (performance < 0)
-        {
-            monthly_investment_returns_negative.push_back(performance);
-        }
-    }
-
-    if (monthly_investment_returns_negative.size() > 0)
-    {
-        double std_dev = calculate_standard_deviation(monthly_investment_returns_negative, monthly_investment_returns_negative.size()).back();
-        if (std_dev != 0)
-        {
-            this->sortino_ratio = (average_investment_return - 0.0) / std_dev;
-        }
-    }
-}
\ No newline at end of file
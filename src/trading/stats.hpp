@@ -1,11 +1,34 @@
 #ifndef TRADING_STATS_HPP
 #define TRADING_STATS_HPP
 
+#include <string>
 #include <vector>
 #include <map>
 #include "../libs/json.hpp"
 #include "../types.hpp"
 
+/**
+ * @brief Running mean and variance of a series of values, updated in constant time (Welford's algorithm).
+ */
+struct RunningVariance
+{
+    int count = 0;     // Number of values
+    double mean = 0.0; // Mean of the values
+    double m2 = 0.0;   // Sum of the squared differences to the mean
+
+    /**
+     * @brief Add a value to the accumulator (Welford's algorithm).
+     * @param value The value to add.
+     */
+    void add(double value);
+
+    /**
+     * @brief Get the population variance of the values added.
+     * @return The variance, 0 without value.
+     */
+    double variance() const;
+};
+
 class Stats
 {
 public:
@@ -65,6 +88,25 @@ public:
      */
     void calculate(std::vector<Trade> &trades_history, std::vector<double> &balance_history);
 
+    /**
+     * @brief Add the balance of the trader at a new candle.
+     * @param balance Balance of the trader.
+     */
+    void add_balance(double balance);
+
+    /**
+     * @brief Add a trade once it is closed, the trades must be added in the order they are closed.
+     * @param trade The closed trade.
+     */
+    void add_trade(const Trade &trade);
+
+    /**
+     * @brief Calculate the statistics which depend on all the balances and trades added.
+     *
+     * The accumulation is not changed, more balances and trades can be added and the statistics finished again.
+     */
+    void finish();
+
     /**
      * @brief Convert the statistics to a JSON object.
      * @return JSON object.
@@ -84,34 +126,31 @@ public:
     void print() const;
 
 private:
+    // Online accumulation of the balances and the trades (see add_balance and add_trade)
+    int nb_balances = 0;                               // Number of balances added
+    double last_balance = 0.0;                         // Last balance added
+    double peak_balance = 0.0;                         // Highest balance added
+    double trough_balance = 0.0;                       // Lowest balance added since the peak
+    int current_consecutive_winning_trades = 0;        // Number of winning trades of the current series
+    int current_consecutive_losing_trades = 0;         // Number of losing trades of the current series
+    double current_consecutive_profit = 0.0;           // Profit of the current series of winning trades
+    double current_consecutive_loss = 0.0;             // Loss of the current series of losing trades
+    double total_trade_duration = 0.0;                 // Sum of the durations of the trades
+    int current_month = 0;                             // Month of the last trade as YYYYMM, 0 without trade
+    std::string current_month_key;                     // Key of the current month in the monthly returns
+    double current_month_return = 1.0;                 // Compounded return of the current month
+    RunningVariance monthly_returns_variance;          // Accumulator of the returns of the complete months
+    RunningVariance negative_monthly_returns_variance; // Accumulator of the negative returns of the complete months
+
     /**
      * @brief Calculate the performance.
      */
     void calculate_performance();
 
     /**
-     * @brief Calculate the total number of trades (long/short trades, winning/lost trades).
-     * @param closed_trades Vector of Trade objects.
-     */
-    void calculate_total_trades_stats(const std::vector<Trade> &closed_trades);
-
-    /**
-     * @brief Calculate the total net profit, total profit, total loss and total fees.
-     * @param closed_trades Vector of Trade objects.
-     */
-    void calculate_profit_loss_stats(const std::vector<Trade> &closed_trades);
-
-    /**
-     * @brief Calculate the maximum drawdown.
-     * @param balance_history Vector of double.
-     */
-    void calculate_max_drawdown(const std::vector<double> &balance_history);
-
-    /**
-     * @brief Calculate the total profit.
-     * @param closed_trades Vector of Trade objects.
+     * @brief Calculate the win rates.
      */
-    void calculate_winrate_stats(const std::vector<Trade> &closed_trades);
+    void calculate_winrate_stats();
 
     /**
      * @brief Calculate the average profit and loss per trade.
@@ -124,52 +163,11 @@ private:
     void calculate_profit_factor();
 
     /**
-     * @brief Calculate the maximum profit and loss.
-     * @param closed_trades Vector of Trade objects.
-     */
-    void calculate_maximum_profit_loss_stats(const std::vector<Trade> &closed_trades);
-
-    /**
-     * @brief Calculate the maximum consecutive profit and loss.
-     * @param closed_trades Vector of Trade objects.
-     */
-    void calculate_maximum_consecutive_winning_lost_trades_stats(const std::vector<Trade> &closed_trades);
-
-    /**
-     * @brief Calculate the maximum consecutive profit and loss.
-     * @param closed_trades Vector of Trade objects.
-     */
-    void calculate_maximum_consecutive_profit_loss_stats(const std::vector<Trade> &closed_trades);
-
-    /**
-     * @brief Calculate the average trade duration.
-     * @param closed_trades Vector of Trade objects.
-     */
-    void calculate_average_trade_duration(const std::vector<Trade> &closed_trades);
-
-    /**
-     * @brief Calculate the monthly returns.
-     * @param closed_trades Vector of Trade objects.
-     */
-    void calculate_monthly_returns(const std::vector<Trade> &closed_trades);
-
-    /**
-     * @brief Calculate the average investment return.
-     * @param closed_trades Vector of Trade objects.
-     */
-    void calculate_average_investment_return(const std::vector<Trade> &closed_trades);
-
-    /**
-     * @brief Calculate the Sharpe ratio.
-     * @param closed_trades Vector of Trade objects.
-     */
-    void calculate_sharpe_ratio(const std::vector<Trade> &closed_trades);
-
-    /**
-     * @brief Calculate the Sortino ratio.
-     * @param closed_trades Vector of Trade objects.
+     * @brief Record the return of the current month in the monthly returns and in accumulators of their variance.
+     * @param returns Accumulator of the monthly returns.
+     * @param negative_returns Accumulator of the negative monthly returns.
      */
-    void calculate_sortino_ratio(const std::vector<Trade> &closed_trades);
+    void add_monthly_return(RunningVariance &returns, RunningVariance &negative_returns);
 };
 
 #endif // TRADING_STATS_HPP
\ No newline at end of file
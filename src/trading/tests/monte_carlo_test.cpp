@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "../monte_carlo.hpp"
+#include "../../types.hpp"
+#include "../../utils/thread_pool.hpp"
+
+TEST(MonteCarloTest, GetTradesReturns)
+{
+    std::vector<Trade> trades(3);
+    trades[0].pnl_net_percent = 0.02;
+    trades[0].closed = true;
+    trades[1].pnl_net_percent = -0.01;
+    trades[1].closed = true;
+    trades[2].pnl_net_percent = 0.05;
+    trades[2].closed = false;
+
+    // Only the closed trades are resampled
+    std::vector<double> returns = get_trades_returns(trades);
+    ASSERT_EQ(returns, std::vector<double>({0.02, -0.01}));
+}
+
+TEST(MonteCarloTest, CalculatePercentile)
+{
+    std::vector<double> values = {1, 2, 3, 4, 5, 6, 7, 8};
+    ASSERT_EQ(calculate_percentile(values, 0), 1);
+    ASSERT_EQ(calculate_percentile(values, 0.25), 3);
+    ASSERT_EQ(calculate_percentile(values, 0.75), 7);
+    ASSERT_EQ(calculate_percentile(values, 1), 8);
+}
+
+TEST(MonteCarloTest, WinRateSimulation)
+{
+    // All the trades are won, every simulation has the same balance without drawdown
+    MonteCarloResults results = run_win_rate_simulation(1.0, 2.0, 0.01, 10, 1000, 100, 42);
+    double expected_balance = 1000 * std::pow(1.02, 10);
+    ASSERT_NEAR(results.final_balance.minimum, expected_balance, 1e-9);
+    ASSERT_NEAR(results.final_balance.maximum, expected_balance, 1e-9);
+    ASSERT_EQ(results.max_drawdown.maximum, 0);
+
+    // All the trades are lost, the drawdown is the loss of the balance
+    results = run_win_rate_simulation(0.0, 2.0, 0.01, 10, 1000, 100, 42);
+    ASSERT_NEAR(results.final_balance.median, 1000 * std::pow(0.99, 10), 1e-9);
+    ASSERT_NEAR(results.max_drawdown.median, 1 - std::pow(0.99, 10), 1e-12);
+
+    ASSERT_THROW(run_win_rate_simulation(0.5, 2.0, 0.01, 10, 1000, 0, 42), std::invalid_argument);
+}
+
+TEST(MonteCarloTest, BootstrapSimulation)
+{
+    std::vector<double> returns = {0.03, -0.01, 0.02, -0.02, 0.01};
+    MonteCarloResults results = run_bootstrap_simulation(returns, 50, 1000, 1000, 42);
+
+    // The distributions are ordered
+    for (const auto &distribution : {results.final_balance, results.max_drawdown})
+    {
+        ASSERT_LE(distribution.minimum, distribution.percentile_5);
+        ASSERT_LE(distribution.percentile_5, distribution.lower_quartile);
+        ASSERT_LE(distribution.lower_quartile, distribution.median);
+        ASSERT_LE(distribution.median, distribution.upper_quartile);
+        ASSERT_LE(distribution.upper_quartile, distribution.percentile_95);
+        ASSERT_LE(distribution.percentile_95, distribution.maximum);
+    }
+    ASSERT_GT(results.final_balance.minimum, 1000 * std::pow(0.98, 50));
+    ASSERT_LT(results.final_balance.maximum, 1000 * std::pow(1.03, 50));
+    ASSERT_GE(results.max_drawdown.minimum, 0);
+    ASSERT_LT(results.max_drawdown.maximum, 1);
+
+    // A single trade is always drawn
+    results = run_bootstrap_simulation({0.01}, 10, 1000, 10, 42);
+    ASSERT_NEAR(results.final_balance.minimum, 1000 * std::pow(1.01, 10), 1e-9);
+
+    ASSERT_THROW(run_bootstrap_simulation({}, 10, 1000, 10, 42), std::invalid_argument);
+}
+
+TEST(MonteCarloTest, ParallelSimulation)
+{
+    // The simulations give the same results whatever the number of threads
+    std::vector<double> returns = {0.03, -0.01, 0.02, -0.02, 0.01};
+    MonteCarloResults serial_results = run_bootstrap_simulation(returns, 100, 1000, 100000, 42);
+
+    ThreadPool thread_pool(4);
+    MonteCarloResults parallel_results = run_bootstrap_simulation(returns, 100, 1000, 100000, 42, &thread_pool);
+    ASSERT_EQ(parallel_results.final_balance.minimum, serial_results.final_balance.minimum);
+    ASSERT_EQ(parallel_results.final_balance.median, serial_results.final_balance.median);
+    ASSERT_EQ(parallel_results.final_balance.maximum, serial_results.final_balance.maximum);
+    ASSERT_EQ(parallel_results.max_drawdown.percentile_95, serial_results.max_drawdown.percentile_95);
+
+    // Another seed gives other simulations
+    MonteCarloResults other_results = run_bootstrap_simulation(returns, 100, 1000, 100000, 43, &thread_pool);
+    ASSERT_NE(other_results.final_balance.minimum, serial_results.final_balance.minimum);
+}
@@ -160,4 +160,31 @@ TEST_F(TradingScheduleTest, TestHasSessionForDay)
     ASSERT_TRUE(has_session_for_day(4, schedule));
     ASSERT_TRUE(has_session_for_day(5, schedule));
     ASSERT_FALSE(has_session_for_day(6, schedule));
-}
\ No newline at end of file
+}
+TEST_F(TradingScheduleTest, TestGetBarCalendar)
+{
+    std::tm date = {};
+    date.tm_year = 2023 - 1900;
+    date.tm_mon = 10;
+    date.tm_mday = 3;
+    date.tm_hour = 12;
+
+    // Friday during the schedule
+    BarCalendar calendar = get_bar_calendar(std::mktime(&date), TimeFrame::H1, schedule);
+    ASSERT_EQ(calendar.day, 20231103);
+    ASSERT_TRUE(calendar.tradable);
+    ASSERT_FALSE(calendar.next_is_rest_day);
+
+    // Last bar of Friday, the next bar is on Saturday
+    date.tm_hour = 23;
+    calendar = get_bar_calendar(std::mktime(&date), TimeFrame::H1, schedule);
+    ASSERT_EQ(calendar.day, 20231103);
+    ASSERT_FALSE(calendar.tradable);
+    ASSERT_TRUE(calendar.next_is_rest_day);
+
+    // Always tradable without schedule
+    calendar = get_bar_calendar(std::mktime(&date), TimeFrame::H1, std::nullopt);
+    ASSERT_EQ(calendar.day, 20231103);
+    ASSERT_TRUE(calendar.tradable);
+    ASSERT_FALSE(calendar.next_is_rest_day);
+}
@@ -71,6 +71,23 @@ TEST_F(StatsTest, ProfitLossStats)
     ASSERT_EQ(stats.total_net_profit, 420);
 }
 
+TEST_F(StatsTest, FractionalLosses)
+{
+    this->trades_history = {
+        {.pnl = 10.5, .closed = true},
+        {.pnl = -0.75, .closed = true},
+        {.pnl = -1.5, .closed = true},
+    };
+
+    stats.calculate(this->trades_history, this->balance_history);
+
+    // The losses are not truncated to integers
+    ASSERT_DOUBLE_EQ(stats.total_loss, 2.25);
+    ASSERT_DOUBLE_EQ(stats.average_loss, 1.125);
+    ASSERT_DOUBLE_EQ(stats.total_net_profit, 8.25);
+    ASSERT_NEAR(stats.profit_factor, 10.5 / 2.25, 1e-12);
+}
+
 TEST_F(StatsTest, MaxDrawdown)
 {
     this->balance_history = {1000.0, 900.0, 1100.0, 1000.0};
@@ -368,4 +385,51 @@ TEST_F(StatsTest, JSON)
     ASSERT_EQ(stats.monthly_returns, stats_from_json.monthly_returns);
     ASSERT_EQ(stats.sharpe_ratio, stats_from_json.sharpe_ratio);
     ASSERT_EQ(stats.sortino_ratio, stats_from_json.sortino_ratio);
-}
\ No newline at end of file
+}
+TEST_F(StatsTest, OnlineAccumulation)
+{
+    std::vector<double> balances = {1000.0, 1100.0, 1050.0, 900.0, 1200.0, 1150.0};
+    std::vector<Trade> trades;
+    for (int i = 0; i < 6; i++)
+    {
+        std::tm exit_tm = {.tm_mday = 1 + 5 * i, .tm_mon = i / 2, .tm_year = 2023 - 1900};
+        double pnl = (i % 3 == 1) ? -40.0 * i : 30.0 * (i + 1);
+        trades.push_back(Trade{
+            .side = i % 2 == 0 ? PositionSide::LONG : PositionSide::SHORT,
+            .exit_date = std::mktime(&exit_tm),
+            .pnl = pnl,
+            .pnl_net_percent = pnl / 1000.0,
+            .fees = 1.0,
+            .duration = i + 2,
+            .closed = true,
+        });
+    }
+
+    Stats expected = Stats(1000.0);
+    expected.calculate(trades, balances);
+
+    // Add the balances and the trades as they come during the simulation, finishing the statistics on the way
+    Stats online = Stats(1000.0);
+    for (size_t i = 0; i < balances.size(); i++)
+    {
+        online.add_balance(balances[i]);
+        online.add_trade(trades[i]);
+        online.finish();
+    }
+
+    ASSERT_EQ(online.final_balance, expected.final_balance);
+    ASSERT_EQ(online.performance, expected.performance);
+    ASSERT_EQ(online.total_trades, 6);
+    ASSERT_EQ(online.total_winning_trades, expected.total_winning_trades);
+    ASSERT_EQ(online.total_losing_long_trades, expected.total_losing_long_trades);
+    ASSERT_DOUBLE_EQ(online.total_net_profit, expected.total_net_profit);
+    ASSERT_DOUBLE_EQ(online.max_drawdown, (1100.0 - 900.0) / 1100.0);
+    ASSERT_DOUBLE_EQ(online.profit_factor, expected.profit_factor);
+    ASSERT_EQ(online.max_consecutive_losing_trades, expected.max_consecutive_losing_trades);
+    ASSERT_DOUBLE_EQ(online.max_consecutive_profit, expected.max_consecutive_profit);
+    ASSERT_DOUBLE_EQ(online.average_trade_duration, 4.5);
+    ASSERT_EQ(online.monthly_returns, expected.monthly_returns);
+    ASSERT_EQ(online.monthly_returns.size(), 3);
+    ASSERT_DOUBLE_EQ(online.sharpe_ratio, expected.sharpe_ratio);
+    ASSERT_DOUBLE_EQ(online.sortino_ratio, expected.sortino_ratio);
+}
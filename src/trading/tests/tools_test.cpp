@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
 #include "../tools.hpp"
+#include "../../indicators/volatility.hpp"
 #include "../../types.hpp"
 
 // Test fixture for trading tools
@@ -204,6 +208,81 @@ TEST_F(TradingToolsTest, CalculateTpSlPriceWithATR)
     ASSERT_TRUE(sl_short > 1.020000 && sl_short < 1.02500);
 }
 
+TEST_F(TradingToolsTest, CalculateTpSlPriceWithLevels)
+{
+    double market_price = 1.020000;
+    TakeProfitStopLossConfig config;
+    config.type_take_profit = TypeTakeProfitStopLoss::ATR;
+    config.take_profit_atr_period = 3;
+    config.take_profit_atr_multiplier = 2.0;
+    config.type_stop_loss = TypeTakeProfitStopLoss::EXTREMUM;
+    config.stop_loss_extremum_period = 3;
+
+    time_t now = std::time(nullptr);
+    std::vector<Candle> candles = {
+        Candle{now, 1.01400, 1.01650, 1.01350, 1.015000, 0.0, 0.0, 0.0},
+        Candle{now, 1.01500, 1.02000, 1.01350, 1.018000, 0.0, 0.0, 0.0},
+        Candle{now, 1.01800, 1.02200, 1.01750, 1.021000, 0.0, 0.0, 0.0},
+        Candle{now, 1.02100, 1.02500, 1.02000, 1.021500, 0.0, 0.0, 0.0},
+        Candle{now, 1.02100, 1.02200, 1.01850, 1.020000, 0.0, 0.0, 0.0},
+    };
+
+    // The levels are computed from the last candles
+    TpSlLevels levels = calculate_tp_sl_levels(candles, config);
+    ASSERT_DOUBLE_EQ(levels.stop_loss_highest_high, 1.02500);
+    ASSERT_DOUBLE_EQ(levels.stop_loss_lowest_low, 1.01750);
+    ASSERT_GT(levels.take_profit_atr, 0.0);
+
+    // The prices are the same from the candles and from their levels
+    for (PositionSide side : {PositionSide::LONG, PositionSide::SHORT})
+    {
+        auto from_candles = calculate_tp_sl_price(market_price, candles, side, config, symbol_infos);
+        auto from_levels = calculate_tp_sl_price(market_price, levels, side, config, symbol_infos);
+        ASSERT_DOUBLE_EQ(std::get<0>(from_candles), std::get<0>(from_levels));
+        ASSERT_DOUBLE_EQ(std::get<1>(from_candles), std::get<1>(from_levels));
+    }
+
+    // The multiplier of the ATR is applied
+    auto prices = calculate_tp_sl_price(market_price, levels, PositionSide::LONG, config, symbol_infos);
+    ASSERT_DOUBLE_EQ(std::get<0>(prices), market_price + 2.0 * levels.take_profit_atr);
+    ASSERT_DOUBLE_EQ(std::get<1>(prices), 1.01750);
+}
+
+TEST_F(TradingToolsTest, RollingSeries)
+{
+    std::vector<Candle> candles;
+    for (int i = 0; i < 50; i++)
+    {
+        double open = 1.0 + 0.01 * std::sin(i * 0.7);
+        double close = 1.0 + 0.01 * std::sin(i * 0.7 + 0.5);
+        candles.push_back(Candle{i * 60, open, std::max(open, close) + 0.002 * (i % 3), std::min(open, close) - 0.001 * (i % 4), close, 0.0, 0.0, 0.0});
+    }
+
+    // The rolling ATR is the same as the ATR indicator over the whole timeline
+    std::vector<double> expected_atr = ATR(14).calculate(candles, false);
+    std::vector<double> rolling_atr = calculate_rolling_atr(candles, 14);
+    ASSERT_EQ(rolling_atr.size(), candles.size());
+    for (size_t i = 0; i < candles.size(); i++)
+    {
+        ASSERT_NEAR(rolling_atr[i], expected_atr[i], 1e-12);
+    }
+
+    // The rolling extremums are the same as the extremums of the last candles
+    std::vector<double> highest_high = calculate_rolling_highest_high(candles, 5);
+    std::vector<double> lowest_low = calculate_rolling_lowest_low(candles, 5);
+    for (size_t i = 0; i < candles.size(); i++)
+    {
+        double expected_high = candles[i].high, expected_low = candles[i].low;
+        for (size_t j = i >= 4 ? i - 4 : 0; j < i; j++)
+        {
+            expected_high = std::max(expected_high, candles[j].high);
+            expected_low = std::min(expected_low, candles[j].low);
+        }
+        ASSERT_DOUBLE_EQ(highest_high[i], expected_high);
+        ASSERT_DOUBLE_EQ(lowest_low[i], expected_low);
+    }
+}
+
 // Test case for calculate_liquidation_price function
 TEST_F(TradingToolsTest, CalculateLiquidationPrice)
 {
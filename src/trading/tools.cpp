@@ -1,6 +1,10 @@
+#include <algorithm>
 #include <cmath>
+#include <deque>
+#include <stdexcept>
 #include <tuple>
 #include <string>
+#include <vector>
 #include "../types.hpp"
 #include "../utils/math.hpp"
 #include "../indicators/volatility.hpp"
@@ -93,17 +97,194 @@ double calculate_initial_margin(double market_price, int leverage, SymbolInfo sy
     return initial_margin;
 }
 
+/**
+ * @brief Calculate the rolling Average True Range of a timeline, smoothed like the ATR indicator.
+ *
+ * @param candles The candles of the timeline.
+ * @param period The period of the ATR.
+ * @return The ATR at each candle, 0 before the first full period.
+ */
+std::vector<double> calculate_rolling_atr(const CandlesView &candles, int period)
+{
+    std::vector<double> atr_values(candles.size(), 0.0);
+    if (period <= 0 || candles.size() < static_cast<size_t>(period))
+    {
+        return atr_values;
+    }
+
+    double sum = 0.0;
+    for (size_t i = 0; i < candles.size(); ++i)
+    {
+        double tr = candles[i].high - candles[i].low;
+        if (i > 0)
+        {
+            tr = std::max(tr, std::max(std::abs(candles[i].high - candles[i - 1].close), std::abs(candles[i].low - candles[i - 1].close)));
+        }
+
+        // Average of the first period, then smoothed
+        if (i < static_cast<size_t>(period))
+        {
+            sum += tr;
+            if (i == static_cast<size_t>(period) - 1)
+            {
+                atr_values[i] = sum / period;
+            }
+        }
+        else
+        {
+            atr_values[i] = (atr_values[i - 1] * (period - 1) + tr) / period;
+        }
+    }
+
+    return atr_values;
+}
+
+/**
+ * @brief Calculate the rolling extremum of the candles of a timeline over a period.
+ *
+ * @param candles The candles of the timeline.
+ * @param period The number of candles of the period, ending with the current one.
+ * @param highest True for the highest high, false for the lowest low.
+ * @return The extremum at each candle, over the available candles at the start of the timeline.
+ */
+static std::vector<double> calculate_rolling_extremum(const CandlesView &candles, int period, bool highest)
+{
+    std::vector<double> extremum_values(candles.size(), 0.0);
+    std::deque<size_t> window; // Indexes of the candidates for the extremum, with monotonic prices
+    auto price = [&](size_t i)
+    { return highest ? candles[i].high : candles[i].low; };
+
+    for (size_t i = 0; i < candles.size(); ++i)
+    {
+        // Remove the candidates that can no longer be the extremum
+        while (!window.empty() && (highest ? price(window.back()) <= price(i) : price(window.back()) >= price(i)))
+        {
+            window.pop_back();
+        }
+        window.push_back(i);
+
+        // Remove the candle going out of the period
+        if (period > 0 && window.front() + period <= i)
+        {
+            window.pop_front();
+        }
+
+        extremum_values[i] = price(window.front());
+    }
+
+    return extremum_values;
+}
+
+/**
+ * @brief Calculate the rolling highest high of a timeline.
+ *
+ * @param candles The candles of the timeline.
+ * @param period The number of candles of the period, ending with the current one.
+ * @return The highest high at each candle.
+ */
+std::vector<double> calculate_rolling_highest_high(const CandlesView &candles, int period)
+{
+    return calculate_rolling_extremum(candles, period, true);
+}
+
+/**
+ * @brief Calculate the rolling lowest low of a timeline.
+ *
+ * @param candles The candles of the timeline.
+ * @param period The number of candles of the period, ending with the current one.
+ * @return The lowest low at each candle.
+ */
+std::vector<double> calculate_rolling_lowest_low(const CandlesView &candles, int period)
+{
+    return calculate_rolling_extremum(candles, period, false);
+}
+
+/**
+ * @brief Calculate the levels used to place the take profit and stop loss orders from the last candles.
+ *
+ * @param candles The historical candle data, as a view over the candle timeline.
+ * @param config Configuration for take profit and stop loss.
+ * @return The levels at the last candle, only the ones used by the configuration are set.
+ */
+TpSlLevels calculate_tp_sl_levels(const CandlesView &candles, const TakeProfitStopLossConfig &config)
+{
+    TpSlLevels levels;
+
+    // Extremums over the last candles of the period
+    auto last_extremums = [&](int period, double &highest_high, double &lowest_low)
+    {
+        size_t begin = candles.size() > static_cast<size_t>(period) ? candles.size() - period : 0;
+        highest_high = candles[begin].high;
+        lowest_low = candles[begin].low;
+        for (size_t i = begin + 1; i < candles.size(); i++)
+        {
+            highest_high = std::max(highest_high, candles[i].high);
+            lowest_low = std::min(lowest_low, candles[i].low);
+        }
+    };
+
+    // ATR computed over all the candles
+    auto last_atr = [&](int period)
+    {
+        std::vector<double> atr_values = ATR(period).calculate(candles.to_vector(), false);
+        return atr_values[atr_values.size() - 1];
+    };
+
+    if (config.type_take_profit == TypeTakeProfitStopLoss::EXTREMUM)
+    {
+        if (!config.take_profit_extremum_period.has_value())
+        {
+            throw std::invalid_argument("Take profit extremum period is not set.");
+        }
+        last_extremums(config.take_profit_extremum_period.value(), levels.take_profit_highest_high, levels.take_profit_lowest_low);
+    }
+    else if (config.type_take_profit == TypeTakeProfitStopLoss::ATR)
+    {
+        levels.take_profit_atr = last_atr(config.take_profit_atr_period.value_or(14));
+    }
+
+    if (config.type_stop_loss == TypeTakeProfitStopLoss::EXTREMUM)
+    {
+        if (!config.stop_loss_extremum_period.has_value())
+        {
+            throw std::invalid_argument("Stop loss extremum period is not set.");
+        }
+        last_extremums(config.stop_loss_extremum_period.value(), levels.stop_loss_highest_high, levels.stop_loss_lowest_low);
+    }
+    else if (config.type_stop_loss == TypeTakeProfitStopLoss::ATR)
+    {
+        levels.stop_loss_atr = last_atr(config.stop_loss_atr_period.value_or(14));
+    }
+
+    return levels;
+}
+
 /**
  * @brief Calculate take profit and stop loss prices based on the provided configuration.
  *
  * @param market_price The current market price.
- * @param candles The historical candle data.
+ * @param candles The historical candle data, as a view over the candle timeline.
+ * @param side The position side (LONG or SHORT).
+ * @param config Configuration for take profit and stop loss.
+ * @param symbol_info Symbol information including precision details.
+ * @return The calculated take profit and stop loss prices.
+ */
+std::tuple<double, double> calculate_tp_sl_price(double market_price, const CandlesView &candles, PositionSide side, const TakeProfitStopLossConfig &config, const SymbolInfo &symbol_info)
+{
+    return calculate_tp_sl_price(market_price, calculate_tp_sl_levels(candles, config), side, config, symbol_info);
+}
+
+/**
+ * @brief Calculate take profit and stop loss prices based on the provided configuration and the levels of the current candle.
+ *
+ * @param market_price The current market price.
+ * @param levels The levels of the current candle (see calculate_tp_sl_levels).
  * @param side The position side (LONG or SHORT).
  * @param config Configuration for take profit and stop loss.
  * @param symbol_info Symbol information including precision details.
  * @return The calculated take profit and stop loss prices.
  */
-std::tuple<double, double> calculate_tp_sl_price(double market_price, std::vector<Candle> candles, PositionSide side, TakeProfitStopLossConfig config, SymbolInfo symbol_info)
+std::tuple<double, double> calculate_tp_sl_price(double market_price, const TpSlLevels &levels, PositionSide side, const TakeProfitStopLossConfig &config, const SymbolInfo &symbol_info)
 {
     double tp_price = 0.0, sl_price = 0.0;
     if (config.type_take_profit == TypeTakeProfitStopLoss::POINTS)
@@ -111,7 +292,6 @@ std::tuple<double, double> calculate_tp_sl_price(double market_price, std::vecto
         if (!config.take_profit_in_points.has_value())
         {
             throw std::invalid_argument("Take profit in points is not set.");
-            std::exit(1);
         }
 
         if (side == PositionSide::LONG)
@@ -128,7 +308,6 @@ std::tuple<double, double> calculate_tp_sl_price(double market_price, std::vecto
         if (!config.take_profit_in_percent.has_value())
         {
             throw std::invalid_argument("Take profit in percent is not set.");
-            std::exit(1);
         }
 
         if (side == PositionSide::LONG)
@@ -142,59 +321,18 @@ std::tuple<double, double> calculate_tp_sl_price(double market_price, std::vecto
     }
     else if (config.type_take_profit == TypeTakeProfitStopLoss::EXTREMUM)
     {
-        if (!config.take_profit_extremum_period.has_value())
-        {
-            throw std::invalid_argument("Take profit extremum period is not set.");
-            std::exit(1);
-        }
-
-        if (side == PositionSide::LONG)
-        {
-            double highest_high = 0.0;
-            for (int i = candles.size() - config.take_profit_extremum_period.value(); i < candles.size(); i++)
-            {
-                if (candles[i].high > highest_high)
-                {
-                    highest_high = candles[i].high;
-                }
-            }
-            tp_price = highest_high;
-        }
-        else
-        {
-            double lowest_low = candles[0].low;
-            for (int i = 0; i < config.take_profit_extremum_period.value(); i++)
-            {
-                if (candles[i].low < lowest_low)
-                {
-                    lowest_low = candles[i].low;
-                }
-            }
-            tp_price = lowest_low;
-        }
+        tp_price = side == PositionSide::LONG ? levels.take_profit_highest_high : levels.take_profit_lowest_low;
     }
     else if (config.type_take_profit == TypeTakeProfitStopLoss::ATR)
     {
-        if (!config.take_profit_atr_period.has_value())
-        {
-            config.take_profit_atr_period = 14; // Default value
-        }
-
-        if (config.take_profit_atr_multiplier.has_value())
-        {
-            config.take_profit_atr_multiplier = 1.0; // Default value
-        }
-
-        ATR atr_indicator = ATR(config.take_profit_atr_period.value());
-        std::vector<double> atr_values = atr_indicator.calculate(candles, false);
-        double atr = atr_values[atr_values.size() - 1];
+        double multiplier = config.take_profit_atr_multiplier.value_or(1.0);
         if (side == PositionSide::LONG)
         {
-            tp_price = market_price + atr * config.take_profit_atr_multiplier.value();
+            tp_price = market_price + levels.take_profit_atr * multiplier;
         }
         else
         {
-            tp_price = market_price - atr * config.take_profit_atr_multiplier.value();
+            tp_price = market_price - levels.take_profit_atr * multiplier;
         }
     }
 
@@ -203,7 +341,6 @@ std::tuple<double, double> calculate_tp_sl_price(double market_price, std::vecto
         if (!config.stop_loss_in_points.has_value())
         {
             throw std::invalid_argument("Stop loss in points is not set.");
-            std::exit(1);
         }
 
         if (side == PositionSide::LONG)
@@ -220,7 +357,6 @@ std::tuple<double, double> calculate_tp_sl_price(double market_price, std::vecto
         if (!config.stop_loss_in_percent.has_value())
         {
             throw std::invalid_argument("Stop loss in percent is not set.");
-            std::exit(1);
         }
 
         if (side == PositionSide::LONG)
@@ -234,58 +370,18 @@ std::tuple<double, double> calculate_tp_sl_price(double market_price, std::vecto
     }
     else if (config.type_stop_loss == TypeTakeProfitStopLoss::EXTREMUM)
     {
-        if (!config.stop_loss_extremum_period.has_value())
-        {
-            throw std::invalid_argument("Stop loss extremum period is not set.");
-            std::exit(1);
-        }
-
-        if (side == PositionSide::LONG)
-        {
-            double lowest_low = candles[0].low;
-            for (int i = 0; i < config.stop_loss_extremum_period.value(); i++)
-            {
-                if (candles[i].low < lowest_low)
-                {
-                    lowest_low = candles[i].low;
-                }
-            }
-            sl_price = lowest_low;
-        }
-        else
-        {
-            double highest_high = 0.0;
-            for (int i = candles.size() - config.stop_loss_extremum_period.value(); i < candles.size(); i++)
-            {
-                if (candles[i].high > highest_high)
-                {
-                    highest_high = candles[i].high;
-                }
-            }
-            sl_price = highest_high;
-        }
+        sl_price = side == PositionSide::LONG ? levels.stop_loss_lowest_low : levels.stop_loss_highest_high;
     }
     else if (config.type_stop_loss == TypeTakeProfitStopLoss::ATR)
     {
-        if (!config.stop_loss_atr_period.has_value())
-        {
-            config.stop_loss_atr_period = 14; // Default value
-        }
-
-        if (!config.stop_loss_atr_multiplier.has_value())
-        {
-            config.stop_loss_atr_multiplier = 1.0; // Default value
-        }
-
-        std::vector<double> atr_values = ATR(config.stop_loss_atr_period.value()).calculate(candles, false);
-        double atr = atr_values[atr_values.size() - 1];
+        double multiplier = config.stop_loss_atr_multiplier.value_or(1.0);
         if (side == PositionSide::LONG)
         {
-            sl_price = market_price - atr * config.stop_loss_atr_multiplier.value();
+            sl_price = market_price - levels.stop_loss_atr * multiplier;
         }
         else
         {
-            sl_price = market_price + atr * config.stop_loss_atr_multiplier.value();
+            sl_price = market_price + levels.stop_loss_atr * multiplier;
         }
     }
 
@@ -4,6 +4,7 @@
 #include <cmath>
 #include <tuple>
 #include <string>
+#include <vector>
 #include "../types.hpp"
 
 /**
@@ -61,17 +62,65 @@ double calculate_position_size(double market_price, double account_equity, doubl
  */
 double calculate_initial_margin(double market_price, int leverage, SymbolInfo symbol_info, double base_currency_conversion_rate = 1.0);
 
+/**
+ * @brief Calculate the rolling Average True Range of a timeline, smoothed like the ATR indicator.
+ *
+ * @param candles The candles of the timeline.
+ * @param period The period of the ATR.
+ * @return The ATR at each candle, 0 before the first full period.
+ */
+std::vector<double> calculate_rolling_atr(const CandlesView &candles, int period);
+
+/**
+ * @brief Calculate the rolling highest high of a timeline.
+ *
+ * @param candles The candles of the timeline.
+ * @param period The number of candles of the period, ending with the current one.
+ * @return The highest high at each candle.
+ */
+std::vector<double> calculate_rolling_highest_high(const CandlesView &candles, int period);
+
+/**
+ * @brief Calculate the rolling lowest low of a timeline.
+ *
+ * @param candles The candles of the timeline.
+ * @param period The number of candles of the period, ending with the current one.
+ * @return The lowest low at each candle.
+ */
+std::vector<double> calculate_rolling_lowest_low(const CandlesView &candles, int period);
+
+/**
+ * @brief Calculate the levels used to place the take profit and stop loss orders from the last candles.
+ *
+ * @param candles Historical price data, as a view over the candle timeline.
+ * @param config Configuration for take profit and stop loss.
+ * @return The levels at the last candle, only the ones used by the configuration are set.
+ */
+TpSlLevels calculate_tp_sl_levels(const CandlesView &candles, const TakeProfitStopLossConfig &config);
+
 /**
  * @brief Calculate take profit and stop loss prices based on the provided configuration.
  *
  * @param market_price The current market price.
- * @param candles Historical price data.
+ * @param candles Historical price data, as a view over the candle timeline.
+ * @param side The position side (LONG or SHORT).
+ * @param config Configuration for take profit and stop loss.
+ * @param symbol_info Symbol information including precision details.
+ * @return The calculated take profit and stop loss prices.
+ */
+std::tuple<double, double> calculate_tp_sl_price(double market_price, const CandlesView &candles, PositionSide side, const TakeProfitStopLossConfig &config, const SymbolInfo &symbol_info);
+
+/**
+ * @brief Calculate take profit and stop loss prices based on the provided configuration and the levels of the current candle.
+ *
+ * @param market_price The current market price.
+ * @param levels The levels of the current candle (see calculate_tp_sl_levels).
  * @param side The position side (LONG or SHORT).
  * @param config Configuration for take profit and stop loss.
  * @param symbol_info Symbol information including precision details.
  * @return The calculated take profit and stop loss prices.
  */
-std::tuple<double, double> calculate_tp_sl_price(double market_price, std::vector<Candle> candles, PositionSide side, TakeProfitStopLossConfig config, SymbolInfo symbol_info);
+std::tuple<double, double> calculate_tp_sl_price(double market_price, const TpSlLevels &levels, PositionSide side, const TakeProfitStopLossConfig &config, const SymbolInfo &symbol_info);
 
 /**
  * @brief Calculate the liquidation price for a trading position.
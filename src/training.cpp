@@ -4,25 +4,43 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <map>
 #include <functional>
 #include <chrono>
 #include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+#include <spawn.h>
+#include <sys/wait.h>
 #include <random>
+#include <future>
+#include <sstream>
 #include "types.hpp"
 #include "configs/serialization.hpp"
 #include "utils/logger.hpp"
 #include "utils/indexer.hpp"
 #include "utils/uid.hpp"
 #include "utils/cache.hpp"
+#include "utils/hash.hpp"
 #include "utils/read_data.hpp"
 #include "utils/time_frame.hpp"
 #include "utils/date_conversion.hpp"
 #include "utils/progress_bar.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/random.hpp"
 #include "utils/math.hpp"
 #include "utils/vectors.hpp"
+#include "trading/monte_carlo.hpp"
+#include "trading/schedule.hpp"
+#include "trading/tools.hpp"
 #include "neat/population.hpp"
 #include "neat/genome.hpp"
+#include "neat/math_utils.hpp"
 #include "libs/json.hpp"
 #include "libs/gnuplot-iostream.hpp"
 #include "indicators/utils.hpp"
@@ -30,16 +48,42 @@
 #include "symbols.hpp"
 #include "trader.hpp"
 
+/**
+ * @brief Write the content of a file to a temporary file renamed afterwards, so the readers never see a partial file.
+ * @param file_path Path to the file.
+ * @param content Content of the file.
+ */
+static void write_file_atomically(const std::filesystem::path &file_path, const std::string &content)
+{
+    std::filesystem::path temporary_file = file_path.generic_string() + ".tmp";
+    {
+        std::ofstream file(temporary_file, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            throw std::runtime_error("unable to open the file '" + temporary_file.generic_string() + "'");
+        }
+        file.write(content.data(), content.size());
+        if (!file)
+        {
+            throw std::runtime_error("unable to write the file '" + temporary_file.generic_string() + "'");
+        }
+    }
+    std::filesystem::rename(temporary_file, file_path);
+}
+
 /**
  * @brief Constructor for the Training class.
  * @param id Unique identifier for the training process.
  * @param config_file_path Path to the configuration file.
  * @param debug Debug mode flag.
+ * @param island Index of the island evolved by the training in the island mode. Default is -1, without islands.
+ * @param coordinator Flag of the process running the islands, it prepares the data without a population of its own. Default is false.
  */
-Training::Training(std::string id, std::filesystem::path config_file_path, bool debug)
+Training::Training(std::string id, std::filesystem::path config_file_path, bool debug, int island, bool coordinator)
 {
     this->id = id;
     this->debug = debug;
+    this->island = island;
 
     std::cout << "🚀 Start the training process with the id '" << id << "'" << std::endl;
 
@@ -48,8 +92,12 @@ Training::Training(std::string id, std::filesystem::path config_file_path, bool
         std::cout << "🐞 Debug mode is enabled." << std::endl;
     }
 
-    // Create the directory
+    // Create the directory, each island has its own directory in the one of the training
     this->directory = "reports/" + id;
+    if (this->island >= 0)
+    {
+        this->directory /= "island_" + std::to_string(this->island);
+    }
     if (!std::filesystem::exists(this->directory))
     {
         std::cout << "📂 Create the directory '" << this->directory.generic_string() << "'" << std::endl;
@@ -58,10 +106,12 @@ Training::Training(std::string id, std::filesystem::path config_file_path, bool
 
     // Set the file paths
     this->config_file_path = config_file_path;
-    this->cache_file = "./cache/data_" + id + ".json";
+    this->cache_file = "./cache/data_" + id + ".bin";
     this->fitness_report_file = this->directory.generic_string() + "/fitness_report.png";
-    this->population_save_file = this->directory.generic_string() + "/population_save.json";
+    this->population_save_file = this->directory.generic_string() + "/population_save.bin";
     this->training_save_file = this->directory.generic_string() + "/training_save.json";
+    this->migrations_directory = "reports/" + id + "/migrations";
+    this->islands_save_file = "reports/" + id + "/islands_save.json";
 
     // Initialize the data structures
     this->candles = {};
@@ -72,16 +122,20 @@ Training::Training(std::string id, std::filesystem::path config_file_path, bool
     // Conversion rate when the base of asset traded is different of the account currency
     this->base_currency_conversion_rate = {};
     this->cache = new Cache(this->cache_file.generic_string());
+    this->nb_features = 0;
 
     // History for statistics
     this->current_generation = 0;
     this->best_trader = nullptr;
     this->current_generation_traders = {};
+    this->evaluation_hash = 0;
     this->best_fitnesses = {};
     this->average_fitnesses = {};
+    this->population = nullptr;
 
-    // Check if a training state exists
-    if (std::filesystem::exists(this->training_save_file) && std::filesystem::exists(this->population_save_file))
+    // Check if a training state exists, the population can also be saved in the JSON file of the previous versions
+    std::filesystem::path population_json_file = std::filesystem::path(this->population_save_file).replace_extension(".json");
+    if (!coordinator && std::filesystem::exists(this->training_save_file) && (std::filesystem::exists(this->population_save_file) || std::filesystem::exists(population_json_file)))
     {
         std::cout << "⏳ Load the training progress..." << std::endl;
         this->load();
@@ -122,8 +176,19 @@ Training::Training(std::string id, std::filesystem::path config_file_path, bool
         this->config.neat.num_inputs = this->count_indicators() + this->config.training.inputs.position.size();
         this->config.neat.num_outputs = 3; // Buy, Sell, Wait
 
-        std::cout << "⏳ Initialize the population..." << std::endl;
-        this->population = new neat::Population(this->config.neat, true);
+        // The coordinator only prepares the data, the islands evolve their own populations
+        if (!coordinator)
+        {
+            std::cout << "⏳ Initialize the population..." << std::endl;
+            this->population = new neat::Population(this->get_neat_config(), true);
+        }
+    }
+
+    // A single pool of threads runs all the parallel work of the training, the genomes of the population included
+    this->thread_pool = new ThreadPool(std::max(0, this->config.neat.num_threads));
+    if (this->population != nullptr)
+    {
+        this->population->set_thread_pool(this->thread_pool);
     }
 }
 
@@ -132,12 +197,18 @@ Training::Training(std::string id, std::filesystem::path config_file_path, bool
  */
 Training::~Training()
 {
+    // Finish the writing of the last save
+    this->wait_save();
+
     // Delete the dynamically allocated population
     delete population;
 
     // Delete the dynamically allocated cache
     delete cache;
 
+    // Stop the threads of the pool
+    delete thread_pool;
+
     // Delete the dynamically allocated best trader overall
     if (best_trader != nullptr)
     {
@@ -181,15 +252,39 @@ void Training::prepare()
         std::exit(1);
     }
 
+    // Load the cache if it was built with the same configuration
+    uint64_t config_hash = this->calculate_config_hash();
+    bool cache_loaded = false;
     if (this->cache->exist())
+    {
+        try
+        {
+            Cache *loaded_cache = Cache::load(this->cache_file.generic_string());
+            if (loaded_cache->config_hash == config_hash)
+            {
+                delete this->cache;
+                this->cache = loaded_cache;
+                cache_loaded = true;
+            }
+            else
+            {
+                std::cout << "⚠️ The configuration has changed since the creation of the cache, it will be rebuilt." << std::endl;
+                delete loaded_cache;
+            }
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cout << "⚠️ " << e.what() << ", it will be rebuilt." << std::endl;
+        }
+    }
+
+    if (cache_loaded)
     {
         std::cout << "⏳ Import the data from '" << this->cache_file.generic_string() << "'" << std::endl;
-        this->cache = Cache::load(this->cache_file.generic_string());
 
         // Save the dates for the training and test periods
-        for (const auto &[date_string, data] : this->cache->data)
+        for (const auto &date : this->cache->get_dates())
         {
-            time_t date = std::stol(date_string);
             if (date >= this->config.training.training_start_date && date <= this->config.training.test_end_date)
             {
                 this->dates.push_back(date);
@@ -208,6 +303,8 @@ void Training::prepare()
     }
     else
     {
+        this->cache->config_hash = config_hash;
+
         // Progress bar
         std::cout << "⏳ Load the candles..." << std::endl;
         this->load_candles(true);
@@ -225,6 +322,10 @@ void Training::prepare()
         this->cache_data(true);
         std::cout << "✅ Cache created!" << std::endl;
     }
+
+    std::cout << "⏳ Load the features..." << std::endl;
+    this->load_features(true);
+    std::cout << "✅ Features loaded!" << std::endl;
 }
 
 /**
@@ -234,20 +335,24 @@ void Training::prepare()
 void Training::load_candles(bool display_progress)
 {
     std::vector<TimeFrame> all_timeframes = this->get_all_timeframes();
-    TimeFrame highest_timeframe = highest_time_frame(all_timeframes);
     TimeFrame loop_timeframe = this->config.strategy.timeframe;
-    CandlesData candles = {};
 
-    // Load the candles from data for all the timeframes
+    // Load the candles from data for all the timeframes in parallel
+    std::vector<std::future<std::vector<Candle>>> timelines = {};
     for (const TimeFrame &tf : all_timeframes)
     {
         time_t start_date = this->config.training.training_start_date - 7 * 24 * 60 * 60; // 7 days before the training start date
         time_t end_date = this->config.training.test_end_date;
-        candles[tf] = read_data(config.general.symbol, tf, start_date, end_date);
+        timelines.push_back(this->thread_pool->submit([this, tf, start_date, end_date]()
+                                                      { return read_data(this->config.general.symbol, tf, start_date, end_date); }));
+    }
+    for (size_t i = 0; i < all_timeframes.size(); i++)
+    {
+        this->candles[all_timeframes[i]] = timelines[i].get();
     }
 
     // Save the dates for the training and test periods
-    for (const auto &candle : candles[loop_timeframe])
+    for (const auto &candle : this->candles[loop_timeframe])
     {
         time_t date = candle.date;
         if (date >= this->config.training.training_start_date && date <= this->config.training.test_end_date)
@@ -267,41 +372,38 @@ void Training::load_candles(bool display_progress)
     // Progress bar
     ProgressBar *progress_bar = display_progress ? new ProgressBar(100, this->dates.size()) : nullptr;
 
-    // Loop through the dates and get the candles for each timeframe
+    // The dates are sorted, so the indexer only moves forward in the timelines
+    Indexer *indexer = new Indexer(this->candles, CANDLES_WINDOW);
+    std::vector<time_t> incomplete_dates = {};
+
+    // Loop through the dates and get the window of candles for each timeframe
     for (const auto &date : this->dates)
     {
-        CandlesData current_candles = {};
-        Indexer *indexer = new Indexer(candles, CANDLES_WINDOW);
+        CandlesViews current_candles = {};
+        bool complete = true;
         indexer->update_indexes(date);
 
         // Get the candles for the current date
         for (const auto &tf : all_timeframes)
         {
             std::pair<int, int> index = indexer->get_indexes(tf);
-
-            for (int i = index.first; i <= index.second; i++)
-            {
-                current_candles[tf].push_back(candles[tf][i]);
-            }
+            current_candles[tf] = this->candles[tf].empty() ? CandlesView() : CandlesView(this->candles[tf], index.first, index.second + 1);
 
             if (current_candles[tf].size() < CANDLES_WINDOW)
             {
-                // Remove the date from the list
-                this->dates.erase(std::remove(this->dates.begin(), this->dates.end(), date), this->dates.end());
-                this->training_dates.erase(std::remove(this->training_dates.begin(), this->training_dates.end(), date), this->training_dates.end());
-                this->test_dates.erase(std::remove(this->test_dates.begin(), this->test_dates.end(), date), this->test_dates.end());
+                complete = false;
             }
         }
 
-        // If the date is in the list of dates (with at least CANDLES_WINDOW candles for each timeframe)
-        if (std::find(this->dates.begin(), this->dates.end(), date) != this->dates.end())
+        // Save the candles if there are at least CANDLES_WINDOW candles for each timeframe
+        if (complete)
         {
-            // Save the candles for the current date
-            this->candles[date] = current_candles;
+            this->candles_windows[date] = current_candles;
+        }
+        else
+        {
+            incomplete_dates.push_back(date);
         }
-
-        // Free the indexer
-        delete indexer;
 
         if (progress_bar)
         {
@@ -309,13 +411,24 @@ void Training::load_candles(bool display_progress)
         }
     }
 
+    // Free the indexer
+    delete indexer;
+
+    // Remove the dates without enough candles from the lists
+    for (const auto &date : incomplete_dates)
+    {
+        this->dates.erase(std::remove(this->dates.begin(), this->dates.end(), date), this->dates.end());
+        this->training_dates.erase(std::remove(this->training_dates.begin(), this->training_dates.end(), date), this->training_dates.end());
+        this->test_dates.erase(std::remove(this->test_dates.begin(), this->test_dates.end(), date), this->test_dates.end());
+    }
+
     if (progress_bar)
     {
         progress_bar->complete();
         delete progress_bar;
     }
 
-    if (this->candles.empty())
+    if (this->candles_windows.empty())
     {
         std::cerr << "Error: no candles loaded for the training." << std::endl;
         std::exit(1);
@@ -324,6 +437,7 @@ void Training::load_candles(bool display_progress)
 
 /**
  * @brief Calculate and store all indicator values to the cache.
+ * With the `precompute_indicators` option, each indicator is calculated once on the whole timeline of its time frame.
  * @param display_progress Flag to show the progress bar. Default is false.
  */
 void Training::load_indicators(bool display_progress)
@@ -353,58 +467,107 @@ void Training::load_indicators(bool display_progress)
     }
 
     std::map<TimeFrame, std::vector<Indicator *>> all_indicators = config.training.inputs.indicators;
+    bool precompute_indicators = this->config.training.precompute_indicators.value_or(false);
+    bool has_values = this->config.strategy.can_open_long_trade.value_or(true) || (this->config.strategy.can_open_short_trade.value_or(true) && this->config.strategy.can_close_trade.value_or(false));
+    bool has_reverse_values = this->config.strategy.can_open_short_trade.value_or(true) || (this->config.strategy.can_open_long_trade.value_or(true) && this->config.strategy.can_close_trade.value_or(false));
     ProgressBar *progress_bar = display_progress ? new ProgressBar(100, this->dates.size()) : nullptr;
 
-    // Loop through the dates
+    // Calculate the raw values of the indicators once on the whole timelines in parallel, they are normalized on the window of each date
+    std::map<TimeFrame, std::map<std::string, std::vector<double>>> indicators_series = {};
+    if (precompute_indicators)
+    {
+        std::vector<std::pair<TimeFrame, Indicator *>> series_to_calculate = {};
+        for (auto const &[tf, indicators] : all_indicators)
+        {
+            for (auto const &indicator : indicators)
+            {
+                indicators_series[tf][indicator->id_params] = {};
+                series_to_calculate.push_back({tf, indicator});
+            }
+        }
+
+        this->thread_pool->parallel_for(
+            series_to_calculate.size(), [&](size_t i)
+            {
+                auto [tf, indicator] = series_to_calculate[i];
+                indicators_series.at(tf).at(indicator->id_params) = indicator->calculate(this->candles.at(tf), false); });
+    }
+
+    // Create the entries of all the dates, so they can be filled from several threads
     for (const auto &date : this->dates)
     {
         this->indicators[date] = {};
+    }
 
-        // Loop through all the indicators and calculate the values
-        for (auto const &[tf, indicators] : all_indicators)
+    // Split the dates in chunks calculated in parallel
+    size_t nb_chunks = std::min(this->dates.size(), 8 * this->thread_pool->size());
+    this->thread_pool->parallel_for(
+        nb_chunks, [&](size_t chunk)
         {
-            for (auto const &indicator : indicators)
+            for (size_t d = chunk * this->dates.size() / nb_chunks; d < (chunk + 1) * this->dates.size() / nb_chunks; d++)
             {
-                // Get the candles for the current date
-                std::vector<Candle> current_candles = this->candles[date][tf];
+                time_t date = this->dates[d];
+                IndicatorsData &current_indicators = this->indicators.at(date);
 
-                // Calculate the indicator values
-                if (current_candles.size() >= CANDLES_WINDOW)
+                // Loop through all the indicators and calculate the values
+                for (auto const &[tf, indicators] : all_indicators)
                 {
-                    std::vector<double> values = indicator->calculate(current_candles, !this->debug);
-                    std::vector<double> reverse_values = reverse_vector(values, indicator->values_range);
-
-                    for (int i = 0; i < INDICATOR_WINDOW; i++)
+                    for (auto const &indicator : indicators)
                     {
-                        if (this->config.strategy.can_open_long_trade.value_or(true) || (this->config.strategy.can_open_short_trade.value_or(true) && this->config.strategy.can_close_trade.value_or(false)))
+                        // Get the candles for the current date
+                        const CandlesView &current_candles = this->candles_windows.at(date).at(tf);
+
+                        // Calculate the indicator values
+                        if (current_candles.size() >= CANDLES_WINDOW)
                         {
-                            this->indicators[date][tf][indicator->id].push_back(values[values.size() - INDICATOR_WINDOW + i]);
+                            std::vector<double> values = {};
+                            if (precompute_indicators)
+                            {
+                                // Slice the values of the window in the precomputed series
+                                const std::vector<double> &series = indicators_series.at(tf).at(indicator->id_params);
+                                values.assign(series.begin() + current_candles.begin_index, series.begin() + current_candles.end_index);
+                                if (!this->debug)
+                                {
+                                    values = normalize_vector(values, indicator->values_range);
+                                }
+                            }
+                            else
+                            {
+                                values = indicator->calculate(current_candles.to_vector(), !this->debug);
+                            }
+                            std::vector<double> reverse_values = reverse_vector(values, indicator->values_range);
+
+                            for (int i = 0; i < INDICATOR_WINDOW; i++)
+                            {
+                                if (has_values)
+                                {
+                                    current_indicators[tf][indicator->id].push_back(values[values.size() - INDICATOR_WINDOW + i]);
+                                }
+                                if (has_reverse_values)
+                                {
+                                    current_indicators[tf][indicator->id + "-reverse"].push_back(reverse_values[reverse_values.size() - INDICATOR_WINDOW + i]);
+                                }
+                            }
                         }
-                        if (this->config.strategy.can_open_short_trade.value_or(true) || (this->config.strategy.can_open_long_trade.value_or(true) && this->config.strategy.can_close_trade.value_or(false)))
+                        else
                         {
-                            this->indicators[date][tf][indicator->id + "-reverse"].push_back(reverse_values[reverse_values.size() - INDICATOR_WINDOW + i]);
+                            if (has_values)
+                            {
+                                current_indicators[tf][indicator->id] = std::vector<double>(INDICATOR_WINDOW, 0.0);
+                            }
+                            if (has_reverse_values)
+                            {
+                                current_indicators[tf][indicator->id + "-reverse"] = std::vector<double>(INDICATOR_WINDOW, 0.0);
+                            }
                         }
                     }
                 }
-                else
+
+                if (progress_bar)
                 {
-                    if (this->config.strategy.can_open_long_trade.value_or(true) || (this->config.strategy.can_open_short_trade.value_or(true) && this->config.strategy.can_close_trade.value_or(false)))
-                    {
-                        this->indicators[date][tf][indicator->id] = std::vector<double>(INDICATOR_WINDOW, 0.0);
-                    }
-                    if (this->config.strategy.can_open_short_trade.value_or(true) || (this->config.strategy.can_open_long_trade.value_or(true) && this->config.strategy.can_close_trade.value_or(false)))
-                    {
-                        this->indicators[date][tf][indicator->id + "-reverse"] = std::vector<double>(INDICATOR_WINDOW, 0.0);
-                    }
+                    progress_bar->update(1);
                 }
-            }
-        }
-
-        if (progress_bar)
-        {
-            progress_bar->update(1);
-        }
-    }
+            } });
 
     if (progress_bar)
     {
@@ -425,9 +588,9 @@ void Training::load_base_currency_conversion_rate(bool display_progress)
 
     if (account_currency == base_currency_traded)
     {
-        ProgressBar *progress_bar = display_progress ? new ProgressBar(100, this->candles.size()) : nullptr;
+        ProgressBar *progress_bar = display_progress ? new ProgressBar(100, this->candles_windows.size()) : nullptr;
 
-        for (const auto &[date, candles_data] : this->candles)
+        for (const auto &[date, candles_data] : this->candles_windows)
         {
             base_currency_conversion_rate[date] = 1.0;
 
@@ -481,52 +644,159 @@ void Training::cache_data(bool display_progress)
 
     ProgressBar *progress_bar = display_progress ? new ProgressBar(100, dates.size()) : nullptr;
 
-    for (const auto &date : this->dates)
-    {
-        CandlesData current_candles = {};
-        IndicatorsData current_indicators = {};
-        double current_base_currency_conversion_rate = {};
+    // The windows of the cache are views of its own copy of the timelines
+    this->cache->candles = this->candles;
 
-        // Get the candles for the current date
-        for (const auto &[timeframe, candles] : this->candles[date])
+    // Build the data of the dates in parallel, they are added to the cache in order afterwards
+    std::vector<CachedData> dates_data(this->dates.size());
+    size_t nb_chunks = std::min(this->dates.size(), 8 * this->thread_pool->size());
+    this->thread_pool->parallel_for(
+        nb_chunks, [&](size_t chunk)
         {
-            current_candles[timeframe] = candles;
-        }
+            for (size_t d = chunk * this->dates.size() / nb_chunks; d < (chunk + 1) * this->dates.size() / nb_chunks; d++)
+            {
+                time_t date = this->dates[d];
+                CandlesViews current_candles = {};
+                IndicatorsData current_indicators = {};
+                double current_base_currency_conversion_rate = {};
 
-        // Get the indicators for the current date
-        for (const auto &[timeframe, indicators] : this->indicators[date])
+                // Get the candles for the current date
+                for (const auto &[timeframe, candles] : this->candles_windows.at(date))
+                {
+                    current_candles[timeframe] = CandlesView(this->cache->candles.at(timeframe), candles.begin_index, candles.end_index);
+                }
+
+                // Get the indicators for the current date
+                for (const auto &[timeframe, indicators] : this->indicators.at(date))
+                {
+                    current_indicators[timeframe] = indicators;
+                }
+
+                // Get the base currency conversion rate of the last candle for the current date
+                const CandlesView &loop_candles = current_candles[loop_timeframe];
+                if (!loop_candles.empty())
+                {
+                    auto rate = base_currency_conversion_rate.find(loop_candles.back().date);
+                    current_base_currency_conversion_rate = rate != base_currency_conversion_rate.end() ? rate->second : 1.0;
+                }
+
+                dates_data[d] = CachedData{
+                    .candles = current_candles,
+                    .indicators = current_indicators,
+                    .base_currency_conversion_rate = current_base_currency_conversion_rate,
+                };
+
+                if (progress_bar)
+                {
+                    progress_bar->update(1);
+                }
+            } });
+
+    // Cache the data
+    for (size_t d = 0; d < this->dates.size(); d++)
+    {
+        this->cache->add(this->dates[d], std::move(dates_data[d]));
+    }
+
+    // Create the file of the cache, its sections are built in parallel
+    this->cache->create(this->thread_pool);
+
+    if (progress_bar)
+    {
+        progress_bar->complete();
+        delete progress_bar;
+    }
+}
+
+/**
+ * @brief Build the feature matrix from the cached indicators, in the order the traders look at them.
+ * @param display_progress Flag to show the progress bar. Default is false.
+ */
+void Training::load_features(bool display_progress)
+{
+    size_t nb_dates = this->cache->size();
+    this->nb_features = this->count_indicators();
+    this->features.assign(nb_dates * this->nb_features, 0.0);
+    this->calendar.assign(nb_dates, BarCalendar());
+    this->tp_sl_levels.assign(nb_dates, TpSlLevels());
+
+    // Find the timeline of the strategy time frame, shared by the windows of all the dates
+    TimeFrame timeframe = this->config.strategy.timeframe;
+    CandlesView timeline;
+    for (size_t d = 0; d < nb_dates; d++)
+    {
+        const CandlesViews &candles = this->cache->at(d).candles;
+        auto it = candles.find(timeframe);
+        if (it != candles.end() && it->second.end_index > timeline.end_index)
         {
-            current_indicators[timeframe] = indicators;
+            timeline = CandlesView(it->second.timeline, 0, it->second.end_index);
         }
+    }
 
-        // Get the base currency conversion rate for the current date
-        for (const auto &candle : current_candles[loop_timeframe])
+    // Compute the rolling series used to place the take profit and stop loss orders once for the whole timeline
+    const TakeProfitStopLossConfig &tp_sl_config = this->config.strategy.take_profit_stop_loss_config;
+    std::vector<double> take_profit_atr, take_profit_highest_high, take_profit_lowest_low;
+    std::vector<double> stop_loss_atr, stop_loss_highest_high, stop_loss_lowest_low;
+    auto load_series = [&](TypeTakeProfitStopLoss type, const std::optional<int> &extremum_period, const std::optional<int> &atr_period, std::vector<double> &atr, std::vector<double> &highest_high, std::vector<double> &lowest_low)
+    {
+        if (type == TypeTakeProfitStopLoss::EXTREMUM)
         {
-            if (base_currency_conversion_rate.find(candle.date) != base_currency_conversion_rate.end())
-            {
-                current_base_currency_conversion_rate = base_currency_conversion_rate[candle.date];
-            }
-            else
+            if (!extremum_period.has_value())
             {
-                current_base_currency_conversion_rate = 1.0;
+                throw std::invalid_argument("The extremum period of the take profit or the stop loss is not set.");
             }
+            highest_high = calculate_rolling_highest_high(timeline, extremum_period.value());
+            lowest_low = calculate_rolling_lowest_low(timeline, extremum_period.value());
         }
-
-        // Cache the data
-        this->cache->add(std::to_string(date), CachedData{
-                                                   .candles = current_candles,
-                                                   .indicators = current_indicators,
-                                                   .base_currency_conversion_rate = current_base_currency_conversion_rate,
-                                               });
-
-        if (progress_bar)
+        else if (type == TypeTakeProfitStopLoss::ATR)
         {
-            progress_bar->update(1);
+            atr = calculate_rolling_atr(timeline, atr_period.value_or(14));
         }
+    };
+    load_series(tp_sl_config.type_take_profit, tp_sl_config.take_profit_extremum_period, tp_sl_config.take_profit_atr_period, take_profit_atr, take_profit_highest_high, take_profit_lowest_low);
+    load_series(tp_sl_config.type_stop_loss, tp_sl_config.stop_loss_extremum_period, tp_sl_config.stop_loss_atr_period, stop_loss_atr, stop_loss_highest_high, stop_loss_lowest_low);
+    auto at_bar = [](const std::vector<double> &series, size_t bar)
+    { return bar < series.size() ? series[bar] : 0.0; };
+
+    // Fill the rows of the dates with the last values of the indicators, each row is the same as the inputs of Trader::look
+    std::vector<std::pair<TimeFrame, std::string>> indicators_ids = Trader::get_indicators_inputs_ids(this->config);
+    if (indicators_ids.size() != this->nb_features)
+    {
+        throw std::runtime_error("Invalid number of indicator inputs: " + std::to_string(indicators_ids.size()) + " instead of " + std::to_string(this->nb_features));
     }
+    this->cache->get_last_indicators_values(indicators_ids, this->features.data());
 
-    // Create the file of the cache
-    this->cache->create();
+    ProgressBar *progress_bar = display_progress ? new ProgressBar(100, nb_dates) : nullptr;
+
+    // Fill the calendar and the levels of the dates in parallel
+    size_t nb_chunks = std::min(nb_dates, 8 * this->thread_pool->size());
+    this->thread_pool->parallel_for(
+        nb_chunks, [&](size_t chunk)
+        {
+            for (size_t d = chunk * nb_dates / nb_chunks; d < (chunk + 1) * nb_dates / nb_chunks; d++)
+            {
+                // Compute the calendar fields and read the levels of the last candle the traders see at this date
+                const CandlesViews &candles = this->cache->at(d).candles;
+                auto it = candles.find(timeframe);
+                if (it != candles.end() && !it->second.empty())
+                {
+                    this->calendar[d] = get_bar_calendar(it->second.back().date, timeframe, this->config.strategy.trading_schedule);
+
+                    size_t bar = it->second.end_index - 1;
+                    TpSlLevels &levels = this->tp_sl_levels[d];
+                    levels.take_profit_atr = at_bar(take_profit_atr, bar);
+                    levels.take_profit_highest_high = at_bar(take_profit_highest_high, bar);
+                    levels.take_profit_lowest_low = at_bar(take_profit_lowest_low, bar);
+                    levels.stop_loss_atr = at_bar(stop_loss_atr, bar);
+                    levels.stop_loss_highest_high = at_bar(stop_loss_highest_high, bar);
+                    levels.stop_loss_lowest_low = at_bar(stop_loss_lowest_low, bar);
+                }
+
+                if (progress_bar)
+                {
+                    progress_bar->update(1);
+                }
+            } });
 
     if (progress_bar)
     {
@@ -588,32 +858,132 @@ std::vector<TimeFrame> Training::get_all_timeframes() const
 }
 
 /**
- * @brief Evaluate the performance of a trading algorithm for a given genome and generation.
- * @param genome The genome to be evaluated.
- * @param generation The current generation number.
+ * @brief Calculate the hash of the configuration parameters the prepared data depend on.
+ * @return Hash of the configuration used to check if the cache is up to date.
  */
-void Training::evaluate_genome(neat::Genome *genome, int generation)
+uint64_t Training::calculate_config_hash() const
 {
-    TimeFrame loop_timeframe = this->config.strategy.timeframe;
-    int loop_timeframe_minutes = get_time_frame_in_minutes(loop_timeframe);
+    uint64_t hash = hash_string(this->config.general.symbol);
+    hash = hash_string(this->config.general.account_currency, hash);
+    hash = hash_combine(hash, static_cast<uint64_t>(this->config.strategy.timeframe));
+    hash = hash_combine(hash, static_cast<uint64_t>(this->config.training.training_start_date));
+    hash = hash_combine(hash, static_cast<uint64_t>(this->config.training.training_end_date));
+    hash = hash_combine(hash, static_cast<uint64_t>(this->config.training.test_start_date));
+    hash = hash_combine(hash, static_cast<uint64_t>(this->config.training.test_end_date));
+    hash = hash_combine(hash, static_cast<uint64_t>(this->config.strategy.can_open_long_trade.value_or(true)));
+    hash = hash_combine(hash, static_cast<uint64_t>(this->config.strategy.can_open_short_trade.value_or(true)));
+    hash = hash_combine(hash, static_cast<uint64_t>(this->config.strategy.can_close_trade.value_or(false)));
+    hash = hash_combine(hash, static_cast<uint64_t>(CANDLES_WINDOW));
+    hash = hash_combine(hash, static_cast<uint64_t>(INDICATOR_WINDOW));
+    hash = hash_combine(hash, static_cast<uint64_t>(this->config.training.precompute_indicators.value_or(false)));
+
+    // The indicators are not normalized in debug mode
+    hash = hash_combine(hash, static_cast<uint64_t>(this->debug));
 
-    Trader *trader = new Trader(genome, this->config);
+    for (const auto &[tf, indicators] : this->config.training.inputs.indicators)
+    {
+        hash = hash_combine(hash, static_cast<uint64_t>(tf));
+        for (const auto &indicator : indicators)
+        {
+            hash = hash_string(indicator->id_params, hash);
+        }
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Calculate the hash of the configuration the evaluations of the traders depend on.
+ * @return Hash of the data and of the whole configuration.
+ */
+uint64_t Training::calculate_evaluation_hash() const
+{
+    uint64_t hash = this->calculate_config_hash();
+    hash = hash_string(config_to_json(this->config).dump(), hash);
+    hash = hash_combine(hash, static_cast<uint64_t>(this->training_dates.size()));
+    return hash;
+}
+
+/**
+ * @brief Get the configuration of the NEAT algorithm, each island evolves from its own seed derived from the one of the configuration.
+ * @return The configuration of the NEAT algorithm of the population.
+ */
+neat::Config Training::get_neat_config() const
+{
+    neat::Config neat_config = this->config.neat;
+
+    // The islands start from the same configuration, they would evolve identical populations with the same seed
+    if (this->island >= 0 && neat_config.seed != 0)
+    {
+        neat_config.seed = derive_seed(neat_config.seed, this->island);
+    }
+    return neat_config;
+}
+
+/**
+ * @brief Restore the evaluation of a trader from the trader of the last generation with an identical genome.
+ * The fitness, the score, the stats, the fitness details and the histories are copied instead of running the trader again.
+ * @param trader The trader to restore, not evaluated yet.
+ * @param genome_hash The hash of the genome of the trader.
+ * @return True if the evaluation was restored, false if no identical genome was evaluated in the last generation.
+ */
+bool Training::restore_evaluation(Trader *trader, uint64_t genome_hash)
+{
+    // The traders write their logs in debug mode, they are always run
     if (this->debug)
     {
-        trader->logger = new Logger(this->directory.generic_string() + "/logs/training/trader_" + genome->id + ".log");
+        return false;
+    }
+
+    auto it = this->evaluated_traders.find(hash_combine(this->evaluation_hash, genome_hash));
+    if (it == this->evaluated_traders.end())
+    {
+        return false;
     }
 
+    const Trader *evaluated_trader = it->second;
+    trader->balance_history = evaluated_trader->balance_history;
+    trader->trades_history = evaluated_trader->trades_history;
+    trader->balance = evaluated_trader->balance;
+    trader->lifespan = evaluated_trader->lifespan;
+    trader->dead = evaluated_trader->dead;
+    trader->stats = evaluated_trader->stats;
+    trader->fitness_details = evaluated_trader->fitness_details;
+    trader->score = evaluated_trader->score;
+    trader->fitness = evaluated_trader->fitness;
+    return true;
+}
+
+/**
+ * @brief Save the evaluation of a trader which went through the whole training period, to restore it for an identical genome in the next generation.
+ * @param trader The evaluated trader.
+ * @param genome_hash The hash of the genome of the trader when it was evaluated.
+ */
+void Training::save_evaluation(Trader *trader, uint64_t genome_hash)
+{
+    std::lock_guard<std::mutex> lock(this->evaluated_traders_mutex);
+    this->next_evaluated_traders[hash_combine(this->evaluation_hash, genome_hash)] = trader;
+}
+
+/**
+ * @brief Run a trader through the training dates.
+ * @param trader The trader to run.
+ */
+void Training::run_trader(Trader *trader)
+{
+    const std::vector<PositionInfo> &position = this->config.training.inputs.position;
+
     // Loop through the dates and update the trader
     for (const auto &date : this->training_dates)
     {
-        std::string date_string = std::to_string(date);
-        if (this->cache->has(date_string))
+        int index = this->cache->find(date);
+        if (index >= 0)
         {
             // Get the data from cache
-            CandlesData current_candles = this->cache->get(date_string).candles;
-            IndicatorsData current_indicators = this->cache->get(date_string).indicators;
-            double current_base_currency_conversion_rate = this->cache->get(date_string).base_currency_conversion_rate;
-            std::vector<PositionInfo> position = this->config.training.inputs.position;
+            const CachedData &current_data = this->cache->at(index);
+            const CandlesViews &current_candles = current_data.candles;
+            const double *current_features = this->features.data() + index * this->nb_features;
+            double current_base_currency_conversion_rate = current_data.base_currency_conversion_rate;
 
             // Do not continue if the trader is dead
             if (trader->dead)
@@ -622,23 +992,69 @@ void Training::evaluate_genome(neat::Genome *genome, int generation)
             }
 
             // Trader in action
-            trader->update(current_candles);
+            trader->update(current_candles, this->calendar[index], this->tp_sl_levels[index]);
             if (trader->can_trade())
             {
-                trader->look(current_indicators, current_base_currency_conversion_rate, position);
+                trader->look(current_features, this->nb_features, current_base_currency_conversion_rate, position);
                 trader->think();
                 trader->trade();
             }
         }
     }
+}
 
-    // Calculate the stats of the trader
-    trader->calculate_stats();
+/**
+ * @brief Run again the genome of an evaluated trader to get its full histories for the reports, the traders of the generations do not keep them.
+ * @param trader The evaluated trader.
+ * @return A new trader with the full histories, and the evaluation of the evaluated trader.
+ */
+Trader *Training::replay_trader(const Trader *trader)
+{
+    Trader *replayed_trader = new Trader(trader->genome, this->config);
+    this->run_trader(replayed_trader);
+    replayed_trader->calculate_stats();
+
+    // Keep the evaluation the genome was selected with, the racing may have stopped it before the end of the period
+    replayed_trader->generation = trader->generation;
+    replayed_trader->score = trader->score;
+    replayed_trader->fitness = trader->fitness;
+    replayed_trader->fitness_details = trader->fitness_details;
+    return replayed_trader;
+}
+
+/**
+ * @brief Evaluate the performance of a trading algorithm for a given genome and generation.
+ * The evaluation of an identical genome of the last generation is restored instead of running the trader again.
+ * @param genome The genome to be evaluated.
+ * @param generation The current generation number.
+ */
+void Training::evaluate_genome(neat::Genome *genome, int generation)
+{
+    TimeFrame loop_timeframe = this->config.strategy.timeframe;
+    int loop_timeframe_minutes = get_time_frame_in_minutes(loop_timeframe);
 
-    // Calculate fitness
-    trader->calculate_score();
-    trader->calculate_fitness();
+    Trader *trader = new Trader(genome, this->config);
+    if (this->debug)
+    {
+        trader->logger = new Logger(this->directory.generic_string() + "/logs/training/trader_" + genome->id + ".log");
+    }
+    trader->record_balance_history = false;
+
+    uint64_t genome_hash = genome->hash();
+    if (!this->restore_evaluation(trader, genome_hash))
+    {
+        this->run_trader(trader);
+
+        // Calculate the stats of the trader
+        trader->calculate_stats();
+
+        // Calculate fitness
+        trader->calculate_score();
+        trader->calculate_fitness();
+        trader->release_histories();
+    }
     genome->fitness = trader->fitness;
+    this->save_evaluation(trader, genome_hash);
 
     // Close the logger
     if (this->debug && trader->logger != nullptr)
@@ -646,8 +1062,187 @@ void Training::evaluate_genome(neat::Genome *genome, int generation)
         trader->logger->close();
     }
 
-    // Save the trader to the current generation
-    this->current_generation_traders.push_back(trader);
+    // Save the trader to the slot of the worker evaluating it, they are merged to the current generation after the evaluation
+    int worker = this->thread_pool->current_worker();
+    if (worker >= 0 && static_cast<size_t>(worker) < this->workers_traders.size())
+    {
+        this->workers_traders[worker].push_back(trader);
+    }
+    else
+    {
+        this->current_generation_traders.push_back(trader);
+    }
+}
+
+/**
+ * @brief Evaluate all the genomes of a generation together, bar by bar, so the data of each bar are loaded once for a block of genomes.
+ * The genomes are split in blocks evaluated in parallel on the thread pool.
+ * With the `racing_slices` option, the training period is split in slices and only the best genomes of a slice run the next one.
+ * The evaluations of the identical genomes of the last generation are restored instead of running their traders again.
+ * @param genomes The genomes to be evaluated.
+ * @param generation The current generation number.
+ */
+void Training::evaluate_genomes(const std::vector<neat::Genome *> &genomes, int generation)
+{
+    const std::vector<PositionInfo> &position = this->config.training.inputs.position;
+
+    std::vector<Trader *> traders;
+    std::vector<uint64_t> genomes_hashes;
+    std::vector<char> restored;
+    traders.reserve(genomes.size());
+    for (const auto &genome : genomes)
+    {
+        Trader *trader = new Trader(genome, this->config);
+        if (this->debug)
+        {
+            trader->logger = new Logger(this->directory.generic_string() + "/logs/training/trader_" + genome->id + ".log");
+        }
+        trader->record_balance_history = false;
+        traders.push_back(trader);
+        genomes_hashes.push_back(genome->hash());
+        restored.push_back(this->restore_evaluation(trader, genomes_hashes.back()));
+    }
+
+    // Find the data of the training dates in the cache once for all the blocks
+    std::vector<int> indexes;
+    indexes.reserve(this->training_dates.size());
+    for (const auto &date : this->training_dates)
+    {
+        int index = this->cache->find(date);
+        if (index >= 0)
+        {
+            indexes.push_back(index);
+        }
+    }
+
+    // Calculate the stats and the fitness of a trader on the dates it went through
+    auto calculate_fitness = [&](Trader *trader)
+    {
+        trader->calculate_stats();
+        trader->calculate_score();
+        trader->calculate_fitness();
+    };
+
+    // Split the dates in the slices of the racing, a single slice without racing
+    int nb_slices = std::max(1, std::min(this->config.training.racing_slices.value_or(1), static_cast<int>(indexes.size())));
+    double survival_rate = this->config.training.racing_survival_rate.value_or(0.5);
+
+    // Traders still running and part of the dates each trader went through, the restored traders do not run
+    std::vector<size_t> running;
+    for (size_t i = 0; i < traders.size(); ++i)
+    {
+        if (!restored[i])
+        {
+            running.push_back(i);
+        }
+    }
+    std::vector<double> ratios_dates_covered(traders.size(), 1.0);
+
+    for (int slice = 0; slice < nb_slices && !running.empty(); ++slice)
+    {
+        size_t slice_begin = slice * indexes.size() / nb_slices;
+        size_t slice_end = (slice + 1) * indexes.size() / nb_slices;
+
+        // Each block of running traders goes through the dates of the slice together
+        size_t nb_blocks = std::min(running.size(), this->thread_pool->size());
+        this->thread_pool->parallel_for(
+            nb_blocks, [&](size_t block)
+            {
+                auto block_begin = running.begin() + block * running.size() / nb_blocks;
+                auto block_end = running.begin() + (block + 1) * running.size() / nb_blocks;
+
+                for (size_t i = slice_begin; i < slice_end; ++i)
+                {
+                    // Get the data from cache
+                    int index = indexes[i];
+                    const CachedData &current_data = this->cache->at(index);
+                    const CandlesViews &current_candles = current_data.candles;
+                    const double *current_features = this->features.data() + index * this->nb_features;
+                    double current_base_currency_conversion_rate = current_data.base_currency_conversion_rate;
+
+                    // Traders in action
+                    bool all_dead = true;
+                    for (auto it = block_begin; it != block_end; ++it)
+                    {
+                        Trader *trader = traders[*it];
+                        if (trader->dead)
+                        {
+                            continue;
+                        }
+                        all_dead = false;
+
+                        trader->update(current_candles, this->calendar[index], this->tp_sl_levels[index]);
+                        if (trader->can_trade())
+                        {
+                            trader->look(current_features, this->nb_features, current_base_currency_conversion_rate, position);
+                            trader->think();
+                            trader->trade();
+                        }
+                    }
+
+                    // Do not continue if all the traders of the block are dead
+                    if (all_dead)
+                    {
+                        break;
+                    }
+                } });
+
+        // Only the best running traders continue to the next slice
+        if (slice < nb_slices - 1)
+        {
+            this->thread_pool->parallel_for(running.size(), [&](size_t i)
+                                            { calculate_fitness(traders[running[i]]); });
+            std::stable_sort(running.begin(), running.end(), [&](size_t a, size_t b)
+                             { return traders[a]->fitness > traders[b]->fitness; });
+
+            size_t nb_survivors = std::max<size_t>(1, std::ceil(survival_rate * running.size()));
+            for (size_t i = nb_survivors; i < running.size(); ++i)
+            {
+                ratios_dates_covered[running[i]] = static_cast<double>(slice_end) / indexes.size();
+            }
+            running.resize(std::min(nb_survivors, running.size()));
+
+            if (this->debug)
+            {
+                std::cout << "🏁 Generation " << generation << ", slice " << slice + 1 << "/" << nb_slices << ": " << running.size() << " trader(s) continue the racing." << std::endl;
+            }
+        }
+    }
+
+    this->thread_pool->parallel_for(
+        traders.size(), [&](size_t i)
+        {
+            Trader *trader = traders[i];
+
+            // Calculate the stats, the score and the fitness of the trader, its histories are no longer needed after
+            if (!restored[i])
+            {
+                calculate_fitness(trader);
+                trader->release_histories();
+            }
+
+            // The fitness of a trader stopped early by the racing is extrapolated to the whole period if configured,
+            // otherwise the days it did not cover already penalize it
+            if (ratios_dates_covered[i] < 1.0 && this->config.training.racing_extrapolation.value_or(false))
+            {
+                trader->fitness /= ratios_dates_covered[i];
+            }
+            trader->genome->fitness = trader->fitness;
+
+            // Only the traders which went through the whole period are restored in the next generation
+            if (ratios_dates_covered[i] == 1.0)
+            {
+                this->save_evaluation(trader, genomes_hashes[i]);
+            }
+
+            // Close the logger
+            if (this->debug && trader->logger != nullptr)
+            {
+                trader->logger->close();
+            } });
+
+    // Save the traders to the current generation
+    this->current_generation_traders.insert(this->current_generation_traders.end(), traders.begin(), traders.end());
 }
 
 /**
@@ -669,6 +1264,21 @@ int Training::run()
             // Update the progress bar
             progress_bar->update(1);
 
+            // Merge the traders evaluated by the workers of the population
+            for (auto &traders : this->workers_traders)
+            {
+                this->current_generation_traders.insert(this->current_generation_traders.end(), traders.begin(), traders.end());
+                traders.clear();
+            }
+
+            // The evaluations of the generation are restored for the identical genomes of the next generation, the ones of the last generation are released
+            this->evaluated_traders.swap(this->next_evaluated_traders);
+            for (auto &[genome_hash, trader] : this->next_evaluated_traders)
+            {
+                delete trader;
+            }
+            this->next_evaluated_traders.clear();
+
             // Save the best fitness of the generation
             this->best_fitnesses[this->current_generation] = population->best_fitness;
 
@@ -676,21 +1286,26 @@ int Training::run()
             this->average_fitnesses[this->current_generation] = population->average_fitness;
 
             // Find the trader with the best genome of the generation
+            Trader *generation_best_trader = nullptr;
             for (const auto &trader : this->current_generation_traders)
             {
                 if (trader->genome->id == population->best_genome->id)
                 {
-                    this->best_trader = trader;
+                    generation_best_trader = trader;
                     break;
                 }
             }
 
-            if (this->best_trader == nullptr)
+            if (generation_best_trader == nullptr)
             {
                 std::cerr << "Error: the genome of the best trader of the generation " << this->current_generation << " is not found." << std::endl;
                 std::exit(1);
             }
 
+            // Run the best trader again to get its histories for the reports
+            delete this->best_trader;
+            this->best_trader = this->replay_trader(generation_best_trader);
+
             if (this->debug)
             {
                 // Print the best trader stats
@@ -740,14 +1355,33 @@ int Training::run()
             this->test(this->best_trader->genome, this->current_generation);
             std::cout << "✅ Testing of the best trader of generation " << this->current_generation << " finished!" << std::endl;
 
+            // Exchange the best genomes with the other islands
+            int migration_interval = this->config.training.migration_interval.value_or(5);
+            if (this->island >= 0 && migration_interval > 0 && (this->current_generation + 1) % migration_interval == 0)
+            {
+                this->migrate(this->current_generation);
+            }
+
             // Update the current generation
             this->current_generation++;
 
-            // Reset the traders of the current generation
+            // Release the traders of the current generation, except the ones restored in the next generation
+            std::unordered_set<Trader *> restored_traders;
+            for (const auto &[genome_hash, trader] : this->evaluated_traders)
+            {
+                restored_traders.insert(trader);
+            }
+            for (Trader *trader : this->current_generation_traders)
+            {
+                if (restored_traders.find(trader) == restored_traders.end())
+                {
+                    delete trader;
+                }
+            }
             this->current_generation_traders.clear();
 
-            // Save the training process
-            this->save();
+            // Save the training process in the background, while the next generation is evaluated
+            this->save(false);
 
             std::cout << std::endl;
         };
@@ -766,8 +1400,19 @@ int Training::run()
             return 0;
         }
 
+        // The evaluations restored in the next generations depend on the data and the configuration
+        this->evaluation_hash = this->calculate_evaluation_hash();
+
         // Train the population on the training data
-        this->population->run(std::bind(&Training::evaluate_genome, this, std::placeholders::_1, std::placeholders::_2), nb_generations, callback_generation);
+        if (this->config.training.lockstep_evaluation.value_or(false) || this->config.training.racing_slices.value_or(1) > 1)
+        {
+            this->population->run_lockstep(std::bind(&Training::evaluate_genomes, this, std::placeholders::_1, std::placeholders::_2), nb_generations, callback_generation);
+        }
+        else
+        {
+            this->workers_traders.assign(this->thread_pool->size(), {});
+            this->population->run(std::bind(&Training::evaluate_genome, this, std::placeholders::_1, std::placeholders::_2), nb_generations, callback_generation);
+        }
     }
     catch (const std::exception &e)
     {
@@ -776,11 +1421,276 @@ int Training::run()
     }
 
     progress_bar->complete();
+    this->wait_save();
     std::cout << "🎉 Training finished!" << std::endl;
 
     return 0;
 }
 
+/**
+ * @brief Send the best genomes of the island to the other islands and import the last genomes they sent.
+ * The genomes are exchanged through the files of the migrations directory, written atomically.
+ * @param generation The generation of the genomes sent.
+ */
+void Training::migrate(int generation)
+{
+    try
+    {
+        std::filesystem::create_directories(this->migrations_directory);
+
+        // The best genome and the champions of the best species emigrate
+        size_t migration_size = std::max(0, this->config.training.migration_size.value_or(2));
+        std::vector<neat::Genome *> emigrants;
+        if (this->population->best_genome != nullptr && migration_size > 0)
+        {
+            emigrants.push_back(this->population->best_genome);
+        }
+        for (const auto &species : this->population->species)
+        {
+            if (emigrants.size() >= migration_size)
+            {
+                break;
+            }
+            if (species->champion != nullptr && species->champion != this->population->best_genome)
+            {
+                emigrants.push_back(species->champion);
+            }
+        }
+
+        nlohmann::json genomes_json = nlohmann::json::array();
+        for (const auto &genome : emigrants)
+        {
+            genomes_json.push_back(genome->to_json());
+        }
+        nlohmann::json migration_json = {
+            {"island", this->island},
+            {"generation", generation},
+            {"genomes", genomes_json},
+        };
+
+        // Write atomically, so the other islands never read a partial file
+        std::string file_name = "island_" + std::to_string(this->island) + "_generation_" + std::to_string(generation) + ".json";
+        write_file_atomically(this->migrations_directory / file_name, migration_json.dump());
+
+        // Only the last genomes sent are imported, the older files of the island are removed
+        for (const auto &entry : std::filesystem::directory_iterator(this->migrations_directory))
+        {
+            int from_island, from_generation;
+            if (entry.path().extension() == ".json" && std::sscanf(entry.path().filename().string().c_str(), "island_%d_generation_%d.json", &from_island, &from_generation) == 2 && from_island == this->island && from_generation != generation)
+            {
+                // Another island can still be reading the file, it is removed at the next migration then
+                std::error_code error;
+                std::filesystem::remove(entry.path(), error);
+            }
+        }
+
+        // Find the last genomes sent by each other island, not imported yet
+        std::map<int, std::pair<int, std::filesystem::path>> last_migrations;
+        for (const auto &entry : std::filesystem::directory_iterator(this->migrations_directory))
+        {
+            int from_island, from_generation;
+            if (entry.path().extension() != ".json" || std::sscanf(entry.path().filename().string().c_str(), "island_%d_generation_%d.json", &from_island, &from_generation) != 2)
+            {
+                continue;
+            }
+            if (from_island == this->island || (this->imported_migrations.count(from_island) && this->imported_migrations[from_island] >= from_generation))
+            {
+                continue;
+            }
+            if (!last_migrations.count(from_island) || last_migrations[from_island].first < from_generation)
+            {
+                last_migrations[from_island] = {from_generation, entry.path()};
+            }
+        }
+
+        // Import the genomes in the next generation of the population
+        std::vector<neat::Genome *> immigrants;
+        for (const auto &[from_island, migration] : last_migrations)
+        {
+            std::ifstream file(migration.second);
+            nlohmann::json json;
+            file >> json;
+            for (const auto &genome_json : json["genomes"])
+            {
+                immigrants.push_back(neat::Genome::from_json(genome_json));
+            }
+            this->imported_migrations[from_island] = migration.first;
+        }
+        this->population->add_immigrants(immigrants);
+
+        std::cout << "🏝️ " << emigrants.size() << " genome(s) sent to the other islands, " << immigrants.size() << " genome(s) received." << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: the migration of the island " << this->island << " failed: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief Run the islands of the training in their own processes and aggregate their progress until they all finish.
+ * The data must be prepared before, the islands share the cache.
+ * The threads of the pool are stopped before starting the islands, the training cannot evaluate genomes afterwards.
+ * @param nb_islands The number of islands.
+ * @param executable The path to the executable of the training, run with the `--island` option for each island.
+ * @return The exit code of the islands. 0 if they all succeeded, 1 otherwise.
+ */
+int Training::run_islands(int nb_islands, const std::string &executable)
+{
+    std::cout << "🏝️ Start " << nb_islands << " islands..." << std::endl;
+
+    // Build the arguments of all the islands before starting any process
+    std::vector<std::vector<std::string>> arguments(nb_islands);
+    std::vector<std::vector<char *>> argv(nb_islands);
+    for (int i = 0; i < nb_islands; ++i)
+    {
+        arguments[i] = {executable, this->id, this->config_file_path.generic_string(), "--island", std::to_string(i)};
+        if (this->debug)
+        {
+            arguments[i].push_back("--debug");
+        }
+        for (auto &argument : arguments[i])
+        {
+            argv[i].push_back(argument.data());
+        }
+        argv[i].push_back(nullptr);
+    }
+
+    // The data is prepared, stop the threads of the pool so the islands are started from a single threaded process
+    this->wait_save();
+    delete this->thread_pool;
+    this->thread_pool = nullptr;
+
+    // Start a process for each island, posix_spawn does not run any code of the parent in the child before the executable
+    std::vector<pid_t> processes;
+    for (int i = 0; i < nb_islands; ++i)
+    {
+        pid_t pid;
+        int error = posix_spawnp(&pid, executable.c_str(), nullptr, nullptr, argv[i].data(), environ);
+        if (error != 0)
+        {
+            std::cerr << "Error: unable to start the island " << i << " with '" << executable << "': " << std::strerror(error) << std::endl;
+            continue;
+        }
+        processes.push_back(pid);
+    }
+
+    // Aggregate the progress of the islands until they all finish
+    int exit_code = processes.size() == static_cast<size_t>(nb_islands) ? 0 : 1;
+    size_t nb_running = processes.size();
+    while (nb_running > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::seconds(10));
+
+        for (auto &pid : processes)
+        {
+            int status;
+            if (pid > 0 && waitpid(pid, &status, WNOHANG) == pid)
+            {
+                if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+                {
+                    exit_code = 1;
+                }
+                pid = 0;
+                nb_running--;
+            }
+        }
+
+        this->aggregate_islands(nb_islands);
+    }
+
+    std::cout << "🎉 Training of the islands finished!" << std::endl;
+    return exit_code;
+}
+
+/**
+ * @brief Aggregate the best and average fitnesses of the islands and the files of their checkpoints.
+ * @param nb_islands The number of islands.
+ */
+void Training::aggregate_islands(int nb_islands)
+{
+    std::map<int, std::vector<double>> islands_average_fitnesses;
+    nlohmann::json islands_json = nlohmann::json::array();
+    int best_island = -1;
+    double best_fitness = 0;
+
+    for (int i = 0; i < nb_islands; ++i)
+    {
+        std::filesystem::path island_directory = this->directory / ("island_" + std::to_string(i));
+        std::filesystem::path island_save_file = island_directory / "training_save.json";
+        if (!std::filesystem::exists(island_save_file))
+        {
+            continue;
+        }
+
+        // The island may be writing its checkpoint, it is read again at the next aggregation
+        nlohmann::json data;
+        try
+        {
+            std::ifstream file(island_save_file);
+            file >> data;
+        }
+        catch (const std::exception &e)
+        {
+            continue;
+        }
+
+        double island_best_fitness = 0;
+        for (const auto &[key, value] : data["best_fitnesses"].items())
+        {
+            int generation = std::stoi(key);
+            double fitness = value;
+            this->best_fitnesses[generation] = this->best_fitnesses.count(generation) ? std::max(this->best_fitnesses[generation], fitness) : fitness;
+            island_best_fitness = std::max(island_best_fitness, fitness);
+        }
+        for (const auto &[key, value] : data["average_fitnesses"].items())
+        {
+            islands_average_fitnesses[std::stoi(key)].push_back(value);
+        }
+
+        if (best_island < 0 || island_best_fitness > best_fitness)
+        {
+            best_island = i;
+            best_fitness = island_best_fitness;
+        }
+
+        islands_json.push_back({
+            {"island", i},
+            {"current_generation", data["current_generation"]},
+            {"best_fitness", island_best_fitness},
+            {"training_save_file", island_save_file.generic_string()},
+            {"population_save_file", (island_directory / "population_save.bin").generic_string()},
+        });
+    }
+
+    for (const auto &[generation, fitnesses] : islands_average_fitnesses)
+    {
+        this->average_fitnesses[generation] = std::accumulate(fitnesses.begin(), fitnesses.end(), 0.0) / fitnesses.size();
+    }
+
+    // Save the aggregated progress of the islands
+    nlohmann::json best_fitnesses_json;
+    nlohmann::json average_fitnesses_json;
+    for (const auto &[generation, fitness] : this->best_fitnesses)
+    {
+        best_fitnesses_json[std::to_string(generation)] = fitness;
+    }
+    for (const auto &[generation, fitness] : this->average_fitnesses)
+    {
+        average_fitnesses_json[std::to_string(generation)] = fitness;
+    }
+    nlohmann::json data = {
+        {"id", this->id},
+        {"islands", islands_json},
+        {"best_island", best_island},
+        {"best_fitnesses", best_fitnesses_json},
+        {"average_fitnesses", average_fitnesses_json},
+    };
+
+    write_file_atomically(this->islands_save_file, data.dump());
+
+    this->generate_fitness_report(this->fitness_report_file);
+}
+
 /**
  * @brief Run the strategy of the best trader in the test period.
  * @param genome The genome to be tested.
@@ -810,18 +1720,19 @@ int Training::test(neat::Genome *genome, int generation)
     // Loop through the dates and update the trader
     for (const auto &date : this->test_dates)
     {
-        std::string date_string = std::to_string(date);
-        if (this->cache->has(date_string))
+        int index = this->cache->find(date);
+        if (index >= 0)
         {
             // Get the data from cache
-            CandlesData current_candles = this->cache->get(date_string).candles;
-            IndicatorsData current_indicators = this->cache->get(date_string).indicators;
-            double current_base_currency_conversion_rate = this->cache->get(date_string).base_currency_conversion_rate;
-            std::vector<PositionInfo> position = this->config.training.inputs.position;
+            const CachedData &current_data = this->cache->at(index);
+            const CandlesViews &current_candles = current_data.candles;
+            const double *current_features = this->features.data() + index * this->nb_features;
+            double current_base_currency_conversion_rate = current_data.base_currency_conversion_rate;
+            const std::vector<PositionInfo> &position = this->config.training.inputs.position;
 
             // Update the individual
-            trader->update(current_candles);
-            trader->look(current_indicators, current_base_currency_conversion_rate, position);
+            trader->update(current_candles, this->calendar[index], this->tp_sl_levels[index]);
+            trader->look(current_features, this->nb_features, current_base_currency_conversion_rate, position);
             trader->think();
             int decision = trader->trade();
 
@@ -867,6 +1778,7 @@ int Training::test(neat::Genome *genome, int generation)
         trader->logger->close();
     }
 
+    delete trader;
     return 0;
 }
 
@@ -875,63 +1787,31 @@ int Training::test(neat::Genome *genome, int generation)
  * @param trader The trader to be evaluated.
  * @param nb_simulations The number of simulations to run. Default is 1000.
  * @param note_threshold The threshold to consider the results consistent with the training period. Default is 0.1.
+ * @param model The model used to draw the trades of the simulations. Default is MonteCarloModel::WIN_RATE.
  * @return The exit code of the evaluation process. 0 if the results are consistences with the training period, 1 otherwise.
+ * @throws std::invalid_argument If the bootstrap model is used without closed trades in the trades history of the trader.
  */
-int Training::evaluate_trader_with_monte_carlo_simulation(Trader *trader, int nb_simulations, double note_threshold)
+int Training::evaluate_trader_with_monte_carlo_simulation(Trader *trader, int nb_simulations, double note_threshold, MonteCarloModel model)
 {
     // Number of trades to simulate in the testing period proportionally to the number of trades in the training period
     int nb_trades_to_simulate = trader->stats.total_trades * this->test_dates.size() / this->training_dates.size();
 
-    // Monte Carlo simulation
-    std::vector<double> simulation_final_balance = std::vector<double>(nb_simulations, this->config.general.initial_balance);
-    for (int i = 0; i < nb_simulations; i++)
-    {
-        // Create a balance for the simulation
-        double balance = this->config.general.initial_balance;
-
-        // Simulate the trades
-        for (int j = 0; j < nb_trades_to_simulate; j++)
-        {
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_real_distribution<double> distribution(0, 1);
-            double random = distribution(gen);
-            bool winning_trade = random < trader->stats.win_rate;
-            double risk_amount = balance * this->config.strategy.risk_per_trade;
-
-            if (winning_trade)
-            {
-                balance += risk_amount * trader->stats.profit_factor;
-            }
-            else
-            {
-                balance -= risk_amount;
-            }
-        }
-
-        simulation_final_balance[i] = balance;
-    }
+    // Each simulation draws from its own stream of random values, derived from the seed of the configuration
+    uint64_t seed = this->config.neat.seed != 0 ? this->config.neat.seed : std::random_device{}();
 
-    // Lambda to find lower quartile
-    auto find_lower_quartile = [](std::vector<double> &data) -> double
+    // Resample the trades of the trader, or draw them from its win rate and profit factor
+    MonteCarloResults results;
+    if (model == MonteCarloModel::BOOTSTRAP)
     {
-        std::sort(data.begin(), data.end());
-        return data[data.size() / 4];
-    };
-
-    // Lambda to find upper quartile
-    auto find_upper_quartile = [](std::vector<double> &data) -> double
+        results = run_bootstrap_simulation(get_trades_returns(trader->trades_history), nb_trades_to_simulate, this->config.general.initial_balance, nb_simulations, seed, this->thread_pool);
+    }
+    else
     {
-        std::sort(data.begin(), data.end());
-        return data[data.size() * 3 / 4];
-    };
+        results = run_win_rate_simulation(trader->stats.win_rate, trader->stats.profit_factor, this->config.strategy.risk_per_trade, nb_trades_to_simulate, this->config.general.initial_balance, nb_simulations, seed, this->thread_pool);
+    }
 
-    std::sort(simulation_final_balance.begin(), simulation_final_balance.end());
-    double median = find_median(simulation_final_balance);
-    double lower_quartile = find_lower_quartile(simulation_final_balance);
-    double upper_quartile = find_upper_quartile(simulation_final_balance);
-    double worse_case = simulation_final_balance[0];
-    double best_case = simulation_final_balance[simulation_final_balance.size() - 1];
+    double worse_case = results.final_balance.minimum;
+    double best_case = results.final_balance.maximum;
 
     // Check if the results are consistent with the training period by calculate a note
     double note = 0.0;
@@ -952,11 +1832,16 @@ int Training::evaluate_trader_with_monte_carlo_simulation(Trader *trader, int nb
     {
         // Print the results
         std::cout << "📊 Monte Carlo simulation results:" << std::endl;
-        std::cout << "📈 Median: " << median << std::endl;
-        std::cout << "📈 Lower quartile: " << lower_quartile << std::endl;
-        std::cout << "📈 Upper quartile: " << upper_quartile << std::endl;
+        std::cout << "📈 Median: " << results.final_balance.median << std::endl;
+        std::cout << "📈 Lower quartile: " << results.final_balance.lower_quartile << std::endl;
+        std::cout << "📈 Upper quartile: " << results.final_balance.upper_quartile << std::endl;
+        std::cout << "📈 5th percentile: " << results.final_balance.percentile_5 << std::endl;
+        std::cout << "📈 95th percentile: " << results.final_balance.percentile_95 << std::endl;
         std::cout << "📈 Worse case: " << worse_case << std::endl;
         std::cout << "📈 Best case: " << best_case << std::endl;
+        std::cout << "📉 Median max drawdown: " << results.max_drawdown.median << std::endl;
+        std::cout << "📉 95th percentile max drawdown: " << results.max_drawdown.percentile_95 << std::endl;
+        std::cout << "📉 Worse max drawdown: " << results.max_drawdown.maximum << std::endl;
         std::cout << "📈 Note: " << note << std::endl;
     }
 
@@ -1030,45 +1915,87 @@ void Training::generate_fitness_report(std::string file_path)
 }
 
 /**
- * @brief Save the training process to a file.
+ * @brief Save the training process to a file, with a binary checkpoint of the population.
+ * The state is captured in memory and the files are written atomically, after the end of the previous save.
+ * @param wait Flag to wait until the files are written. Default is true, false to write them in the background.
  */
-void Training::save()
+void Training::save(bool wait)
 {
-    // Save the population
-    this->population->save(this->population_save_file);
-    std::cout << "💾 Population saved to '" << this->population_save_file.generic_string() << "'" << std::endl;
+    // Only one save is written at a time
+    this->wait_save();
+
+    // Capture the checkpoint of the population, it changes during the evaluation of the next generation
+    std::ostringstream checkpoint;
+    this->population->write(checkpoint);
 
-    // Save the training process
-    std::ofstream file(this->training_save_file);
-    if (file.is_open())
+    // Capture the training process
+    nlohmann::json best_fitnesses_json;
+    nlohmann::json average_fitnesses_json;
+    for (int i = 0; i < this->best_fitnesses.size(); i++)
     {
-        nlohmann::json best_fitnesses_json;
-        nlohmann::json average_fitnesses_json;
-        for (int i = 0; i < this->best_fitnesses.size(); i++)
-        {
-            best_fitnesses_json[std::to_string(i)] = this->best_fitnesses[i];
-            average_fitnesses_json[std::to_string(i)] = this->average_fitnesses[i];
-        }
+        best_fitnesses_json[std::to_string(i)] = this->best_fitnesses[i];
+        average_fitnesses_json[std::to_string(i)] = this->average_fitnesses[i];
+    }
 
-        nlohmann::json data = {
-            {"id", this->id},
-            {"config", config_to_json(this->config)},
-            {"current_generation", this->current_generation},
-            {"best_trader", this->best_trader->to_json()},
-            {"best_fitnesses", best_fitnesses_json},
-            {"average_fitnesses", average_fitnesses_json},
-        };
+    nlohmann::json imported_migrations_json = nlohmann::json::object();
+    for (const auto &[from_island, generation] : this->imported_migrations)
+    {
+        imported_migrations_json[std::to_string(from_island)] = generation;
+    }
 
-        file << data.dump();
-        file.close();
+    nlohmann::json data = {
+        {"id", this->id},
+        {"config", config_to_json(this->config)},
+        {"current_generation", this->current_generation},
+        {"best_trader", this->best_trader->to_json()},
+        {"best_fitnesses", best_fitnesses_json},
+        {"average_fitnesses", average_fitnesses_json},
+        {"imported_migrations", imported_migrations_json},
+    };
+
+    // The population is written before the training process, which refers to it when the training is loaded
+    this->save_task = std::async(std::launch::async, [population_save_file = this->population_save_file, training_save_file = this->training_save_file, checkpoint = checkpoint.str(), data = std::move(data)]()
+                                 {
+                                     write_file_atomically(population_save_file, checkpoint);
+                                     write_file_atomically(training_save_file, data.dump()); });
+
+    if (wait)
+    {
+        this->wait_save();
+    }
+}
+
+/**
+ * @brief Wait until the files of the last save are written.
+ */
+void Training::wait_save()
+{
+    if (!this->save_task.valid())
+    {
+        return;
+    }
+
+    try
+    {
+        this->save_task.get();
         std::cout << "💾 Training progress saved to '" << this->training_save_file.generic_string() << "'" << std::endl;
     }
-    else
+    catch (const std::exception &e)
     {
-        std::cerr << "Error: unable to save the training process to '" << this->training_save_file << "'" << std::endl;
+        std::cerr << "Error: unable to save the training process to '" << this->training_save_file.generic_string() << "': " << e.what() << std::endl;
     }
 }
 
+/**
+ * @brief Export the population to a JSON file, readable by the other tools.
+ * @param file_path Path to the JSON file.
+ */
+void Training::export_population(const std::filesystem::path &file_path) const
+{
+    this->population->save(file_path.generic_string());
+    std::cout << "💾 Population exported to '" << file_path.generic_string() << "'" << std::endl;
+}
+
 /**
  * @brief Load a training process from a file.
  * @return The loaded training process.
@@ -1104,8 +2031,22 @@ void Training::load()
     // Load the configuration
     this->config = config_from_json(data["config"]);
 
-    // Load the population
-    this->population = neat::Population::load(this->population_save_file, this->config.neat);
+    // Load the population from its checkpoint, or from the JSON file of the previous versions
+    std::filesystem::path population_json_file = std::filesystem::path(this->population_save_file).replace_extension(".json");
+    if (std::filesystem::exists(this->population_save_file))
+    {
+        this->population = neat::Population::load_checkpoint(this->population_save_file.generic_string(), this->get_neat_config());
+    }
+    else
+    {
+        this->population = neat::Population::load(population_json_file.generic_string(), this->get_neat_config());
+    }
+
+    if (this->population == nullptr)
+    {
+        std::cerr << "Error: unable to load the population of the training." << std::endl;
+        std::exit(1);
+    }
 
     // Load the training process data
     this->current_generation = data["current_generation"];
@@ -1120,6 +2061,15 @@ void Training::load()
         this->average_fitnesses[std::stoi(key)] = value;
     }
 
+    // The islands do not import again the genomes they imported before the save, the files of the previous versions have none
+    if (data.contains("imported_migrations"))
+    {
+        for (const auto &[key, value] : data["imported_migrations"].items())
+        {
+            this->imported_migrations[std::stoi(key)] = value;
+        }
+    }
+
     this->best_trader = Trader::from_json(data["best_trader"], this->config);
     if (this->debug)
     {
@@ -1,11 +1,16 @@
 #ifndef TRAINING_HPP
 #define TRAINING_HPP
 
+#include <future>
+#include <mutex>
+#include <unordered_map>
 #include "types.hpp"
 #include "utils/indexer.hpp"
 #include "utils/uid.hpp"
 #include "utils/cache.hpp"
 #include "utils/progress_bar.hpp"
+#include "utils/thread_pool.hpp"
+#include "trading/monte_carlo.hpp"
 #include "trader.hpp"
 #include "neat/population.hpp"
 #include "neat/genome.hpp"
@@ -31,39 +36,57 @@ class Training
 public:
     std::string id; // Unique identifier for the training process.
     bool debug;     // Debug mode flag.
+    int island;     // Index of the island evolved by the training in the island mode, -1 otherwise.
     Config config;  // Configuration object.
 
     // Files and directories to save the training results.
     std::filesystem::path directory;            // Directory to save the training results.
     std::filesystem::path cache_file;           // Optional cache file path.
     std::filesystem::path fitness_report_file;  // Fitness report file path.
-    std::filesystem::path population_save_file; // Population save file path.
+    std::filesystem::path population_save_file; // Binary checkpoint of the population file path.
     std::filesystem::path training_save_file;   // Training state file path.
     std::filesystem::path config_file_path;     // Path to the configuration file.
+    std::filesystem::path migrations_directory; // Spool directory of the genomes migrating between the islands.
+    std::filesystem::path islands_save_file;    // Aggregated progress of the islands file path.
 
-    std::map<time_t, CandlesData> candles;                        // Candle data for all time frames at a specified date.
+    CandlesData candles;                                          // Timeline of the candles for each time frame.
+    std::map<time_t, CandlesViews> candles_windows;               // Window of the candles in the timelines for all time frames at a specified date.
     std::map<time_t, IndicatorsData> indicators;                  // Indicator data for all time frames at a specified date.
     BaseCurrencyConversionRateData base_currency_conversion_rate; // Conversion rate when the base asset traded is different from the account currency.
     Cache *cache;                                                 // Cached data for faster access.
+    std::vector<double> features;                                 // Row-major matrix of the indicator inputs of the traders, one row per date of the cache.
+    size_t nb_features;                                           // Number of indicator inputs in a row of the feature matrix.
+    std::vector<BarCalendar> calendar;                            // Calendar fields of the traders at each date of the cache.
+    std::vector<TpSlLevels> tp_sl_levels;                         // Take profit and stop loss levels of the traders at each date of the cache.
+    ThreadPool *thread_pool;                                      // Pool of threads running the parallel work of the training, shared with the population.
 
     std::vector<time_t> dates;          // All dates available in the data.
     std::vector<time_t> training_dates; // Dates used for training period.
     std::vector<time_t> test_dates;     // Dates used for testing period.
 
-    int current_generation;                           // Current generation number.
-    neat::Population *population;                     // NEAT population for evolution.
-    Trader *best_trader;                              // Best trader overall.
-    std::vector<Trader *> current_generation_traders; // Map of traders for the current generation.
-    std::map<int, double> best_fitnesses;             // Map of the best fitness for each generation.
-    std::map<int, double> average_fitnesses;          // Map of the average fitness for each generation.
+    int current_generation;                                        // Current generation number.
+    neat::Population *population;                                  // NEAT population for evolution.
+    Trader *best_trader;                                           // Best trader overall.
+    std::vector<Trader *> current_generation_traders;              // Map of traders for the current generation.
+    std::vector<std::vector<Trader *>> workers_traders;            // Traders evaluated by each worker of the pool, merged after the evaluation.
+    uint64_t evaluation_hash;                                      // Hash of the configuration the evaluations of the traders depend on.
+    std::unordered_map<uint64_t, Trader *> evaluated_traders;      // Traders of the last generation which went through the whole training period, indexed by the hash of their genome.
+    std::unordered_map<uint64_t, Trader *> next_evaluated_traders; // Traders of the current generation which went through the whole training period, indexed by the hash of their genome.
+    std::mutex evaluated_traders_mutex;                            // Mutex protecting the traders of the current generation.
+    std::map<int, int> imported_migrations;                        // Last generation of the genomes imported from each other island.
+    std::map<int, double> best_fitnesses;                          // Map of the best fitness for each generation.
+    std::map<int, double> average_fitnesses;                       // Map of the average fitness for each generation.
+    std::future<void> save_task;                                   // Writing of the last saved training process, in the background.
 
     /**
      * @brief Constructor for the Training class.
      * @param id Unique identifier for the training process.
      * @param config_file_path Path to the configuration file.
      * @param debug Debug mode flag.
+     * @param island Index of the island evolved by the training in the island mode. Default is -1, without islands.
+     * @param coordinator Flag of the process running the islands, it prepares the data without a population of its own. Default is false.
      */
-    Training(std::string id, std::filesystem::path config_file_path, bool debug = false);
+    Training(std::string id, std::filesystem::path config_file_path, bool debug = false, int island = -1, bool coordinator = false);
 
     /**
      * @brief Destructor for the Training class to ensure proper cleanup.
@@ -83,6 +106,7 @@ public:
 
     /**
      * @brief Calculate and store all indicator values to the cache.
+     * With the `precompute_indicators` option, each indicator is calculated once on the whole timeline of its time frame.
      * @param display_progress Flag to show the progress bar. Default is false.
      */
     void load_indicators(bool display_progress = false);
@@ -99,6 +123,12 @@ public:
      */
     void cache_data(bool display_progress = false);
 
+    /**
+     * @brief Build the feature matrix from the cached indicators, in the order the traders look at them, the calendar fields and the take profit and stop loss levels of each date.
+     * @param display_progress Flag to show the progress bar. Default is false.
+     */
+    void load_features(bool display_progress = false);
+
     /**
      * @brief Count the total number of indicators used in training.
      * @return Total number of indicators.
@@ -111,6 +141,53 @@ public:
      */
     std::vector<TimeFrame> get_all_timeframes() const;
 
+    /**
+     * @brief Calculate the hash of the configuration parameters the prepared data depend on.
+     * @return Hash of the configuration used to check if the cache is up to date.
+     */
+    uint64_t calculate_config_hash() const;
+
+    /**
+     * @brief Calculate the hash of the configuration the evaluations of the traders depend on.
+     * @return Hash of the data and of the whole configuration.
+     */
+    uint64_t calculate_evaluation_hash() const;
+
+    /**
+     * @brief Get the configuration of the NEAT algorithm, each island evolves from its own seed derived from the one of the configuration.
+     * @return The configuration of the NEAT algorithm of the population.
+     */
+    neat::Config get_neat_config() const;
+
+    /**
+     * @brief Restore the evaluation of a trader from the trader of the last generation with an identical genome.
+     * The fitness, the score, the stats, the fitness details and the histories are copied instead of running the trader again.
+     * @param trader The trader to restore, not evaluated yet.
+     * @param genome_hash The hash of the genome of the trader.
+     * @return True if the evaluation was restored, false if no identical genome was evaluated in the last generation.
+     */
+    bool restore_evaluation(Trader *trader, uint64_t genome_hash);
+
+    /**
+     * @brief Save the evaluation of a trader which went through the whole training period, to restore it for an identical genome in the next generation.
+     * @param trader The evaluated trader.
+     * @param genome_hash The hash of the genome of the trader when it was evaluated.
+     */
+    void save_evaluation(Trader *trader, uint64_t genome_hash);
+
+    /**
+     * @brief Run a trader through the training dates.
+     * @param trader The trader to run.
+     */
+    void run_trader(Trader *trader);
+
+    /**
+     * @brief Run again the genome of an evaluated trader to get its full histories for the reports, the traders of the generations do not keep them.
+     * @param trader The evaluated trader.
+     * @return A new trader with the full histories, and the evaluation of the evaluated trader.
+     */
+    Trader *replay_trader(const Trader *trader);
+
     /**
      * @brief Evaluate the performance of a trading algorithm for a given genome and generation.
      * @param genome The genome to be evaluated.
@@ -118,12 +195,44 @@ public:
      */
     void evaluate_genome(neat::Genome *genome, int generation);
 
+    /**
+     * @brief Evaluate all the genomes of a generation together, bar by bar, so the data of each bar are loaded once for a block of genomes.
+     * The genomes are split in blocks evaluated in parallel on the thread pool.
+     * With the `racing_slices` option, the training period is split in slices and only the best genomes of a slice run the next one.
+     * @param genomes The genomes to be evaluated.
+     * @param generation The current generation number.
+     */
+    void evaluate_genomes(const std::vector<neat::Genome *> &genomes, int generation);
+
     /**
      * @brief Run the NEAT algorithm for training.
      * @return The exit code of the training process. 0 if successful, 1 otherwise.
      */
     int run();
 
+    /**
+     * @brief Send the best genomes of the island to the other islands and import the last genomes they sent.
+     * The genomes are exchanged through the files of the migrations directory, written atomically.
+     * @param generation The generation of the genomes sent.
+     */
+    void migrate(int generation);
+
+    /**
+     * @brief Run the islands of the training in their own processes and aggregate their progress until they all finish.
+     * The data must be prepared before, the islands share the cache.
+     * The threads of the pool are stopped before starting the islands, the training cannot evaluate genomes afterwards.
+     * @param nb_islands The number of islands.
+     * @param executable The path to the executable of the training, run with the `--island` option for each island.
+     * @return The exit code of the islands. 0 if they all succeeded, 1 otherwise.
+     */
+    int run_islands(int nb_islands, const std::string &executable);
+
+    /**
+     * @brief Aggregate the best and average fitnesses of the islands and the files of their checkpoints.
+     * @param nb_islands The number of islands.
+     */
+    void aggregate_islands(int nb_islands);
+
     /**
      * @brief Run the strategy of the best trader in the test period.
      * @param genome The genome to be tested.
@@ -137,9 +246,11 @@ public:
      * @param trader The trader to be evaluated.
      * @param nb_simulations The number of simulations to run. Default is 1000.
      * @param note_threshold The threshold to consider the results consistent with the training period. Default is 0.1.
+     * @param model The model used to draw the trades of the simulations. Default is MonteCarloModel::WIN_RATE.
      * @return The exit code of the evaluation process. 0 if the results are consistences with the training period, 1 otherwise.
+     * @throws std::invalid_argument If the bootstrap model is used without closed trades in the trades history of the trader.
      */
-    int evaluate_trader_with_monte_carlo_simulation(Trader *trader, int nb_simulations = 1000, double note_threshold = 0.1);
+    int evaluate_trader_with_monte_carlo_simulation(Trader *trader, int nb_simulations = 1000, double note_threshold = 0.1, MonteCarloModel model = MonteCarloModel::WIN_RATE);
 
     /**
      * @brief Generate a fitness report for the training process.
@@ -148,9 +259,22 @@ public:
     void generate_fitness_report(std::string file_path);
 
     /**
-     * @brief Save the training process to a file.
+     * @brief Save the training process to a file, with a binary checkpoint of the population.
+     * The state is captured in memory and the files are written atomically, after the end of the previous save.
+     * @param wait Flag to wait until the files are written. Default is true, false to write them in the background.
+     */
+    void save(bool wait = true);
+
+    /**
+     * @brief Wait until the files of the last save are written.
+     */
+    void wait_save();
+
+    /**
+     * @brief Export the population to a JSON file, readable by the other tools.
+     * @param file_path Path to the JSON file.
      */
-    void save();
+    void export_population(const std::filesystem::path &file_path) const;
 
     /**
      * @brief Load a training process from a file.
@@ -54,10 +54,37 @@ struct Candle
     double spread;
 };
 
+/**
+ * @brief Struct representing a non-owning view over the candles [begin_index, end_index) of a timeline.
+ *
+ * The timeline must outlive the view and must not be resized while the view is used.
+ */
+struct CandlesView
+{
+    const Candle *timeline; // First candle of the timeline
+    size_t begin_index;     // Index of the first candle of the view in the timeline
+    size_t end_index;       // Index after the last candle of the view in the timeline
+
+    CandlesView() : timeline(nullptr), begin_index(0), end_index(0) {}
+    CandlesView(const Candle *timeline, size_t begin_index, size_t end_index) : timeline(timeline), begin_index(begin_index), end_index(end_index) {}
+    CandlesView(const std::vector<Candle> &timeline, size_t begin_index, size_t end_index) : timeline(timeline.data()), begin_index(begin_index), end_index(end_index) {}
+    CandlesView(const std::vector<Candle> &candles) : timeline(candles.data()), begin_index(0), end_index(candles.size()) {}
+
+    const Candle *begin() const { return this->timeline + this->begin_index; }
+    const Candle *end() const { return this->timeline + this->end_index; }
+    const Candle &operator[](size_t i) const { return this->timeline[this->begin_index + i]; }
+    const Candle &front() const { return this->timeline[this->begin_index]; }
+    const Candle &back() const { return this->timeline[this->end_index - 1]; }
+    size_t size() const { return this->end_index - this->begin_index; }
+    bool empty() const { return this->end_index == this->begin_index; }
+    std::vector<Candle> to_vector() const { return std::vector<Candle>(this->begin(), this->end()); }
+};
+
 /**
  * @brief Type definitions for different data structures.
  */
 using CandlesData = std::unordered_map<TimeFrame, std::vector<Candle>>;
+using CandlesViews = std::unordered_map<TimeFrame, CandlesView>;
 using IndicatorsData = std::unordered_map<TimeFrame, std::map<std::string, std::vector<double>>>;
 using BaseCurrencyConversionRateData = std::map<time_t, double>;
 
@@ -66,7 +93,7 @@ using BaseCurrencyConversionRateData = std::map<time_t, double>;
  */
 struct CachedData
 {
-    CandlesData candles;                  // Cached candle data
+    CandlesViews candles;                 // Cached candle windows, as views over the candle timelines
     IndicatorsData indicators;            // Cached indicator data
     double base_currency_conversion_rate; // Cached base currency conversion rates
 };
@@ -218,6 +245,19 @@ struct TakeProfitStopLossConfig
     std::optional<double> take_profit_atr_multiplier; // Take profit multiplier for ATR
 };
 
+/**
+ * @brief Struct representing the levels of a bar used to place the take profit and stop loss orders.
+ */
+struct TpSlLevels
+{
+    double take_profit_atr = 0.0;          // ATR over the take profit period
+    double take_profit_highest_high = 0.0; // Highest high over the take profit extremum period
+    double take_profit_lowest_low = 0.0;   // Lowest low over the take profit extremum period
+    double stop_loss_atr = 0.0;            // ATR over the stop loss period
+    double stop_loss_highest_high = 0.0;   // Highest high over the stop loss extremum period
+    double stop_loss_lowest_low = 0.0;     // Lowest low over the stop loss extremum period
+};
+
 /**
  * @brief Struct representing trailing stop loss configuration.
  */
@@ -244,6 +284,16 @@ struct TradingSchedule
     std::vector<bool> sunday;    // Trading schedule for Sunday
 };
 
+/**
+ * @brief Struct representing the calendar fields of a bar, computed once per date of the data.
+ */
+struct BarCalendar
+{
+    int day = 0;                   // Day of the bar, as YYYYMMDD in local time
+    bool tradable = true;          // True if the bar is on the trading schedule
+    bool next_is_rest_day = false; // True if the next bar is on a day without trading session
+};
+
 /**
  * @brief Struct representing trading strategy configuration.
  */
@@ -286,6 +336,13 @@ struct TrainingConfig
     time_t test_start_date;                          // Start date for testing
     time_t test_end_date;                            // End date for testing
     std::optional<double> decision_threshold;        // Below this threshold, the trader does not make any decision
+    std::optional<bool> precompute_indicators;       // Calculate the indicators once on the whole candle series instead of on the window of each date
+    std::optional<bool> lockstep_evaluation;         // Evaluate all the genomes of a generation together, bar by bar, instead of one after another
+    std::optional<int> racing_slices;                // Number of slices of the training period, only the best genomes of a slice run the next one
+    std::optional<double> racing_survival_rate;      // Fraction of the running genomes that continue to the next slice
+    std::optional<bool> racing_extrapolation;        // Extrapolate the fitness of the genomes stopped early to the whole period instead of keeping the penalty of the days not covered
+    std::optional<int> migration_interval;           // Number of generations between two migrations of genomes between the islands
+    std::optional<int> migration_size;               // Number of best genomes an island sends to the others at each migration
     NeuralNetworkInputs inputs;                      // Inputs for neural network
 };
 
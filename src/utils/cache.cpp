@@ -1,171 +1,340 @@
 #include <iostream>
 #include <fstream>
 #include <stdexcept>
-#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <map>
+#include <set>
 #include <string>
+#include <vector>
 #include <filesystem>
-#include "../libs/json.hpp"
+#include <sstream>
+#include <type_traits>
 #include "cache.hpp"
-#include "time_frame.hpp"
+#include "thread_pool.hpp"
 #include "../types.hpp"
 
+// The candles are stored as raw records in the cache file and read in place
+static_assert(std::is_trivially_copyable<Candle>::value && sizeof(Candle) % 8 == 0, "Candle must be a trivially copyable record of 8-byte fields.");
+
 /**
  * @brief Constructor for the Cache class.
  *
  * Initializes the Cache object with the specified file path.
  *
- * @param file_path The file path where the dictionary will be cached.
+ * @param file_path The file path where the data will be cached.
+ * @param config_hash Hash of the configuration used to build the data. Default is 0.
  */
-Cache::Cache(const std::string &file_path) : file_path(file_path) {}
+Cache::Cache(const std::string &file_path, uint64_t config_hash) : file_path(file_path), config_hash(config_hash)
+{
+    this->mapped_dates = nullptr;
+    this->mapped_base_currency_conversion_rate = nullptr;
+    this->nb_mapped_dates = 0;
+}
 
 /**
- * @brief Caches the dictionary to the file specified in the constructor.
+ * @brief Write a value to a binary stream.
  *
- * This function writes the entire Cache object to the file, including
- * the dictionary data and the file path.
+ * @param file The output stream.
+ * @param value The value to write.
  */
-void Cache::create()
+template <typename T>
+static void write_value(std::ostream &file, const T &value)
+{
+    file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/**
+ * @brief Write a vector of values to a binary stream.
+ *
+ * @param file The output stream.
+ * @param values The values to write.
+ */
+template <typename T>
+static void write_values(std::ostream &file, const std::vector<T> &values)
+{
+    file.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+}
+
+/**
+ * @brief Writes the data added to the cache to the file specified in the constructor.
+ *
+ * The file is written next to its destination and renamed once complete, so an interrupted
+ * write never leaves a truncated cache behind.
+ *
+ * @param thread_pool Optional thread pool to build the sections of the file in parallel.
+ */
+void Cache::create(ThreadPool *thread_pool)
 {
     // Check if the directory exists, create it if it doesn't
-    std::string directory = this->file_path.substr(0, this->file_path.find_last_of("/"));
-    if (directory != this->file_path && !std::filesystem::exists(directory))
+    std::filesystem::path directory = std::filesystem::path(this->file_path).parent_path();
+    if (!directory.empty() && !std::filesystem::exists(directory))
     {
         std::filesystem::create_directories(directory);
     }
 
-    // Write the entire object to the file
-    std::ofstream file(file_path, std::ios::binary);
-    if (file.is_open())
+    // List all the timeframes and indicators of the data
+    std::set<TimeFrame> timeframes;
+    std::set<std::pair<TimeFrame, std::string>> features;
+    for (const auto &[date, value] : this->data)
     {
-        nlohmann::json json_data;
+        for (const auto &[tf, candles] : value.candles)
+        {
+            timeframes.insert(tf);
 
-        // Map for converting timeframes to strings
-        std::unordered_map<TimeFrame, std::string> tf_map = {
-            {TimeFrame::M1, "M1"},
-            {TimeFrame::M5, "M5"},
-            {TimeFrame::M15, "M15"},
-            {TimeFrame::M30, "M30"},
-            {TimeFrame::H1, "H1"},
-            {TimeFrame::H4, "H4"},
-            {TimeFrame::D1, "D1"}};
+            // The windows are stored as indexes in the timelines of the cache
+            auto timeline = this->candles.find(tf);
+            if (timeline == this->candles.end() || candles.timeline != timeline->second.data() || candles.end_index > timeline->second.size())
+            {
+                throw std::runtime_error("The candles of the date " + std::to_string(date) + " are not a view of the timelines of the cache.");
+            }
+        }
+        for (const auto &[tf, indicators] : value.indicators)
+        {
+            for (const auto &[id, values] : indicators)
+            {
+                features.insert({tf, id});
+            }
+        }
+    }
 
-        for (auto const &[date, value] : data)
+    // Build the candle and indicator sections, in parallel if a thread pool is given
+    std::vector<TimeFrame> candles_sections(timeframes.begin(), timeframes.end());
+    std::vector<std::pair<TimeFrame, std::string>> features_sections(features.begin(), features.end());
+    std::vector<std::string> sections(candles_sections.size() + features_sections.size());
+    auto build_section = [&](size_t index)
+    {
+        std::ostringstream section;
+        if (index < candles_sections.size())
         {
-            for (auto const &[tf, candles] : value.candles)
+            // Candle section
+            TimeFrame tf = candles_sections[index];
+            const std::vector<Candle> &timeline = this->candles.at(tf);
+            std::vector<uint64_t> ranges;
+            for (const auto &[date, value] : this->data)
             {
-                for (auto const &candle : candles)
-                {
-                    json_data[date]["candles"][tf_map[tf]] = nlohmann::json::array();
-                    json_data[date]["candles"][tf_map[tf]].push_back({
-                        {"date", candle.date},
-                        {"open", candle.open},
-                        {"high", candle.high},
-                        {"low", candle.low},
-                        {"close", candle.close},
-                        {"volume", candle.volume},
-                        {"tick_volume", candle.tick_volume},
-                        {"spread", candle.spread},
-                    });
-                }
+                auto it = value.candles.find(tf);
+                ranges.push_back(it != value.candles.end() ? it->second.begin_index : 0);
+                ranges.push_back(it != value.candles.end() ? it->second.end_index : 0);
             }
 
-            for (auto const &[tf, indicators] : value.indicators)
+            write_value(section, static_cast<int32_t>(tf));
+            write_value(section, static_cast<int32_t>(0));
+            write_value(section, static_cast<uint64_t>(timeline.size()));
+            write_values(section, timeline);
+            write_values(section, ranges);
+        }
+        else
+        {
+            // Indicator section
+            const auto &[tf, id] = features_sections[index - candles_sections.size()];
+            std::vector<uint64_t> offsets = {0};
+            std::vector<double> values;
+            for (const auto &[date, value] : this->data)
             {
-                json_data[date]["indicators"][tf_map[tf]] = nlohmann::json::object();
-                for (auto const &[id, values] : indicators)
+                auto tf_it = value.indicators.find(tf);
+                if (tf_it != value.indicators.end())
                 {
-                    json_data[date]["indicators"][tf_map[tf]][id] = nlohmann::json::array();
-                    for (auto const &value : values)
+                    auto id_it = tf_it->second.find(id);
+                    if (id_it != tf_it->second.end())
                     {
-                        json_data[date]["indicators"][tf_map[tf]][id].push_back(value);
+                        values.insert(values.end(), id_it->second.begin(), id_it->second.end());
                     }
                 }
+                offsets.push_back(values.size());
             }
 
-            json_data[date]["base_currency_conversion_rate"] = value.base_currency_conversion_rate;
+            write_value(section, static_cast<int32_t>(tf));
+            write_value(section, static_cast<uint32_t>(id.size()));
+            section.write(id.data(), id.size());
+            section.write("\0\0\0\0\0\0\0", (8 - id.size() % 8) % 8);
+            write_value(section, static_cast<uint64_t>(values.size()));
+            write_values(section, offsets);
+            write_values(section, values);
         }
+        sections[index] = section.str();
+    };
 
-        file << json_data.dump();
-        file.close();
+    if (thread_pool != nullptr)
+    {
+        thread_pool->parallel_for(sections.size(), build_section);
     }
     else
     {
-        throw std::runtime_error("Unable to open file for writing: " + file_path);
+        for (size_t i = 0; i < sections.size(); i++)
+        {
+            build_section(i);
+        }
+    }
+
+    std::string temp_file_path = this->file_path + ".tmp";
+    std::ofstream file(temp_file_path, std::ios::binary);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Unable to open file for writing: " + this->file_path);
+    }
+
+    // Header
+    CacheHeader header = {};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_VERSION;
+    header.nb_timeframes = timeframes.size();
+    header.config_hash = this->config_hash;
+    header.nb_dates = this->data.size();
+    header.nb_features = features.size();
+    write_value(file, header);
+
+    // Time index and conversion rates
+    std::vector<int64_t> dates;
+    std::vector<double> base_currency_conversion_rate;
+    for (const auto &[date, value] : this->data)
+    {
+        dates.push_back(date);
+        base_currency_conversion_rate.push_back(value.base_currency_conversion_rate);
+    }
+    write_values(file, dates);
+    write_values(file, base_currency_conversion_rate);
+
+    // Candle and indicator sections
+    for (const auto &section : sections)
+    {
+        file.write(section.data(), section.size());
+    }
+
+    file.close();
+    if (!file)
+    {
+        std::filesystem::remove(temp_file_path);
+        throw std::runtime_error("Unable to write the cache file: " + this->file_path);
+    }
+
+    std::filesystem::rename(temp_file_path, this->file_path);
+
+    for (const auto &[date, value] : this->data)
+    {
+        this->index(date, &value);
     }
 }
 
 /**
- * @brief Loads the cached dictionary from the file specified in the constructor.
+ * @brief Loads the cache from a file by memory-mapping it.
  *
- * This function reads the entire Cache object from the file, including
- * the dictionary data and the file path.
+ * The candles and the indicator values stay in the mapped file, only the time index and the
+ * candle windows of each date are built.
  *
- * @return Cache The loaded Cache object.
+ * @param file_path The file path of the cache.
+ * @return Cache* The loaded Cache object.
+ * @throws std::runtime_error If the file cannot be opened, is corrupted or has another version.
  */
 Cache *Cache::load(const std::string &file_path)
 {
-    std::ifstream file(file_path, std::ios::binary);
-    if (file.is_open())
-    {
-        Cache *cache = new Cache(file_path);
-        nlohmann::json json_data;
-        file >> json_data;
-
-        // Map for converting strings to timeframes
-        std::unordered_map<std::string, TimeFrame> tf_map = {
-            {"M1", TimeFrame::M1},
-            {"M5", TimeFrame::M5},
-            {"M15", TimeFrame::M15},
-            {"M30", TimeFrame::M30},
-            {"H1", TimeFrame::H1},
-            {"H4", TimeFrame::H4},
-            {"D1", TimeFrame::D1}};
-
-        for (auto const &[date, value] : json_data.items())
+    Cache *cache = new Cache(file_path);
+
+    try
+    {
+        cache->mapped_file.open(file_path);
+    }
+    catch (const std::exception &e)
+    {
+        delete cache;
+        throw std::runtime_error("Unable to open file for reading: " + file_path);
+    }
+
+    const char *begin = cache->mapped_file.data();
+    size_t size = cache->mapped_file.size();
+    size_t position = 0;
+
+    // Get a pointer to the next n values of the file and move the position forward
+    auto read = [&](size_t count, size_t value_size) -> const char *
+    {
+        size_t bytes = count * value_size;
+        if (bytes / value_size != count || position + bytes > size)
         {
-            CachedData cache_data;
-            for (auto const &[tf, candles] : value["candles"].items())
-            {
-                for (auto const &candle : candles)
-                {
-                    cache_data.candles[tf_map[tf]].push_back({
-                        candle["date"],
-                        candle["open"],
-                        candle["high"],
-                        candle["low"],
-                        candle["close"],
-                        candle["volume"],
-                        candle["tick_volume"],
-                        candle["spread"],
-                    });
-                }
-            }
+            delete cache;
+            throw std::runtime_error("The cache file is corrupted: " + file_path);
+        }
+        const char *pointer = begin + position;
+        position += (bytes + 7) / 8 * 8;
+        return pointer;
+    };
 
-            for (auto const &[tf, indicators] : value["indicators"].items())
-            {
-                for (auto const &[id, values] : indicators.items())
-                {
-                    std::vector<double> indicator_values;
-                    for (auto const &value : values)
-                    {
-                        indicator_values.push_back(value);
-                    }
-                    cache_data.indicators[tf_map[tf]][id] = indicator_values;
-                }
-            }
+    CacheHeader header;
+    std::memcpy(&header, read(1, sizeof(CacheHeader)), sizeof(CacheHeader));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0)
+    {
+        delete cache;
+        throw std::runtime_error("The file is not a cache file: " + file_path);
+    }
+    if (header.version != CACHE_VERSION)
+    {
+        delete cache;
+        throw std::runtime_error("The version of the cache file is not supported: " + file_path);
+    }
 
-            cache_data.base_currency_conversion_rate = value["base_currency_conversion_rate"];
+    cache->config_hash = header.config_hash;
+    cache->nb_mapped_dates = header.nb_dates;
+    cache->mapped_dates = reinterpret_cast<const int64_t *>(read(header.nb_dates, sizeof(int64_t)));
+    cache->mapped_base_currency_conversion_rate = reinterpret_cast<const double *>(read(header.nb_dates, sizeof(double)));
 
-            cache->add(date, cache_data);
+    for (uint32_t i = 0; i < header.nb_timeframes; i++)
+    {
+        CachedCandlesTimeline timeline;
+        timeline.timeframe = static_cast<TimeFrame>(*reinterpret_cast<const int32_t *>(read(2, sizeof(int32_t))));
+        timeline.nb_candles = *reinterpret_cast<const uint64_t *>(read(1, sizeof(uint64_t)));
+        timeline.candles = reinterpret_cast<const Candle *>(read(timeline.nb_candles, sizeof(Candle)));
+        timeline.ranges = reinterpret_cast<const uint64_t *>(read(2 * header.nb_dates, sizeof(uint64_t)));
+        for (uint64_t j = 0; j < header.nb_dates; j++)
+        {
+            if (timeline.ranges[2 * j] > timeline.ranges[2 * j + 1] || timeline.ranges[2 * j + 1] > timeline.nb_candles)
+            {
+                delete cache;
+                throw std::runtime_error("The cache file is corrupted: " + file_path);
+            }
         }
+        cache->mapped_candles.push_back(timeline);
+    }
 
-        file.close();
-        return cache;
+    for (uint64_t i = 0; i < header.nb_features; i++)
+    {
+        CachedFeatureColumn column;
+        const int32_t *feature_header = reinterpret_cast<const int32_t *>(read(2, sizeof(int32_t)));
+        column.timeframe = static_cast<TimeFrame>(feature_header[0]);
+        uint32_t id_size = static_cast<uint32_t>(feature_header[1]);
+        column.id = std::string(read(id_size, sizeof(char)), id_size);
+        uint64_t nb_values = *reinterpret_cast<const uint64_t *>(read(1, sizeof(uint64_t)));
+        column.offsets = reinterpret_cast<const uint64_t *>(read(header.nb_dates + 1, sizeof(uint64_t)));
+        column.values = reinterpret_cast<const double *>(read(nb_values, sizeof(double)));
+        if (column.offsets[header.nb_dates] != nb_values)
+        {
+            delete cache;
+            throw std::runtime_error("The cache file is corrupted: " + file_path);
+        }
+        cache->mapped_features.push_back(column);
     }
-    else
+
+    // Build the data of each date, the candles are views of the mapped timelines and the indicators are read in place with get_last_indicators_values
+    cache->mapped_data.resize(header.nb_dates);
+    cache->date_indexes.reserve(header.nb_dates);
+    for (uint64_t i = 0; i < header.nb_dates; i++)
     {
-        throw std::runtime_error("Unable to open file for reading: " + file_path);
+        CachedData &value = cache->mapped_data[i];
+        value.base_currency_conversion_rate = cache->mapped_base_currency_conversion_rate[i];
+
+        for (const auto &timeline : cache->mapped_candles)
+        {
+            uint64_t begin = timeline.ranges[2 * i];
+            uint64_t end = timeline.ranges[2 * i + 1];
+            if (begin != end)
+            {
+                value.candles[timeline.timeframe] = CandlesView(timeline.candles, begin, end);
+            }
+        }
+
+        cache->index(cache->mapped_dates[i], &value);
     }
+
+    return cache;
 }
 
 /**
@@ -179,38 +348,186 @@ bool Cache::exist()
 }
 
 /**
- * @brief Get the value of a key in the dictionary.
+ * @brief Get the data cached for a date.
  *
- * @param key The key whose value is to be retrieved.
- * @return CachedData The value of the key.
+ * @param date The date whose data is to be retrieved.
+ * @return The data of the date.
+ * @throws std::runtime_error If the date is not in the cache.
  */
-CachedData Cache::get(const std::string &key)
+const CachedData &Cache::get(time_t date) const
 {
-    if (!this->has(key))
+    auto it = this->data.find(date);
+    if (it != this->data.end())
     {
-        throw std::runtime_error("Key not found: " + key);
+        return it->second;
+    }
+
+    int index = this->find(date);
+    if (index < 0)
+    {
+        throw std::runtime_error("Date not found: " + std::to_string(date));
+    }
+    return *this->indexed_data[index];
+}
+
+/**
+ * @brief Get the index of a date in the time index.
+ *
+ * The lookup is done in constant time.
+ *
+ * @param date The date to look for.
+ * @return int The index of the date, or -1 if the date is not in the time index.
+ */
+int Cache::find(time_t date) const
+{
+    auto it = this->date_indexes.find(date);
+    return it != this->date_indexes.end() ? static_cast<int>(it->second) : -1;
+}
+
+/**
+ * @brief Get the data of the date at an index of the time index.
+ *
+ * @param index The index of the date, as returned by find.
+ * @return The data of the date.
+ */
+const CachedData &Cache::at(size_t index) const
+{
+    return *this->indexed_data[index];
+}
+
+/**
+ * @brief Get the last value of some indicators at each date of the time index, as a row-major matrix.
+ *
+ * The values of the dates of a loaded cache are read in place in the mapped file, the other
+ * ones are read in the indicators of their data.
+ *
+ * @param indicators The indicators of the columns of the matrix, as (timeframe, id) pairs.
+ * @param matrix The matrix of size() rows and indicators.size() columns to fill.
+ * @throws std::runtime_error If an indicator has no value at a date.
+ */
+void Cache::get_last_indicators_values(const std::vector<std::pair<TimeFrame, std::string>> &indicators, double *matrix) const
+{
+    size_t nb_columns = indicators.size();
+    for (size_t j = 0; j < nb_columns; j++)
+    {
+        const auto &[tf, id] = indicators[j];
+
+        // Find the column of the indicator in the mapped file
+        const CachedFeatureColumn *column = nullptr;
+        for (const auto &mapped_column : this->mapped_features)
+        {
+            if (mapped_column.timeframe == tf && mapped_column.id == id)
+            {
+                column = &mapped_column;
+                break;
+            }
+        }
+
+        for (size_t i = 0; i < this->indexed_data.size(); i++)
+        {
+            const CachedData *value = this->indexed_data[i];
+            bool has_value = false;
+
+            // The data of the mapped file have no indicators, their values are read in place
+            if (value >= this->mapped_data.data() && value < this->mapped_data.data() + this->mapped_data.size())
+            {
+                size_t mapped_index = value - this->mapped_data.data();
+                if (column != nullptr && column->offsets[mapped_index + 1] > column->offsets[mapped_index])
+                {
+                    matrix[i * nb_columns + j] = column->values[column->offsets[mapped_index + 1] - 1];
+                    has_value = true;
+                }
+            }
+            else
+            {
+                auto tf_it = value->indicators.find(tf);
+                if (tf_it != value->indicators.end())
+                {
+                    auto id_it = tf_it->second.find(id);
+                    if (id_it != tf_it->second.end() && !id_it->second.empty())
+                    {
+                        matrix[i * nb_columns + j] = id_it->second.back();
+                        has_value = true;
+                    }
+                }
+            }
+
+            if (!has_value)
+            {
+                throw std::runtime_error("The indicator " + id + " has no value in the cache at the date " + std::to_string(this->indexed_dates[i]));
+            }
+        }
     }
-    return data[key];
 }
 
 /**
- * @brief Set the value of a key in the dictionary.
+ * @brief Get the number of dates in the time index.
  *
- * @param key The key whose value is to be set.
- * @param value The value to be set.
+ * @return size_t The number of dates.
  */
-void Cache::add(const std::string &key, CachedData value)
+size_t Cache::size() const
 {
-    data[key] = value;
+    return this->indexed_dates.size();
 }
 
 /**
- * @brief Check if a key exists in the dictionary.
+ * @brief Add the data of a date to the cache.
  *
- * @param key The key to check.
- * @return bool True if the key exists, false otherwise.
+ * @param date The date of the data.
+ * @param value The data to be cached.
  */
-bool Cache::has(const std::string &key)
+void Cache::add(time_t date, CachedData value)
 {
-    return data.find(key) != data.end();
+    data[date] = value;
+}
+
+/**
+ * @brief Check if a date exists in the cache.
+ *
+ * @param date The date to check.
+ * @return bool True if the date exists, false otherwise.
+ */
+bool Cache::has(time_t date) const
+{
+    return this->data.find(date) != this->data.end() || this->find(date) >= 0;
+}
+
+/**
+ * @brief Get all the dates in the cache, sorted in ascending order.
+ *
+ * @return std::vector<time_t> The dates in the cache.
+ */
+std::vector<time_t> Cache::get_dates()
+{
+    std::set<time_t> dates(this->indexed_dates.begin(), this->indexed_dates.end());
+    for (const auto &[date, value] : this->data)
+    {
+        dates.insert(date);
+    }
+    return std::vector<time_t>(dates.begin(), dates.end());
+}
+
+/**
+ * @brief Add the data of a date to the time index.
+ *
+ * @param date The date of the data.
+ * @param value The data of the date, which must outlive the cache.
+ */
+void Cache::index(time_t date, const CachedData *value)
+{
+    auto it = this->date_indexes.find(date);
+    if (it != this->date_indexes.end())
+    {
+        this->indexed_data[it->second] = value;
+        return;
+    }
+
+    // The dates are usually indexed in ascending order, otherwise the following indexes are shifted
+    size_t position = std::lower_bound(this->indexed_dates.begin(), this->indexed_dates.end(), date) - this->indexed_dates.begin();
+    this->indexed_dates.insert(this->indexed_dates.begin() + position, date);
+    this->indexed_data.insert(this->indexed_data.begin() + position, value);
+    for (size_t i = position; i < this->indexed_dates.size(); i++)
+    {
+        this->date_indexes[this->indexed_dates[i]] = i;
+    }
 }
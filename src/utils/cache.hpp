@@ -4,21 +4,98 @@
 #include <iostream>
 #include <fstream>
 #include <stdexcept>
+#include <cstdint>
+#include <map>
 #include <unordered_map>
 #include <string>
+#include <vector>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include "../types.hpp"
+#include "thread_pool.hpp"
 
 /**
- * @brief Templated class for caching dictionary data to a file and loading it back.
+ * @brief Magic bytes at the beginning of every cache file.
+ */
+constexpr char CACHE_MAGIC[8] = {'T', 'R', 'F', 'C', 'A', 'C', 'H', 'E'};
+
+/**
+ * @brief Version of the binary layout of the cache file. Files with another version are rebuilt.
+ */
+constexpr uint32_t CACHE_VERSION = 2;
+
+/**
+ * @brief Fixed header at the beginning of a cache file.
+ *
+ * The header is followed by 8-byte aligned sections, in this order:
+ * - the time index: `nb_dates` sorted dates (int64),
+ * - the base currency conversion rates: `nb_dates` doubles,
+ * - `nb_timeframes` candle sections: timeframe (int32), padding (int32), number of candles (uint64),
+ *   the timeline of the candles stored once as Candle records, and the window of each date as
+ *   `nb_dates` (begin, end) index pairs (uint64) in the timeline,
+ * - `nb_features` indicator sections: timeframe (int32), length of the id (uint32), id (padded),
+ *   number of values (uint64), `nb_dates + 1` value offsets (uint64) and the values (double).
+ *
+ * The values of the date at index `i` are stored between the offsets `i` and `i + 1` of an indicator section.
+ * All the numbers are stored with the native byte order.
+ */
+struct CacheHeader
+{
+    char magic[8];          // Magic bytes to identify the file.
+    uint32_t version;       // Version of the binary layout.
+    uint32_t nb_timeframes; // Number of candle sections.
+    uint64_t config_hash;   // Hash of the configuration used to build the data.
+    uint64_t nb_dates;      // Number of dates in the time index.
+    uint64_t nb_features;   // Number of indicator sections.
+    uint64_t reserved[3];   // Reserved for future use.
+};
+
+/**
+ * @brief Timeline of the candles of a timeframe read in place from a cache file.
+ */
+struct CachedCandlesTimeline
+{
+    TimeFrame timeframe;    // Timeframe of the candles.
+    const Candle *candles;  // Candles of the timeline.
+    uint64_t nb_candles;    // Number of candles in the timeline.
+    const uint64_t *ranges; // Window (begin, end) of each date in the timeline (2 * nb_dates values).
+};
+
+/**
+ * @brief Column of the values of an indicator read in place from a cache file.
+ */
+struct CachedFeatureColumn
+{
+    TimeFrame timeframe;     // Timeframe of the indicator.
+    std::string id;          // Id of the indicator.
+    const uint64_t *offsets; // Value offsets of each date (nb_dates + 1 values).
+    const double *values;    // Values of the indicator.
+};
+
+/**
+ * @brief Class for caching the training data to a binary file and loading it back.
  *
- * This class provides functionality to cache a dictionary of key-value pairs to a file
- * and to load the cached data back into memory.
+ * The data are written in a versioned columnar format (see CacheHeader) and the file is
+ * memory-mapped when loaded, so the values are read in place without any parsing.
  */
 class Cache
 {
 public:
-    std::string file_path;                  // The file path where the dictionary will be cached.
-    std::map<std::string, CachedData> data; // The dictionary data to be cached.
+    std::string file_path;             // The file path where the data will be cached.
+    uint64_t config_hash;              // Hash of the configuration used to build the data.
+    CandlesData candles;               // The candle timelines the windows of the added data are views of.
+    std::map<time_t, CachedData> data; // The data added to the cache and not written yet.
+
+private:
+    boost::iostreams::mapped_file_source mapped_file;   // The memory-mapped cache file.
+    const int64_t *mapped_dates;                        // Time index of the mapped file.
+    const double *mapped_base_currency_conversion_rate; // Conversion rates of the mapped file.
+    size_t nb_mapped_dates;                             // Number of dates in the mapped file.
+    std::vector<CachedCandlesTimeline> mapped_candles;  // Candle sections of the mapped file.
+    std::vector<CachedFeatureColumn> mapped_features;   // Indicator sections of the mapped file.
+    std::vector<CachedData> mapped_data;                // Data of each date of the mapped file, with the candles read in place and without the indicators.
+    std::vector<time_t> indexed_dates;                  // Dates of the time index, sorted in ascending order.
+    std::vector<const CachedData *> indexed_data;       // Data of each date of the time index.
+    std::unordered_map<time_t, size_t> date_indexes;    // Index of each date in the time index.
 
 public:
     /**
@@ -26,25 +103,30 @@ public:
      *
      * Initializes the Cache object with the specified file path.
      *
-     * @param file_path The file path where the dictionary will be cached.
+     * @param file_path The file path where the data will be cached.
+     * @param config_hash Hash of the configuration used to build the data. Default is 0.
      */
-    Cache(const std::string &file_path);
+    Cache(const std::string &file_path, uint64_t config_hash = 0);
 
     /**
-     * @brief Caches the dictionary to the file specified in the constructor.
+     * @brief Writes the data added to the cache to the file specified in the constructor.
+     *
+     * The file is written next to its destination and renamed once complete, so an interrupted
+     * write never leaves a truncated cache behind. The written data are then added to the time index.
      *
-     * This function writes the entire Cache object to the file, including
-     * the dictionary data and the file path.
+     * @param thread_pool Optional thread pool to build the sections of the file in parallel.
      */
-    void create();
+    void create(ThreadPool *thread_pool = nullptr);
 
     /**
-     * @brief Loads the cached dictionary from the file specified in the constructor.
+     * @brief Loads the cache from a file by memory-mapping it.
      *
-     * This function reads the entire Cache object from the file, including
-     * the dictionary data and the file path.
+     * The candles and the indicator values stay in the mapped file, only the time index and the
+     * candle windows of each date are built.
      *
-     * @return Cache The loaded Cache object.
+     * @param file_path The file path of the cache.
+     * @return Cache* The loaded Cache object.
+     * @throws std::runtime_error If the file cannot be opened, is corrupted or has another version.
      */
     static Cache *load(const std::string &file_path);
 
@@ -56,28 +138,84 @@ public:
     bool exist();
 
     /**
-     * @brief Get the value of a key in the dictionary.
+     * @brief Get the data cached for a date.
+     *
+     * @param date The date whose data is to be retrieved.
+     * @return The data of the date.
+     * @throws std::runtime_error If the date is not in the cache.
+     */
+    const CachedData &get(time_t date) const;
+
+    /**
+     * @brief Get the index of a date in the time index.
+     *
+     * The lookup is done in constant time.
+     *
+     * @param date The date to look for.
+     * @return int The index of the date, or -1 if the date is not in the time index.
+     */
+    int find(time_t date) const;
+
+    /**
+     * @brief Get the data of the date at an index of the time index.
+     *
+     * @param index The index of the date, as returned by find.
+     * @return The data of the date.
+     */
+    const CachedData &at(size_t index) const;
+
+    /**
+     * @brief Get the last value of some indicators at each date of the time index, as a row-major matrix.
+     *
+     * The values of the dates of a loaded cache are read in place in the mapped file, the other
+     * ones are read in the indicators of their data.
+     *
+     * @param indicators The indicators of the columns of the matrix, as (timeframe, id) pairs.
+     * @param matrix The matrix of size() rows and indicators.size() columns to fill.
+     * @throws std::runtime_error If an indicator has no value at a date.
+     */
+    void get_last_indicators_values(const std::vector<std::pair<TimeFrame, std::string>> &indicators, double *matrix) const;
+
+    /**
+     * @brief Get the number of dates in the time index.
+     *
+     * @return size_t The number of dates.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Add the data of a date to the cache.
+     *
+     * The candle windows of the data must be views of the timelines in `candles`.
+     *
+     * @param date The date of the data.
+     * @param value The data to be cached.
+     */
+    void add(time_t date, CachedData value);
+
+    /**
+     * @brief Check if a date exists in the cache.
      *
-     * @param key The key whose value is to be retrieved.
-     * @return The value of the key.
+     * @param date The date to check.
+     * @return bool True if the date exists, false otherwise.
      */
-    CachedData get(const std::string &key);
+    bool has(time_t date) const;
 
     /**
-     * @brief Set the value of a key in the dictionary.
+     * @brief Get all the dates in the cache, sorted in ascending order.
      *
-     * @param key The key whose value is to be set.
-     * @param value The value to be set.
+     * @return std::vector<time_t> The dates in the cache.
      */
-    void add(const std::string &key, CachedData value);
+    std::vector<time_t> get_dates();
 
+private:
     /**
-     * @brief Check if a key exists in the dictionary.
+     * @brief Add the data of a date to the time index.
      *
-     * @param key The key to check.
-     * @return bool True if the key exists, false otherwise.
+     * @param date The date of the data.
+     * @param value The data of the date, which must outlive the cache.
      */
-    bool has(const std::string &key);
+    void index(time_t date, const CachedData *value);
 };
 
 #endif // CACHE_HPP
@@ -15,11 +15,8 @@
 std::string time_t_to_string(time_t time, const std::string &format)
 {
     std::stringstream ss;
-#ifdef _WIN32
-    ss << std::put_time(std::gmtime(&time), format.c_str());
-#else
-    ss << std::put_time(std::localtime(&time), format.c_str());
-#endif
+    std::tm tm = time_t_to_tm(time);
+    ss << std::put_time(&tm, format.c_str());
     return ss.str();
 }
 
@@ -40,16 +37,19 @@ time_t string_to_time_t(const std::string &time, const std::string &format)
 
 /**
  * @brief Convert time_t to std::tm.
+ * The reentrant versions of the conversion functions are used, so it can be called from several threads.
  * @param time Time in time_t format.
  * @return Time in std::tm format.
  */
 std::tm time_t_to_tm(time_t time)
 {
+    std::tm tm = {};
 #ifdef _WIN32
-    return *std::gmtime(&time);
+    gmtime_s(&tm, &time);
 #else
-    return *std::localtime(&time);
+    localtime_r(&time, &tm);
 #endif
+    return tm;
 }
 
 /**
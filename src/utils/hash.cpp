@@ -0,0 +1,48 @@
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include "hash.hpp"
+
+/**
+ * @brief Hash a block of bytes with the 64-bit FNV-1a algorithm.
+ *
+ * @param data Pointer to the bytes to hash.
+ * @param size The number of bytes to hash.
+ * @param seed The initial value of the hash. Default is the FNV offset basis.
+ * @return uint64_t The hash of the bytes.
+ */
+uint64_t hash_bytes(const void *data, size_t size, uint64_t seed)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL; // FNV prime
+    }
+    return hash;
+}
+
+/**
+ * @brief Hash a string with the 64-bit FNV-1a algorithm.
+ *
+ * @param value The string to hash.
+ * @param seed The initial value of the hash. Default is the FNV offset basis.
+ * @return uint64_t The hash of the string.
+ */
+uint64_t hash_string(const std::string &value, uint64_t seed)
+{
+    return hash_bytes(value.data(), value.size(), seed);
+}
+
+/**
+ * @brief Combine a hash with another value to build the hash of a composite object.
+ *
+ * @param seed The current hash.
+ * @param value The value to combine with the hash.
+ * @return uint64_t The combined hash.
+ */
+uint64_t hash_combine(uint64_t seed, uint64_t value)
+{
+    return hash_bytes(&value, sizeof(value), seed);
+}
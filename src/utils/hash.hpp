@@ -0,0 +1,43 @@
+#ifndef HASH_HPP
+#define HASH_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Offset basis of the 64-bit FNV-1a hash, used as the default seed.
+ */
+constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+
+/**
+ * @brief Hash a block of bytes with the 64-bit FNV-1a algorithm.
+ *
+ * The hash is stable across runs and platforms, so it can be persisted in files.
+ *
+ * @param data Pointer to the bytes to hash.
+ * @param size The number of bytes to hash.
+ * @param seed The initial value of the hash. Default is the FNV offset basis.
+ * @return uint64_t The hash of the bytes.
+ */
+uint64_t hash_bytes(const void *data, size_t size, uint64_t seed = FNV_OFFSET_BASIS);
+
+/**
+ * @brief Hash a string with the 64-bit FNV-1a algorithm.
+ *
+ * @param value The string to hash.
+ * @param seed The initial value of the hash. Default is the FNV offset basis.
+ * @return uint64_t The hash of the string.
+ */
+uint64_t hash_string(const std::string &value, uint64_t seed = FNV_OFFSET_BASIS);
+
+/**
+ * @brief Combine a hash with another value to build the hash of a composite object.
+ *
+ * @param seed The current hash.
+ * @param value The value to combine with the hash.
+ * @return uint64_t The combined hash.
+ */
+uint64_t hash_combine(uint64_t seed, uint64_t value);
+
+#endif // HASH_HPP
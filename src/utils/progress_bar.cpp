@@ -1,6 +1,7 @@
 #include <iostream>
 #include <string>
 #include <chrono>
+#include <mutex>
 #include "progress_bar.hpp"
 
 /**
@@ -14,11 +15,14 @@ ProgressBar::ProgressBar(int width, int total_iterations, std::string label)
 
 /**
  * @brief Updates the progress bar with the iteration given.
+ * It can be called from several threads to report their aggregate progress.
  * @param progress_iteration The number of iteration to add to the progress bar.
  * @param new_label Optional new label to display.
  */
 void ProgressBar::update(int progress_iteration, std::string new_label)
 {
+    std::lock_guard<std::mutex> lock(mutex);
+
     current_iteration += progress_iteration;
     float progress = static_cast<float>(current_iteration) / total_iterations;
     int pos = static_cast<int>(width * progress);
@@ -3,6 +3,7 @@
 
 #include <chrono>
 #include <iostream>
+#include <mutex>
 #include <string>
 
 /**
@@ -21,6 +22,7 @@ public:
 
     /**
      * @brief Updates the progress bar with the iteration given.
+     * It can be called from several threads to report their aggregate progress.
      * @param progress_iteration The number of iteration to add to the progress bar.
      * @param new_label Optional new label to display.
      */
@@ -38,6 +40,7 @@ private:
     int total_iterations;                                                                // The total number of iterations.
     std::string label;                                                                   // The label for the progress bar.
     std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now(); // The start time of the progress bar.
+    std::mutex mutex;                                                                    // Mutex protecting the updates from several threads.
 
     /**
      * @brief Formats a time duration in seconds to a human-readable format.
@@ -0,0 +1,79 @@
+#include <cstdint>
+#include "random.hpp"
+
+// Next value of a splitmix64 sequence, used to spread the bits of the seeds
+static uint64_t splitmix64(uint64_t &state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static uint64_t rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * @brief Constructs a generator from a seed.
+ * @param seed The seed of the generator.
+ */
+RandomGenerator::RandomGenerator(uint64_t seed)
+{
+    this->seed(seed);
+}
+
+/**
+ * @brief Reset the state of the generator from a seed.
+ * @param seed The seed of the generator.
+ */
+void RandomGenerator::seed(uint64_t seed)
+{
+    for (auto &s : this->state)
+    {
+        s = splitmix64(seed);
+    }
+}
+
+/**
+ * @brief Generates the next random 64-bit value.
+ * @return The random value.
+ */
+uint64_t RandomGenerator::operator()()
+{
+    uint64_t result = rotl(this->state[1] * 5, 7) * 9;
+    uint64_t t = this->state[1] << 17;
+
+    this->state[2] ^= this->state[0];
+    this->state[3] ^= this->state[1];
+    this->state[1] ^= this->state[2];
+    this->state[0] ^= this->state[3];
+    this->state[2] ^= t;
+    this->state[3] = rotl(this->state[3], 45);
+
+    return result;
+}
+
+/**
+ * @brief Generates a random double value in the range [0, 1).
+ * @return The random value.
+ */
+double RandomGenerator::next_double()
+{
+    // The 53 high bits fill the mantissa of the double
+    return ((*this)() >> 11) * 0x1.0p-53;
+}
+
+/**
+ * @brief Derives the seed of a stream of random values from a master seed, the streams of different indexes are independent.
+ *
+ * @param master_seed The master seed.
+ * @param stream The index of the stream.
+ * @return The seed of the stream.
+ */
+uint64_t derive_seed(uint64_t master_seed, uint64_t stream)
+{
+    uint64_t state = master_seed ^ splitmix64(stream);
+    return splitmix64(state);
+}
@@ -0,0 +1,54 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <cstdint>
+
+/**
+ * @brief Fast pseudo-random generator (xoshiro256**), usable with the distributions of the standard library.
+ */
+class RandomGenerator
+{
+public:
+    using result_type = uint64_t;
+
+    /**
+     * @brief Constructs a generator from a seed.
+     * @param seed The seed of the generator.
+     */
+    RandomGenerator(uint64_t seed = 0);
+
+    /**
+     * @brief Reset the state of the generator from a seed.
+     * @param seed The seed of the generator.
+     */
+    void seed(uint64_t seed);
+
+    /**
+     * @brief Generates the next random 64-bit value.
+     * @return The random value.
+     */
+    uint64_t operator()();
+
+    /**
+     * @brief Generates a random double value in the range [0, 1).
+     * @return The random value.
+     */
+    double next_double();
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+private:
+    uint64_t state[4]; // State of the generator.
+};
+
+/**
+ * @brief Derives the seed of a stream of random values from a master seed, the streams of different indexes are independent.
+ *
+ * @param master_seed The master seed.
+ * @param stream The index of the stream.
+ * @return The seed of the stream.
+ */
+uint64_t derive_seed(uint64_t master_seed, uint64_t stream);
+
+#endif // RANDOM_HPP
@@ -8,7 +8,11 @@
 #include <chrono>
 #include <iomanip>
 #include <algorithm>
-#include <regex>
+#include <cstring>
+#include <cstdlib>
+#include <charconv>
+#include <filesystem>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include "date_conversion.hpp"
 #include "time_frame.hpp"
 #include "read_data.hpp"
@@ -16,24 +20,24 @@
 // Headers columns in the CSV file
 std::vector<std::string> columns_names = {"Time", "Open", "High", "Low", "Close", "Volume", "Spread"};
 
+// Supported formats of the dates in the CSV file (dots are accepted in place of the dashes)
+std::vector<std::string> date_formats = {"%Y-%m-%d %H:%M:%S", "%Y-%m-%d %H:%M"};
+
 /**
- * @brief Read the header of a CSV file.
+ * @brief Split a header line and check its columns are supported.
  *
- * @param csv_file The CSV file to read.
- * @param separator The separator used in the CSV file (optional, default is a comma).
+ * @param line The header line.
+ * @param separator The separator used in the CSV file.
  * @return std::vector<std::string> A vector of column names.
  */
-std::vector<std::string> read_header(std::ifstream &csv_file, std::string separator)
+static std::vector<std::string> parse_header(const std::string &line, char separator)
 {
-    std::string line;
-    std::getline(csv_file, line);
-
     std::vector<std::string> columns;
     std::istringstream header_ss(line);
     std::string token;
 
     // Split the header by the separator
-    while (std::getline(header_ss, token, separator[0]))
+    while (std::getline(header_ss, token, separator))
     {
         token.erase(std::remove(token.begin(), token.end(), '\r'), token.end()); // Remove carriage return
         columns.push_back(token);
@@ -58,9 +62,212 @@ std::vector<std::string> read_header(std::ifstream &csv_file, std::string separa
     return columns;
 }
 
+/**
+ * @brief Read the header of a CSV file.
+ *
+ * @param csv_file The CSV file to read.
+ * @param separator The separator used in the CSV file (optional, default is a comma).
+ * @return std::vector<std::string> A vector of column names.
+ */
+std::vector<std::string> read_header(std::ifstream &csv_file, std::string separator)
+{
+    std::string line;
+    std::getline(csv_file, line);
+    return parse_header(line, separator[0]);
+}
+
+/**
+ * @brief Parse the digits between two pointers as an unsigned number.
+ *
+ * @param begin Pointer to the first digit.
+ * @param end Pointer past the last digit.
+ * @param value The parsed number.
+ * @return bool True if all the characters are digits, false otherwise.
+ */
+static bool parse_digits(const char *begin, const char *end, int &value)
+{
+    value = 0;
+    for (const char *c = begin; c < end; c++)
+    {
+        if (*c < '0' || *c > '9')
+        {
+            return false;
+        }
+        value = value * 10 + (*c - '0');
+    }
+    return true;
+}
+
+/**
+ * @brief Parse a date in the format "YYYY-MM-DD HH:MM[:SS]" (or with dots in the day) into a std::tm.
+ *
+ * @param begin Pointer to the first character of the date.
+ * @param end Pointer past the last character of the date.
+ * @param with_seconds True if the date contains the seconds.
+ * @param tm The parsed date, with the daylight saving time left to mktime.
+ * @return bool True if the date matches the format, false otherwise.
+ */
+static bool parse_date(const char *begin, const char *end, bool with_seconds, std::tm &tm)
+{
+    if (end - begin != (with_seconds ? 19 : 16))
+    {
+        return false;
+    }
+
+    int year, month, day, hour, minute, second = 0;
+    bool valid = parse_digits(begin, begin + 4, year) &&
+                 (begin[4] == '-' || begin[4] == '.') &&
+                 parse_digits(begin + 5, begin + 7, month) &&
+                 begin[7] == begin[4] &&
+                 parse_digits(begin + 8, begin + 10, day) &&
+                 begin[10] == ' ' &&
+                 parse_digits(begin + 11, begin + 13, hour) &&
+                 begin[13] == ':' &&
+                 parse_digits(begin + 14, begin + 16, minute) &&
+                 (!with_seconds || (begin[16] == ':' && parse_digits(begin + 17, begin + 19, second)));
+    if (!valid)
+    {
+        return false;
+    }
+
+    tm = {};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
+    tm.tm_hour = hour;
+    tm.tm_min = minute;
+    tm.tm_sec = second;
+    tm.tm_isdst = -1; // This is important to avoid daylight saving time issues.
+    return true;
+}
+
+/**
+ * @brief Parse the number between two pointers.
+ *
+ * @param begin Pointer to the first character of the number.
+ * @param end Pointer past the last character of the number.
+ * @param value The parsed number.
+ * @return bool True if the whole token is a number, false otherwise.
+ */
+static bool parse_number(const char *begin, const char *end, double &value)
+{
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    if (begin < end && *begin == '+')
+    {
+        begin++;
+    }
+    std::from_chars_result result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+#else
+    // Fallback for the standard libraries without floating point from_chars
+    char buffer[64];
+    size_t length = end - begin;
+    if (length == 0 || length >= sizeof(buffer))
+    {
+        return false;
+    }
+    std::memcpy(buffer, begin, length);
+    buffer[length] = '\0';
+    char *parsed_end = nullptr;
+    value = std::strtod(buffer, &parsed_end);
+    return parsed_end == buffer + length;
+#endif
+}
+
+/**
+ * @brief Reader of the rows of a memory-mapped CSV file of candles.
+ */
+struct CandlesCsvReader
+{
+    std::vector<double Candle::*> fields; // Field of the candle set by each column, null for the time column.
+    size_t time_column;                   // Index of the time column.
+    bool with_seconds;                    // True if the dates contain the seconds.
+    time_t date_offset;                   // Offset added to the opening time of a candle to get its closing time.
+    char separator;                       // Separator of the columns.
+
+    /**
+     * @brief Get the pointer past the end of the line starting at a position.
+     */
+    static const char *line_end(const char *position, const char *end)
+    {
+        const char *newline = static_cast<const char *>(std::memchr(position, '\n', end - position));
+        return newline ? newline : end;
+    }
+
+    /**
+     * @brief Get the position of the first line starting at or after a position.
+     */
+    static const char *next_line(const char *begin, const char *position, const char *end)
+    {
+        if (position == begin || position[-1] == '\n')
+        {
+            return position;
+        }
+        const char *eol = line_end(position, end);
+        return eol == end ? end : eol + 1;
+    }
+
+    /**
+     * @brief Parse the row between two pointers into a candle.
+     *
+     * @return bool False if the row is empty.
+     */
+    bool parse_row(const char *begin, const char *end, Candle &candle) const
+    {
+        // Remove carriage return
+        if (end > begin && end[-1] == '\r')
+        {
+            end--;
+        }
+        if (begin == end)
+        {
+            return false;
+        }
+
+        candle = {};
+        const char *token = begin;
+        for (size_t i = 0; i < this->fields.size(); i++)
+        {
+            const char *token_end = static_cast<const char *>(std::memchr(token, this->separator, end - token));
+            if (!token_end)
+            {
+                token_end = end;
+            }
+
+            if (i == this->time_column)
+            {
+                std::tm tm;
+                if (!parse_date(token, token_end, this->with_seconds, tm))
+                {
+                    std::cerr << "Invalid date format: " << std::string(token, token_end) << std::endl;
+                    std::cerr << "Supported formats:" << std::endl;
+                    for (const auto &format : date_formats)
+                    {
+                        std::cerr << "\t" << format << std::endl;
+                    }
+                    std::cerr << std::endl;
+                    std::exit(1);
+                }
+                candle.date = std::mktime(&tm) + this->date_offset; // Date corresponds to the closing time of the candle
+            }
+            else if (!parse_number(token, token_end, candle.*(this->fields[i])))
+            {
+                std::cerr << "Invalid number when reading data: " << std::string(begin, end) << std::endl;
+                std::exit(1);
+            }
+
+            token = token_end == end ? end : token_end + 1;
+        }
+        return true;
+    }
+};
+
 /**
  * @brief Read candle data from a CSV file for a specified symbol and time frame.
  *
+ * The file is memory-mapped and the rows, sorted by date, are parsed in place. The first row
+ * at or after the start date is found by a binary search, so the older rows are not parsed.
+ *
  * @param symbol The symbol for which the data is to be read.
  * @param time_frame The time frame of the data (M1, M5, H1, etc.).
  * @param start_date The start date for filtering data (optional, default is the Unix epoch).
@@ -77,126 +284,154 @@ std::vector<Candle> read_data(const std::string &symbol, TimeFrame time_frame, t
 
     std::string file = "./data/" + symbol + "/" + symbol + "_" + time_frame_str + ".csv";
 
-    std::ifstream csv_file(file);
-    if (!csv_file.is_open())
+    std::error_code error;
+    uintmax_t file_size = std::filesystem::file_size(file, error);
+    if (error)
     {
         std::cerr << "No data for " << symbol << " on " << time_frame_str;
         std::exit(1);
     }
+    if (file_size == 0)
+    {
+        return candles;
+    }
 
-    std::string line;
+    boost::iostreams::mapped_file_source mapped_file;
+    try
+    {
+        mapped_file.open(file);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "No data for " << symbol << " on " << time_frame_str;
+        std::exit(1);
+    }
+
+    const char *begin = mapped_file.data();
+    const char *end = begin + mapped_file.size();
 
     // Read the header
-    std::vector<std::string> columns = read_header(csv_file, separator);
+    const char *header_end = CandlesCsvReader::line_end(begin, end);
+    std::vector<std::string> columns = parse_header(std::string(begin, header_end), separator[0]);
+    const char *data_begin = header_end == end ? end : header_end + 1;
 
-    // Read the data
-    while (std::getline(csv_file, line))
+    CandlesCsvReader reader;
+    reader.with_seconds = false;
+    reader.separator = separator[0];
+    reader.date_offset = 60 * get_time_frame_in_minutes(time_frame);
+    reader.time_column = columns.size();
+    for (size_t i = 0; i < columns.size(); i++)
     {
-        // Skip empty lines
-        if (line.empty())
+        if (columns[i] == "Time")
         {
-            continue;
+            reader.time_column = i;
+            reader.fields.push_back(nullptr);
         }
-
-        std::istringstream ss(line);
-        std::string token;
-        Candle candle;
-
-        for (size_t i = 0; i < columns.size(); i++)
+        else if (columns[i] == "Open")
         {
-            // Split the line by the separator
-            std::getline(ss, token, separator[0]);
-
-            // Remove carriage return
-            token.erase(std::remove(token.begin(), token.end(), '\r'), token.end());
-
-            if (columns[i] == "Time")
-            {
-                std::string date_str = token;                             // Copy the date string
-                std::replace(date_str.begin(), date_str.end(), '.', '-'); // Replace dots with dashes
-                std::string date_format = "";                             // The format of the date for the conversion
-
-                // Find the format of the date
-                std::unordered_map<std::string, std::regex> date_formats = {
-                    {"%Y-%m-%d %H:%M:%S", std::regex("\\d{4}\\-\\d{2}\\-\\d{2} \\d{2}:\\d{2}:\\d{2}")},
-                    {"%Y-%m-%d %H:%M", std::regex("\\d{4}\\-\\d{2}\\-\\d{2} \\d{2}:\\d{2}")},
-                };
-
-                // Check if the date string matches any of the supported formats
-                for (const auto &[format, pattern] : date_formats)
-                {
-                    if (std::regex_match(date_str, pattern))
-                    {
-                        date_format = format;
-                        break;
-                    }
-                }
-
-                // If the date format is empty, the date string is invalid
-                if (date_format == "")
-                {
-                    std::cerr << "Invalid date format: " << date_str << std::endl;
-                    std::cerr << "Supported formats:" << std::endl;
-                    for (const auto &[format, pattern] : date_formats)
-                    {
-                        std::cerr << "\t" << format << std::endl;
-                    }
-                    std::cerr << std::endl;
-                    std::exit(1);
-                }
+            reader.fields.push_back(&Candle::open);
+        }
+        else if (columns[i] == "High")
+        {
+            reader.fields.push_back(&Candle::high);
+        }
+        else if (columns[i] == "Low")
+        {
+            reader.fields.push_back(&Candle::low);
+        }
+        else if (columns[i] == "Close")
+        {
+            reader.fields.push_back(&Candle::close);
+        }
+        else if (columns[i] == "Volume")
+        {
+            reader.fields.push_back(&Candle::volume);
+        }
+        else if (columns[i] == "Spread")
+        {
+            reader.fields.push_back(&Candle::spread);
+        }
+    }
 
-                // Convert the date string to a time_t
-                std::tm tm = string_to_tm(date_str, date_format);
-                time_t date = std::mktime(&tm) + 60 * get_time_frame_in_minutes(time_frame);
+    // Find the format of the dates once from the first row
+    const char *first_row = data_begin;
+    while (first_row < end && (*first_row == '\n' || *first_row == '\r'))
+    {
+        first_row++;
+    }
+    if (reader.time_column < columns.size() && first_row < end)
+    {
+        const char *date = first_row;
+        for (size_t i = 0; i < reader.time_column && date < end; i++)
+        {
+            const char *separator_position = static_cast<const char *>(std::memchr(date, reader.separator, end - date));
+            date = separator_position ? separator_position + 1 : end;
+        }
+        const char *date_end = date;
+        while (date_end < end && *date_end != reader.separator && *date_end != '\n' && *date_end != '\r')
+        {
+            date_end++;
+        }
+        reader.with_seconds = date_end - date == 19;
+    }
 
-                // Set the date of the candle
-                candle.date = date; // Date corresponds to the closing time of the candle
-            }
-            else if (columns[i] == "Open")
-            {
-                candle.open = std::stod(token);
-            }
-            else if (columns[i] == "High")
-            {
-                candle.high = std::stod(token);
-            }
-            else if (columns[i] == "Low")
-            {
-                candle.low = std::stod(token);
-            }
-            else if (columns[i] == "Close")
+    // The rows are sorted by date: binary search the first row at or after the start date.
+    // All the rows before `low` are older than the start date.
+    const char *low = data_begin;
+    const char *high = end;
+    if (reader.time_column < columns.size())
+    {
+        while (low < high)
+        {
+            const char *middle = CandlesCsvReader::next_line(data_begin, low + (high - low) / 2, end);
+            if (middle >= high)
             {
-                candle.close = std::stod(token);
+                break;
             }
-            else if (columns[i] == "Volume")
+
+            const char *middle_end = CandlesCsvReader::line_end(middle, end);
+            Candle candle;
+            if (!reader.parse_row(middle, middle_end, candle) || middle_end == end)
             {
-                candle.volume = std::stod(token);
+                break; // Let the sequential read handle the empty lines and the last row
             }
-            else if (columns[i] == "Spread")
+            else if (candle.date >= start_date)
             {
-                candle.spread = std::stod(token);
+                high = middle;
             }
             else
             {
-                std::cerr << "Invalid column when reading data: " << columns[i] << std::endl;
-                std::exit(1);
+                low = middle_end + 1;
             }
         }
+    }
 
-        // Filter candles by date
-        time_t candle_date = candle.date;
-        if (candle_date >= start_date && candle_date <= end_date)
-        {
-            candles.push_back(candle);
-        }
+    // Read the data
+    for (const char *row = low; row < end;)
+    {
+        const char *row_end = CandlesCsvReader::line_end(row, end);
+        Candle candle;
 
-        // Stop reading data if the date of the candle is greater than the end date
-        if (candle_date > end_date)
+        // Skip empty lines
+        if (reader.parse_row(row, row_end, candle))
         {
-            break;
+            // Filter candles by date
+            time_t candle_date = candle.date;
+            if (candle_date >= start_date && candle_date <= end_date)
+            {
+                candles.push_back(candle);
+            }
+
+            // Stop reading data if the date of the candle is greater than the end date
+            if (candle_date > end_date)
+            {
+                break;
+            }
         }
+
+        row = row_end == end ? end : row_end + 1;
     }
 
-    csv_file.close();
+    mapped_file.close();
     return candles;
 }
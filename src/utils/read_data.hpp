@@ -24,6 +24,9 @@ std::vector<std::string> read_header(std::ifstream &csv_file, std::string separa
 /**
  * @brief Read candle data from a CSV file for a specified symbol and time frame.
  *
+ * The file is memory-mapped and the rows, sorted by date, are parsed in place. The first row
+ * at or after the start date is found by a binary search, so the older rows are not parsed.
+ *
  * @param symbol The symbol for which the data is to be read.
  * @param time_frame The time frame of the data (M1, M5, H1, etc.).
  * @param start_date The start date for filtering data (optional, default is the Unix epoch).
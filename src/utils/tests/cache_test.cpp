@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <fstream>
 #include "../cache.hpp"
 
 // Fixture class for Cache tests
@@ -7,14 +8,14 @@ class CacheTest : public ::testing::Test
 protected:
     void SetUp() override
     {
-        cache = new Cache("cache/test_cache.json");
+        cache = new Cache("cache/test_cache.bin");
     }
 
     void TearDown() override
     {
         delete cache;
         // Remove the file
-        std::filesystem::remove("cache/test_cache.json");
+        std::filesystem::remove("cache/test_cache.bin");
     }
 
     // Pointer to the cache object
@@ -25,7 +26,7 @@ protected:
 TEST_F(CacheTest, FileExist)
 {
     EXPECT_FALSE(cache->exist()); // Initially, the file should not exist
-    cache->add("key1", CachedData{.base_currency_conversion_rate = 1.0});
+    cache->add(1704067200, CachedData{.base_currency_conversion_rate = 1.0});
     cache->create();
     EXPECT_TRUE(cache->exist()); // After creating the cache, the file should exist
 }
@@ -33,30 +34,134 @@ TEST_F(CacheTest, FileExist)
 // Test case to add and retrieve data from cache
 TEST_F(CacheTest, AddAndGet)
 {
-    cache->add("key1", CachedData{.base_currency_conversion_rate = 1.0});
+    cache->add(1704067200, CachedData{.base_currency_conversion_rate = 1.0});
     cache->create();
-    Cache *loadedCache = Cache::load("cache/test_cache.json");
-    EXPECT_EQ(1.0, loadedCache->get("key1").base_currency_conversion_rate); // Check if the value retrieved is correct
+    Cache *loadedCache = Cache::load("cache/test_cache.bin");
+    EXPECT_EQ(1.0, loadedCache->get(1704067200).base_currency_conversion_rate); // Check if the value retrieved is correct
     delete loadedCache;
 }
 
 // Test case to check if exception is thrown for non-existing key
 TEST_F(CacheTest, KeyNotFound)
 {
-    cache->add("key1", CachedData{.base_currency_conversion_rate = 1.0});
+    cache->add(1704067200, CachedData{.base_currency_conversion_rate = 1.0});
     cache->create();
-    Cache *loadedCache = Cache::load("cache/test_cache.json");
-    EXPECT_THROW(loadedCache->get("non_existing_key"), std::runtime_error);
+    Cache *loadedCache = Cache::load("cache/test_cache.bin");
+    EXPECT_FALSE(loadedCache->has(1704070800));
+    EXPECT_THROW(loadedCache->get(1704070800), std::runtime_error);
+    delete loadedCache;
+}
+
+// Test case to check the time index of the cache
+TEST_F(CacheTest, TimeIndex)
+{
+    cache->add(1704070800, CachedData{.base_currency_conversion_rate = 2.0});
+    cache->add(1704067200, CachedData{.base_currency_conversion_rate = 1.0});
+    cache->create();
+    EXPECT_EQ(cache->size(), 2);
+    EXPECT_EQ(cache->find(1704067200), 0);
+    EXPECT_EQ(cache->find(1704070800), 1);
+
+    Cache *loadedCache = Cache::load("cache/test_cache.bin");
+    EXPECT_EQ(loadedCache->size(), 2);
+    EXPECT_EQ(loadedCache->find(1704074400), -1);
+    EXPECT_EQ(2.0, loadedCache->at(loadedCache->find(1704070800)).base_currency_conversion_rate);
+    EXPECT_EQ(&loadedCache->at(loadedCache->find(1704067200)), &loadedCache->get(1704067200)); // No copy of the data
     delete loadedCache;
 }
 
 // Test case to check if cache file is loaded correctly
 TEST_F(CacheTest, LoadFile)
 {
-    cache->add("key1", CachedData{.base_currency_conversion_rate = 1.0});
+    cache->add(1704067200, CachedData{.base_currency_conversion_rate = 1.0});
     cache->create();
-    Cache *loadedCache = Cache::load("cache/test_cache.json");
-    EXPECT_TRUE(loadedCache->exist());                                      // Check if the loaded cache file exists
-    EXPECT_EQ(1.0, loadedCache->get("key1").base_currency_conversion_rate); // Check if the value retrieved is correct
+    Cache *loadedCache = Cache::load("cache/test_cache.bin");
+    EXPECT_TRUE(loadedCache->exist());                                         // Check if the loaded cache file exists
+    EXPECT_EQ(1.0, loadedCache->get(1704067200).base_currency_conversion_rate); // Check if the value retrieved is correct
     delete loadedCache;
 }
+
+// Test case to check that the candles and indicators are loaded back identically
+TEST_F(CacheTest, CandlesAndIndicators)
+{
+    Candle candle_1 = {.date = 1704067200, .open = 1.1, .high = 1.2, .low = 1.0, .close = 1.15, .tick_volume = 10, .volume = 100, .spread = 2};
+    Candle candle_2 = {.date = 1704070800, .open = 1.15, .high = 1.25, .low = 1.1, .close = 1.2, .tick_volume = 20, .volume = 200, .spread = 3};
+
+    cache->candles = {{TimeFrame::H1, {candle_1, candle_2}}, {TimeFrame::D1, {candle_1}}};
+    cache->add(1704067200, CachedData{
+                               .candles = {{TimeFrame::H1, CandlesView(cache->candles[TimeFrame::H1], 0, 1)}},
+                               .indicators = {{TimeFrame::H1, {{"rsi", {0.1, 0.2}}, {"rsi-reverse", {0.9, 0.8}}}}},
+                               .base_currency_conversion_rate = 1.0,
+                           });
+    cache->add(1704070800, CachedData{
+                               .candles = {{TimeFrame::H1, CandlesView(cache->candles[TimeFrame::H1], 0, 2)}, {TimeFrame::D1, CandlesView(cache->candles[TimeFrame::D1], 0, 1)}},
+                               .indicators = {{TimeFrame::H1, {{"rsi", {0.3, 0.4}}, {"rsi-reverse", {0.7, 0.6}}}}},
+                               .base_currency_conversion_rate = 0.5,
+                           });
+    cache->create();
+
+    Cache *loadedCache = Cache::load("cache/test_cache.bin");
+    EXPECT_EQ(loadedCache->get_dates(), std::vector<time_t>({1704067200, 1704070800}));
+
+    CachedData data_1 = loadedCache->get(1704067200);
+    EXPECT_EQ(data_1.candles.size(), 1);
+    EXPECT_EQ(data_1.candles[TimeFrame::H1].size(), 1);
+    EXPECT_EQ(data_1.candles[TimeFrame::H1][0].close, 1.15);
+
+    CachedData data_2 = loadedCache->get(1704070800);
+    EXPECT_EQ(data_2.candles[TimeFrame::H1].size(), 2);
+    EXPECT_EQ(data_2.candles[TimeFrame::H1][1].date, 1704070800);
+    EXPECT_EQ(data_2.candles[TimeFrame::H1][1].open, 1.15);
+    EXPECT_EQ(data_2.candles[TimeFrame::H1][1].high, 1.25);
+    EXPECT_EQ(data_2.candles[TimeFrame::H1][1].low, 1.1);
+    EXPECT_EQ(data_2.candles[TimeFrame::H1][1].tick_volume, 20);
+    EXPECT_EQ(data_2.candles[TimeFrame::H1][1].volume, 200);
+    EXPECT_EQ(data_2.candles[TimeFrame::H1][1].spread, 3);
+    EXPECT_EQ(data_2.candles[TimeFrame::D1].size(), 1);
+    EXPECT_EQ(data_2.candles[TimeFrame::H1].timeline, data_1.candles[TimeFrame::H1].timeline); // Both windows are views of the same timeline
+    EXPECT_EQ(data_2.base_currency_conversion_rate, 0.5);
+
+    // The indicators are read in place, without copying them in the data of the dates
+    EXPECT_TRUE(data_2.indicators.empty());
+    std::vector<double> values(4);
+    loadedCache->get_last_indicators_values({{TimeFrame::H1, "rsi"}, {TimeFrame::H1, "rsi-reverse"}}, values.data());
+    EXPECT_EQ(values, std::vector<double>({0.2, 0.8, 0.4, 0.6}));
+    EXPECT_THROW(loadedCache->get_last_indicators_values({{TimeFrame::D1, "rsi"}}, values.data()), std::runtime_error);
+
+    // The values of the data added in memory are read the same way
+    cache->get_last_indicators_values({{TimeFrame::H1, "rsi"}, {TimeFrame::H1, "rsi-reverse"}}, values.data());
+    EXPECT_EQ(values, std::vector<double>({0.2, 0.8, 0.4, 0.6}));
+    delete loadedCache;
+}
+
+// Test case to check that the candles must be views of the timelines of the cache
+TEST_F(CacheTest, CandlesNotInTimelines)
+{
+    std::vector<Candle> candles = {{.date = 1704067200, .open = 1.1, .high = 1.2, .low = 1.0, .close = 1.15, .tick_volume = 10, .volume = 100, .spread = 2}};
+    cache->add(1704067200, CachedData{.candles = {{TimeFrame::H1, CandlesView(candles)}}, .base_currency_conversion_rate = 1.0});
+    EXPECT_THROW(cache->create(), std::runtime_error);
+}
+
+// Test case to check that the hash of the configuration is saved in the file
+TEST_F(CacheTest, ConfigHash)
+{
+    Cache *hashedCache = new Cache("cache/test_cache.bin", 123456789);
+    hashedCache->add(1704067200, CachedData{.base_currency_conversion_rate = 1.0});
+    hashedCache->create();
+    delete hashedCache;
+
+    Cache *loadedCache = Cache::load("cache/test_cache.bin");
+    EXPECT_EQ(loadedCache->config_hash, 123456789);
+    delete loadedCache;
+}
+
+// Test case to check that an invalid file is rejected
+TEST_F(CacheTest, InvalidFile)
+{
+    std::filesystem::create_directories("cache");
+    std::ofstream file("cache/test_cache.bin");
+    file << "{\"1704067200\": {\"base_currency_conversion_rate\": 1.0}}";
+    file.close();
+
+    EXPECT_THROW(Cache::load("cache/test_cache.bin"), std::runtime_error);
+}
@@ -0,0 +1,26 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "../hash.hpp"
+
+TEST(HashTest, HashString)
+{
+    // Reference values of the 64-bit FNV-1a hash
+    EXPECT_EQ(hash_string(""), 14695981039346656037ULL);
+    EXPECT_EQ(hash_string("a"), 12638187200555641996ULL);
+    EXPECT_EQ(hash_string("foobar"), 9625390261332436968ULL);
+
+    // The same value always gives the same hash
+    EXPECT_EQ(hash_string("EURUSD"), hash_string("EURUSD"));
+    EXPECT_NE(hash_string("EURUSD"), hash_string("GBPUSD"));
+}
+
+TEST(HashTest, HashCombine)
+{
+    uint64_t seed = hash_string("EURUSD");
+
+    EXPECT_EQ(hash_combine(seed, 1), hash_combine(seed, 1));
+    EXPECT_NE(hash_combine(seed, 1), hash_combine(seed, 2));
+
+    // The order of the combined values matters
+    EXPECT_NE(hash_combine(hash_combine(seed, 1), 2), hash_combine(hash_combine(seed, 2), 1));
+}
@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "../random.hpp"
+
+// Test case to check that the generators with the same seed draw the same values
+TEST(RandomTest, RandomGenerator)
+{
+    RandomGenerator generator1(42);
+    RandomGenerator generator2(42);
+    RandomGenerator generator3(43);
+    bool same_as_other_seed = true;
+    for (int i = 0; i < 100; ++i)
+    {
+        uint64_t value = generator1();
+        ASSERT_EQ(value, generator2());
+        same_as_other_seed = same_as_other_seed && value == generator3();
+
+        double random = generator1.next_double();
+        generator2.next_double();
+        ASSERT_GE(random, 0.0);
+        ASSERT_LT(random, 1.0);
+    }
+    ASSERT_FALSE(same_as_other_seed);
+}
+
+// Test case to check that the streams of a master seed are different
+TEST(RandomTest, DeriveSeed)
+{
+    ASSERT_EQ(derive_seed(42, 1), derive_seed(42, 1));
+    ASSERT_NE(derive_seed(42, 1), derive_seed(42, 2));
+    ASSERT_NE(derive_seed(42, 1), derive_seed(43, 1));
+}
@@ -31,12 +31,12 @@ TEST(ReadDataTest, ReadDataWithDateRange)
     time_t end_time = std::mktime(&end_date);
 
     // Test reading data for a valid symbol, time frame, and date range
-    std::vector<Candle> candles = read_data("EURUSD", TimeFrame::H1, start_time, end_time);
+    std::vector<Candle> candles = read_data("EURUSD", TimeFrame::H4, start_time, end_time);
 
     // Assert that the vector is not empty
     ASSERT_TRUE(candles.size() > 0);
 
-    int loop_timeframe_minutes = get_time_frame_in_minutes(TimeFrame::H1);
+    int loop_timeframe_minutes = get_time_frame_in_minutes(TimeFrame::H4);
     int candles_count = 0;
 
     // Loop through the candles and count the number of candles within the date range
@@ -57,3 +57,35 @@ TEST(ReadDataTest, ReadDataWithDateRange)
         ASSERT_TRUE(candles[i - 1].date < candles[i].date);
     }
 }
+
+// Test case for reading data from a start date in the middle of the file
+TEST(ReadDataTest, ReadDataFromStartDate)
+{
+    std::vector<Candle> all_candles = read_data("EURUSD", TimeFrame::H4);
+    ASSERT_TRUE(all_candles.size() > 2);
+
+    // Start on an existing candle and just after it
+    for (time_t offset : {0, 1})
+    {
+        time_t start_time = all_candles[all_candles.size() / 2].date + offset;
+        time_t end_time = all_candles[all_candles.size() / 2 + all_candles.size() / 4].date;
+        std::vector<Candle> candles = read_data("EURUSD", TimeFrame::H4, start_time, end_time);
+
+        std::vector<Candle> expected_candles;
+        for (const auto &candle : all_candles)
+        {
+            if (candle.date >= start_time && candle.date <= end_time)
+            {
+                expected_candles.push_back(candle);
+            }
+        }
+
+        ASSERT_EQ(candles.size(), expected_candles.size());
+        for (size_t i = 0; i < candles.size(); i++)
+        {
+            ASSERT_EQ(candles[i].date, expected_candles[i].date);
+            ASSERT_EQ(candles[i].open, expected_candles[i].open);
+            ASSERT_EQ(candles[i].close, expected_candles[i].close);
+        }
+    }
+}
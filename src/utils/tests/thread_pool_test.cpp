@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include "../thread_pool.hpp"
+
+// Test case to check the number of workers of the pool
+TEST(ThreadPoolTest, Size)
+{
+    ThreadPool pool(3);
+    EXPECT_EQ(pool.size(), 3);
+
+    ThreadPool default_pool;
+    EXPECT_GE(default_pool.size(), 1);
+}
+
+// Test case to check that the result of a task is returned by its future
+TEST(ThreadPoolTest, Submit)
+{
+    ThreadPool pool(2);
+    std::future<int> result = pool.submit([]()
+                                          { return 6 * 7; });
+    EXPECT_EQ(result.get(), 42);
+}
+
+// Test case to check that all the indexes are processed once
+TEST(ThreadPoolTest, ParallelFor)
+{
+    ThreadPool pool(4);
+    std::vector<int> values(1000, 0);
+    std::atomic<int> calls(0);
+
+    pool.parallel_for(values.size(), [&](size_t i)
+                      { values[i] = i * 2; calls++; });
+
+    EXPECT_EQ(calls, 1000);
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        EXPECT_EQ(values[i], i * 2);
+    }
+
+    // Each index is called once, whatever the size of the chunks
+    for (size_t chunk_size : {0, 1, 7, 1000})
+    {
+        std::vector<std::atomic<int>> index_calls(1000);
+        pool.parallel_for(index_calls.size(), [&](size_t i)
+                          { index_calls[i]++; }, chunk_size);
+
+        for (const auto &c : index_calls)
+        {
+            EXPECT_EQ(c, 1);
+        }
+    }
+
+    // Nothing to do for an empty loop
+    pool.parallel_for(0, [&](size_t i)
+                      { FAIL(); });
+}
+
+// Test case to check that the index of the worker is given by its own pool
+TEST(ThreadPoolTest, CurrentWorker)
+{
+    ThreadPool pool(2);
+    ThreadPool other_pool(3);
+    EXPECT_EQ(pool.current_worker(), -1);
+
+    std::vector<int> workers(100, -1);
+    std::vector<int> other_workers(100, 0);
+    pool.parallel_for(workers.size(), [&](size_t i)
+                      { workers[i] = pool.current_worker(); other_workers[i] = other_pool.current_worker(); });
+
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        EXPECT_GE(workers[i], 0);
+        EXPECT_LT(workers[i], 2);
+        EXPECT_EQ(other_workers[i], -1);
+    }
+}
+
+// Test case to check that the exception of a task is rethrown once all the calls are done
+TEST(ThreadPoolTest, Exception)
+{
+    ThreadPool pool(2);
+    EXPECT_THROW(pool.parallel_for(10, [](size_t i)
+                                   { if (i == 5) throw std::runtime_error("Error"); }),
+                 std::runtime_error);
+
+    std::atomic<int> calls(0);
+    EXPECT_THROW(pool.parallel_for(10, [&](size_t i)
+                                   { calls++; if (i == 5) throw std::runtime_error("Error"); }, 1),
+                 std::runtime_error);
+    EXPECT_EQ(calls, 10);
+}
@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "thread_pool.hpp"
+
+// Pool and index of the worker running the current thread, nullptr and -1 outside of the workers
+static thread_local const ThreadPool *current_pool = nullptr;
+static thread_local int current_worker_index = -1;
+
+/**
+ * @brief Constructs a thread pool and starts its workers.
+ * @param nb_threads The number of worker threads. Default is 0, to use one thread per hardware thread.
+ */
+ThreadPool::ThreadPool(size_t nb_threads) : stopping(false)
+{
+    if (nb_threads == 0)
+    {
+        nb_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (size_t i = 0; i < nb_threads; i++)
+    {
+        this->workers.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+/**
+ * @brief Destructor of the thread pool, it waits for the queued tasks and stops the workers.
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->condition.notify_all();
+
+    for (auto &worker : this->workers)
+    {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Get the number of worker threads of the pool.
+ * @return size_t The number of worker threads.
+ */
+size_t ThreadPool::size() const
+{
+    return this->workers.size();
+}
+
+/**
+ * @brief Get the index of the worker of this pool running the calling thread.
+ * @return int The index of the worker, -1 if the calling thread is not a worker of this pool.
+ */
+int ThreadPool::current_worker() const
+{
+    return current_pool == this ? current_worker_index : -1;
+}
+
+/**
+ * @brief Execute a function for all the indexes in [0, count) on the pool and wait for the end of all the calls.
+ * It must not be called from a worker of the same pool.
+ * @param count The number of calls.
+ * @param function The function to call with each index.
+ * @param chunk_size The number of indexes a worker takes at once. Default is 0, to split the indexes in 8 chunks per worker.
+ * @throws The first exception thrown by a call, once all the calls are done.
+ */
+void ThreadPool::parallel_for(size_t count, std::function<void(size_t)> function, size_t chunk_size)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    // Give an equal share of the indexes to each worker of the loop
+    size_t nb_workers = std::min(this->workers.size(), count);
+    std::vector<std::unique_ptr<Range>> ranges;
+    for (size_t i = 0; i < nb_workers; i++)
+    {
+        ranges.push_back(std::make_unique<Range>());
+        ranges[i]->begin = i * count / nb_workers;
+        ranges[i]->end = (i + 1) * count / nb_workers;
+    }
+    if (chunk_size == 0)
+    {
+        chunk_size = std::max<size_t>(1, count / (8 * nb_workers));
+    }
+
+    // Run the chunks of the loop on each worker until all the indexes are taken
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    std::vector<std::future<void>> results;
+    for (size_t w = 0; w < nb_workers; w++)
+    {
+        results.push_back(this->submit([&, w]()
+                                       {
+                                           size_t begin, end;
+                                           while (take(ranges, w, chunk_size, begin, end))
+                                           {
+                                               try
+                                               {
+                                                   for (size_t i = begin; i < end; i++)
+                                                   {
+                                                       function(i);
+                                                   }
+                                               }
+                                               catch (...)
+                                               {
+                                                   std::lock_guard<std::mutex> lock(error_mutex);
+                                                   if (!error)
+                                                   {
+                                                       error = std::current_exception();
+                                                   }
+                                               }
+                                           } }));
+    }
+
+    // Wait for all the workers before rethrowing, the function and the ranges are shared by the workers
+    for (auto &result : results)
+    {
+        result.wait();
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * @brief Loop of a worker thread, executing the tasks of the queue until the pool is stopped.
+ * @param worker The index of the worker.
+ */
+void ThreadPool::work(size_t worker)
+{
+    current_pool = this;
+    current_worker_index = static_cast<int>(worker);
+
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->condition.wait(lock, [this]()
+                                 { return this->stopping || !this->tasks.empty(); });
+            if (this->stopping && this->tasks.empty())
+            {
+                return;
+            }
+            task = std::move(this->tasks.front());
+            this->tasks.pop();
+        }
+
+        task();
+    }
+}
+
+/**
+ * @brief Take the next chunk of the indexes of a worker, or steal from the other workers when it has no more indexes.
+ * @param ranges The indexes left to each worker of the loop.
+ * @param worker The index of the worker in the loop.
+ * @param chunk_size The number of indexes taken at once.
+ * @param begin First index of the chunk.
+ * @param end End of the indexes of the chunk.
+ * @return bool True if a chunk was taken, false if all the indexes of the loop are taken.
+ */
+bool ThreadPool::take(std::vector<std::unique_ptr<Range>> &ranges, size_t worker, size_t chunk_size, size_t &begin, size_t &end)
+{
+    while (true)
+    {
+        // Take the next chunk of the own indexes of the worker
+        {
+            Range &range = *ranges[worker];
+            std::lock_guard<std::mutex> lock(range.mutex);
+            if (range.begin < range.end)
+            {
+                begin = range.begin;
+                end = std::min(range.end, range.begin + chunk_size);
+                range.begin = end;
+                return true;
+            }
+        }
+
+        // Find the worker with the most indexes left
+        size_t victim = worker;
+        size_t victim_size = 0;
+        for (size_t i = 0; i < ranges.size(); i++)
+        {
+            Range &range = *ranges[i];
+            std::lock_guard<std::mutex> lock(range.mutex);
+            if (range.end - range.begin > victim_size)
+            {
+                victim = i;
+                victim_size = range.end - range.begin;
+            }
+        }
+        if (victim_size == 0)
+        {
+            return false;
+        }
+
+        // Steal the second half of its indexes, or its last chunk
+        size_t steal_begin, steal_end;
+        {
+            Range &range = *ranges[victim];
+            std::lock_guard<std::mutex> lock(range.mutex);
+            if (range.begin >= range.end)
+            {
+                continue; // Taken in the meantime, look for another worker
+            }
+            steal_end = range.end;
+            steal_begin = range.end - range.begin > chunk_size ? range.begin + (range.end - range.begin) / 2 : range.begin;
+            range.end = steal_begin;
+        }
+        {
+            Range &range = *ranges[worker];
+            std::lock_guard<std::mutex> lock(range.mutex);
+            range.begin = steal_begin;
+            range.end = steal_end;
+        }
+    }
+}
@@ -0,0 +1,114 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief A pool of a bounded number of persistent worker threads executing tasks from a shared queue.
+ *
+ * The loops over ranges of indexes are split between the workers with work stealing: each worker
+ * starts with its own share of the indexes and takes them chunk by chunk, a worker with no more
+ * indexes steals the second half of the largest remaining share of the other workers.
+ *
+ * The tasks must not wait for other tasks of the same pool, otherwise all the workers can be blocked.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief Constructs a thread pool and starts its workers.
+     * @param nb_threads The number of worker threads. Default is 0, to use one thread per hardware thread.
+     */
+    ThreadPool(size_t nb_threads = 0);
+
+    /**
+     * @brief Destructor of the thread pool, it waits for the queued tasks and stops the workers.
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Get the number of worker threads of the pool.
+     * @return size_t The number of worker threads.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the index of the worker of this pool running the calling thread.
+     * @return int The index of the worker, -1 if the calling thread is not a worker of this pool.
+     */
+    int current_worker() const;
+
+    /**
+     * @brief Add a task to the queue of the pool.
+     * @param task The function to execute.
+     * @return std::future The future of the result of the task, it rethrows the exception thrown by the task.
+     */
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(F task)
+    {
+        auto packaged_task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::move(task));
+        std::future<std::invoke_result_t<F>> result = packaged_task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->tasks.emplace([packaged_task]()
+                                { (*packaged_task)(); });
+        }
+        this->condition.notify_one();
+        return result;
+    }
+
+    /**
+     * @brief Execute a function for all the indexes in [0, count) on the pool and wait for the end of all the calls.
+     * It must not be called from a worker of the same pool.
+     * @param count The number of calls.
+     * @param function The function to call with each index.
+     * @param chunk_size The number of indexes a worker takes at once. Default is 0, to split the indexes in 8 chunks per worker.
+     * @throws The first exception thrown by a call, once all the calls are done.
+     */
+    void parallel_for(size_t count, std::function<void(size_t)> function, size_t chunk_size = 0);
+
+private:
+    /**
+     * @brief Share of the indexes of a loop left to a worker.
+     */
+    struct Range
+    {
+        std::mutex mutex; // Mutex protecting the bounds of the range.
+        size_t begin;     // First index left.
+        size_t end;       // End of the indexes left.
+    };
+
+    std::vector<std::thread> workers;        // The worker threads.
+    std::queue<std::function<void()>> tasks; // The tasks waiting for a worker.
+    std::mutex mutex;                        // Mutex protecting the queue of tasks.
+    std::condition_variable condition;       // Condition to wake up the workers when a task is added.
+    bool stopping;                           // Flag to stop the workers once the queue is empty.
+
+    /**
+     * @brief Loop of a worker thread, executing the tasks of the queue until the pool is stopped.
+     * @param worker The index of the worker.
+     */
+    void work(size_t worker);
+
+    /**
+     * @brief Take the next chunk of the indexes of a worker, or steal from the other workers when it has no more indexes.
+     * @param ranges The indexes left to each worker of the loop.
+     * @param worker The index of the worker in the loop.
+     * @param chunk_size The number of indexes taken at once.
+     * @param begin First index of the chunk.
+     * @param end End of the indexes of the chunk.
+     * @return bool True if a chunk was taken, false if all the indexes of the loop are taken.
+     */
+    static bool take(std::vector<std::unique_ptr<Range>> &ranges, size_t worker, size_t chunk_size, size_t &begin, size_t &end);
+};
+
+#endif // THREAD_POOL_HPP